@@ -227,8 +227,8 @@ DiscoverObject::DiscoverObject(const QVariantMap &initialProperties)
         },
         this);
 
-    if (ResourcesModel::global()->backends().isEmpty()) {
-        connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, action, &OneTimeAction::trigger);
+    if (ResourcesModel::global()->isInitializing()) {
+        connect(ResourcesModel::global(), &ResourcesModel::isInitializingChanged, action, &OneTimeAction::trigger);
     } else {
         action->trigger();
     }
@@ -358,8 +358,8 @@ void DiscoverObject::openLocalPackage(const QUrl &localfile)
         },
         this);
 
-    if (ResourcesModel::global()->backends().isEmpty()) {
-        connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, action, &OneTimeAction::trigger);
+    if (ResourcesModel::global()->isInitializing()) {
+        connect(ResourcesModel::global(), &ResourcesModel::isInitializingChanged, action, &OneTimeAction::trigger);
     } else {
         action->trigger();
     }
@@ -433,8 +433,8 @@ void DiscoverObject::openApplication(const QUrl &url)
         },
         this);
 
-    if (ResourcesModel::global()->backends().isEmpty()) {
-        connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, action, &OneTimeAction::trigger);
+    if (ResourcesModel::global()->isInitializing()) {
+        connect(ResourcesModel::global(), &ResourcesModel::isInitializingChanged, action, &OneTimeAction::trigger);
     } else {
         action->trigger();
     }
@@ -173,6 +173,7 @@ int main(int argc, char **argv)
         {
             auto options = parser->optionNames();
             options.removeAll(QStringLiteral("backends"));
+            options.removeAll(QStringLiteral("startup-timeline"));
             options.removeAll(QStringLiteral("test"));
             QVariantMap initialProperties;
             if (!options.isEmpty() || !parser->positionalArguments().isEmpty())
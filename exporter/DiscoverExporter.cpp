@@ -23,7 +23,7 @@ DiscoverExporter::DiscoverExporter()
     : QObject(nullptr)
     , m_excludedProperties({"executables", "canExecute"})
 {
-    connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, this, &DiscoverExporter::fetchResources);
+    connect(ResourcesModel::global(), &ResourcesModel::isInitializingChanged, this, &DiscoverExporter::fetchResources);
 }
 
 DiscoverExporter::~DiscoverExporter() = default;
@@ -16,8 +16,15 @@
 #include <QCommandLineParser>
 #include <QDir>
 #include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPluginLoader>
+#include <QPointer>
 #include <QStandardPaths>
+#include <QThreadPool>
 #include <chrono>
 
 using namespace Qt::StringLiterals;
@@ -25,6 +32,112 @@ using namespace Qt::StringLiterals;
 Q_GLOBAL_STATIC(QStringList, s_requestedBackends)
 static bool s_isFeedback = false;
 
+namespace
+{
+/**
+ * When every plugin was loaded and created, and when its backends were
+ * first done fetching, in ms since the plugins started loading.
+ *
+ * It's written to the file passed with --startup-timeline once every backend
+ * is ready, or when quitting before that.
+ */
+class StartupTimeline
+{
+public:
+    struct Backend {
+        QString name;
+        qint64 ready = -1;
+    };
+    struct Plugin {
+        QString name;
+        qint64 loadStarted = -1;
+        qint64 loaded = -1;
+        qint64 created = -1;
+        QVector<Backend> backends;
+    };
+
+    QString path;
+    QElapsedTimer clock;
+    QVector<Plugin> plugins;
+    bool written = false;
+
+    void watch(qsizetype plugin, const QVector<AbstractResourcesBackend *> &backends)
+    {
+        for (auto backend : backends) {
+            auto &entries = plugins[plugin].backends;
+            const qsizetype index = entries.size();
+            entries.append({backend->name()});
+            const auto checkReady = [this, plugin, index, backend] {
+                auto &entry = plugins[plugin].backends[index];
+                if (entry.ready < 0 && (backend->fetchingUpdatesProgress() >= 100 || !backend->isValid())) {
+                    entry.ready = clock.elapsed();
+                    writeIfReady();
+                }
+            };
+            QObject::connect(backend, &AbstractResourcesBackend::fetchingUpdatesProgressChanged, backend, checkReady);
+            QObject::connect(backend, &AbstractResourcesBackend::invalidated, backend, checkReady);
+            QObject::connect(backend, &QObject::destroyed, QCoreApplication::instance(), [this, plugin, index] {
+                auto &entry = plugins[plugin].backends[index];
+                if (entry.ready < 0) {
+                    entry.ready = clock.elapsed();
+                    writeIfReady();
+                }
+            });
+            checkReady();
+        }
+    }
+
+    void writeIfReady()
+    {
+        for (const auto &plugin : std::as_const(plugins)) {
+            for (const auto &backend : plugin.backends) {
+                if (backend.ready < 0) {
+                    return;
+                }
+            }
+        }
+        write();
+    }
+
+    void write()
+    {
+        if (path.isEmpty() || written || plugins.isEmpty()) {
+            return;
+        }
+        written = true;
+
+        QJsonArray array;
+        for (const auto &plugin : std::as_const(plugins)) {
+            QJsonArray backends;
+            for (const auto &backend : plugin.backends) {
+                backends.append(QJsonObject{{u"name"_s, backend.name}, {u"ready"_s, backend.ready}});
+            }
+            array.append(QJsonObject{
+                {u"plugin"_s, plugin.name},
+                {u"loadStarted"_s, plugin.loadStarted},
+                {u"loaded"_s, plugin.loaded},
+                {u"created"_s, plugin.created},
+                {u"backends"_s, backends},
+            });
+        }
+        const QByteArray json = QJsonDocument(array).toJson();
+
+        QFile file;
+        bool opened;
+        if (path == "-"_L1) {
+            opened = file.open(stderr, QIODevice::WriteOnly);
+        } else {
+            file.setFileName(path);
+            opened = file.open(QIODevice::WriteOnly);
+        }
+        if (!opened || file.write(json) != json.size()) {
+            qCWarning(LIBDISCOVER_LOG) << "Could not write the startup timeline to" << path << file.errorString();
+        }
+    }
+};
+}
+Q_GLOBAL_STATIC(StartupTimeline, s_timeline)
+
 void DiscoverBackendsFactory::setRequestedBackends(const QStringList &backends)
 {
     *s_requestedBackends = backends;
@@ -51,13 +164,29 @@ QVector<AbstractResourcesBackend *> DiscoverBackendsFactory::backend(const QStri
 QVector<AbstractResourcesBackend *> DiscoverBackendsFactory::backendForFile(const QString &libname, const QString &name) const
 {
     QPluginLoader *loader = new QPluginLoader(QLatin1String("discover/") + libname, QCoreApplication::instance());
+    if (!loadPlugin(loader, libname)) {
+        return {};
+    }
+    return createBackends(loader, libname, name);
+}
 
+bool DiscoverBackendsFactory::loadPlugin(QPluginLoader *loader, const QString &libname)
+{
     if (const auto iid = loader->metaData().value("IID"_L1).toString(); iid != QLatin1StringView(DISCOVER_PLUGIN_IID)) {
         qCWarning(LIBDISCOVER_LOG) << "Plugin" << libname << "doesn't have the right IID" << iid << "expected" << DISCOVER_PLUGIN_IID;
-        return {};
+        return false;
     }
 
     // qCDebug(LIBDISCOVER_LOG) << "trying to load plugin:" << loader->fileName();
+    if (!loader->load()) {
+        qCWarning(LIBDISCOVER_LOG) << "error loading" << libname << loader->errorString() << loader->metaData();
+        return false;
+    }
+    return true;
+}
+
+QVector<AbstractResourcesBackend *> DiscoverBackendsFactory::createBackends(QPluginLoader *loader, const QString &libname, const QString &name) const
+{
     AbstractResourcesBackendFactory *f = qobject_cast<AbstractResourcesBackendFactory *>(loader->instance());
     if (!f) {
         qCWarning(LIBDISCOVER_LOG) << "error loading" << libname << loader->errorString() << loader->metaData();
@@ -103,18 +232,94 @@ QStringList DiscoverBackendsFactory::allBackendNames(bool whitelist, bool allowS
     return pluginNames;
 }
 
-QVector<AbstractResourcesBackend *> DiscoverBackendsFactory::allBackends() const
+void DiscoverBackendsFactory::loadAllBackends(QObject *context, const BackendsCallback &created, const std::function<void()> &finished) const
 {
-    QStringList names = allBackendNames();
-    auto ret = kTransform<QVector<AbstractResourcesBackend *>>(names, [this](const QString &name) {
-        return backend(name);
-    });
-    ret.removeAll(nullptr);
+    const QStringList names = allBackendNames();
+    if (!s_timeline->clock.isValid()) {
+        s_timeline->clock.start();
+    }
 
-    if (ret.isEmpty()) {
-        qCWarning(LIBDISCOVER_LOG) << "Didn't find any Discover backend!";
+    // Only opening the libraries, which runs their static initialisation, happens on other threads.
+    // The plugins' instances and backends are QObjects living on this thread, so they are created
+    // here from the event loop, one plugin after the other in the order of names, as soon as the
+    // plugin and the ones before it are loaded.
+    struct Loading {
+        QString name;
+        QPluginLoader *loader;
+        qint64 started = -1;
+        qint64 finished = -1;
+        bool loaded = false;
+        bool done = false;
+    };
+    struct State {
+        QPointer<QObject> context;
+        BackendsCallback created;
+        std::function<void()> finished;
+        QVector<Loading> plugins;
+        qsizetype next = 0;
+        qsizetype backendsCount = 0;
+    };
+    auto state = std::make_shared<State>();
+    state->context = context;
+    state->created = created;
+    state->finished = finished;
+    state->plugins.reserve(names.size());
+    for (const QString &name : names) {
+        state->plugins.append({name, new QPluginLoader(QLatin1String("discover/") + name, QCoreApplication::instance())});
+    }
+
+    const auto createLoaded = [state] {
+        while (state->next < state->plugins.size() && state->plugins[state->next].done) {
+            const auto &plugin = state->plugins[state->next++];
+            const auto backends =
+                plugin.loaded ? DiscoverBackendsFactory().createBackends(plugin.loader, plugin.name, plugin.name) : QVector<AbstractResourcesBackend *>{};
+            s_timeline->plugins.append({plugin.name, plugin.started, plugin.finished, s_timeline->clock.elapsed()});
+            qCDebug(LIBDISCOVER_LOG) << "Plugin" << plugin.name << "loaded in" << plugin.finished - plugin.started << "ms, created"
+                                     << s_timeline->plugins.constLast().created - plugin.finished << "ms later";
+            if (backends.isEmpty()) {
+                continue;
+            }
+
+            s_timeline->watch(s_timeline->plugins.size() - 1, backends);
+            state->backendsCount += backends.size();
+            if (state->context && state->created) {
+                state->created(backends);
+            }
+        }
+
+        if (state->next < state->plugins.size()) {
+            return;
+        }
+        if (state->backendsCount == 0) {
+            qCWarning(LIBDISCOVER_LOG) << "Didn't find any Discover backend!";
+        }
+        s_timeline->writeIfReady();
+        if (state->context && state->finished) {
+            state->finished();
+        }
+    };
+
+    if (names.isEmpty()) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), createLoaded, Qt::QueuedConnection);
+        return;
+    }
+
+    for (qsizetype i = 0; i < state->plugins.size(); ++i) {
+        QThreadPool::globalInstance()->start([state, createLoaded, i] {
+            auto &plugin = state->plugins[i];
+            plugin.started = s_timeline->clock.elapsed();
+            plugin.loaded = loadPlugin(plugin.loader, plugin.name);
+            plugin.finished = s_timeline->clock.elapsed();
+
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [state, createLoaded, i] {
+                    state->plugins[i].done = true;
+                    createLoaded();
+                },
+                Qt::QueuedConnection);
+        });
     }
-    return ret;
 }
 
 int DiscoverBackendsFactory::backendsCount() const
@@ -127,10 +332,20 @@ void DiscoverBackendsFactory::setupCommandLine(QCommandLineParser *parser)
     parser->addOption(QCommandLineOption(QStringLiteral("backends"),
                                          i18n("List all the backends we’ll want to have loaded, separated by comma “,”."),
                                          QStringLiteral("names")));
+    parser->addOption(QCommandLineOption(QStringLiteral("startup-timeline"),
+                                         i18n("Write when every backend was loaded, created and ready to the file, as JSON. Use “-” for the standard error."),
+                                         QStringLiteral("file")));
 }
 
 void DiscoverBackendsFactory::processCommandLine(QCommandLineParser *parser, bool test)
 {
+    if (parser->isSet(QStringLiteral("startup-timeline"))) {
+        s_timeline->path = parser->value(QStringLiteral("startup-timeline"));
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [] {
+            s_timeline->write();
+        });
+    }
+
     if (parser->isSet(QStringLiteral("feedback"))) {
         s_isFeedback = true;
         s_requestedBackends->clear();
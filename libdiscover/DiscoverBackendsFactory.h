@@ -9,7 +9,10 @@
 #include "discovercommon_export.h"
 #include <QList>
 #include <QStringList>
+#include <functional>
 class QCommandLineParser;
+class QObject;
+class QPluginLoader;
 class AbstractResourcesBackend;
 
 class DISCOVERCOMMON_EXPORT DiscoverBackendsFactory
@@ -18,7 +21,20 @@ public:
     DiscoverBackendsFactory();
 
     QVector<AbstractResourcesBackend *> backend(const QString &name) const;
-    QVector<AbstractResourcesBackend *> allBackends() const;
+    using BackendsCallback = std::function<void(const QVector<AbstractResourcesBackend *> &)>;
+
+    /**
+     * Loads the plugins several at a time and creates their backends as they are loaded.
+     * Returns right away, everything else happens from the event loop.
+     *
+     * Only loading the libraries, including their static initialisation, is done in
+     * parallel on other threads. The backends are created on the calling thread, one
+     * plugin at a time and in the order of allBackendNames().
+     *
+     * @p created gets the backends of every plugin as soon as they are created, and
+     * @p finished is called once all of them are. Neither is called once @p context is gone.
+     */
+    void loadAllBackends(QObject *context, const BackendsCallback &created, const std::function<void()> &finished) const;
     QStringList allBackendNames(bool whitelist = true, bool allowSpecialBackends = false) const;
     int backendsCount() const;
 
@@ -29,4 +45,7 @@ public:
 
 private:
     QVector<AbstractResourcesBackend *> backendForFile(const QString &path, const QString &name) const;
+    /// Can be called from any thread
+    static bool loadPlugin(QPluginLoader *loader, const QString &libname);
+    QVector<AbstractResourcesBackend *> createBackends(QPluginLoader *loader, const QString &libname, const QString &name) const;
 };
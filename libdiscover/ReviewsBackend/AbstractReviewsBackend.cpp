@@ -15,6 +15,22 @@ AbstractReviewsBackend::AbstractReviewsBackend(QObject *parent)
 {
 }
 
+qsizetype AbstractReviewsBackend::ratingIndex(AbstractResource *resource) const
+{
+    Rating rating = ratingForApplication(resource);
+    if (rating.ratingCount() == 0 && rating.packageName().isEmpty()) {
+        return -1;
+    }
+    m_ratings.append(std::move(rating));
+    return m_ratings.size() - 1;
+}
+
+void AbstractReviewsBackend::invalidateRatings()
+{
+    m_ratings.clear();
+    ++m_ratingsGeneration;
+}
+
 bool AbstractReviewsBackend::isReviewable() const
 {
     return true;
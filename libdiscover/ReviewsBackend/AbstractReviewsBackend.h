@@ -7,6 +7,7 @@
 #pragma once
 
 #include <QObject>
+#include <QVector>
 
 #include "Rating.h"
 #include "Review.h"
@@ -42,6 +43,30 @@ public:
     virtual bool isReviewable() const;
     virtual bool supportsNameChange() const;
 
+    /**
+     * @returns the slot of @p resource in the ratings table, -1 if it has no rating
+     *
+     * Resources look their slot up once and then read their rating with ratingAt(),
+     * without going through ratingForApplication() again, until ratingsGeneration()
+     * changes.
+     */
+    qsizetype ratingIndex(AbstractResource *resource) const;
+
+    /// @returns the rating in slot @p index, as given by ratingIndex()
+    const Rating &ratingAt(qsizetype index) const
+    {
+        return m_ratings.at(index);
+    }
+
+    /// Slots given by ratingIndex() are only valid while this doesn't change
+    quint64 ratingsGeneration() const
+    {
+        return m_ratingsGeneration;
+    }
+
+    /// Empties the ratings table so that every resource looks its rating up again, to be called when ratings change
+    void invalidateRatings();
+
 public Q_SLOTS:
     virtual void login() = 0;
     virtual void registerAndLogin() = 0;
@@ -69,4 +94,8 @@ protected:
     virtual ReviewsJob *
     sendReview(AbstractResource *resource, const QString &summary, const QString &reviewText, const QString &rating, const QString &userName) = 0;
     virtual QString userName() const = 0;
+
+private:
+    mutable QVector<Rating> m_ratings;
+    quint64 m_ratingsGeneration = 1;
 };
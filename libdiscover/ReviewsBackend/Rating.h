@@ -8,6 +8,7 @@
 
 #include <QObject>
 #include <QVariant>
+#include <array>
 
 #include "discovercommon_export.h"
 
@@ -35,14 +36,14 @@ public:
     // Returns a dampened rating calculated with the Wilson Score Interval algorithm
     double sortableRating() const;
 
-    // Returns std::vector<int> where:
+    // Returns the star counts where:
     // - m_starCounts[0] returns total count for "star0" ratings
     // - m_starCounts[1] returns total count for "star1" ratings
     // - And so on.
     // The range of ratings is 0 to 5.
     // "star0" ratings seem to be completely unused (one can inspect the ratings file)
     // and can be ignored.
-    const std::vector<int> &starCounts() const;
+    std::vector<int> starCounts() const;
 
 private:
     QString m_packageName;
@@ -50,5 +51,6 @@ private:
     float m_rating = 0;
     int m_ratingPoints = 0;
     double m_sortableRating = 0;
-    std::vector<int> m_starCounts;
+    // Not a container so that copying a Rating doesn't allocate
+    std::array<int, 6> m_starCounts = {};
 };
@@ -10,97 +10,201 @@
 #include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
+#include <utility>
+
 using namespace AppStream;
 
+namespace
+{
+// Takes the pool lock as a reader or as a writer depending on the locking mode
+class PoolLocker
+{
+public:
+    PoolLocker(QReadWriteLock *lock, ConcurrentPool::LockingMode mode)
+        : m_lock(lock)
+    {
+        if (mode == ConcurrentPool::LockingMode::ConcurrentReads) {
+            m_lock->lockForRead();
+        } else {
+            m_lock->lockForWrite();
+        }
+    }
+
+    ~PoolLocker()
+    {
+        m_lock->unlock();
+    }
+
+    Q_DISABLE_COPY_MOVE(PoolLocker)
+
+private:
+    QReadWriteLock *const m_lock;
+};
+}
+
+ConcurrentPool::State::State(AppStream::Pool *pool)
+    // The last query to use it may be on another thread, it's deleted back in ours
+    : pool(pool, [](AppStream::Pool *pool) {
+        pool->deleteLater();
+    })
+{
+}
+
+ConcurrentPool::ConcurrentPool(LockingMode mode)
+    : m_lockingMode(mode)
+{
+}
+
 void ConcurrentPool::reset(AppStream::Pool *pool, QThreadPool *threadPool)
 {
-    m_pool.reset(pool);
+    auto state = std::make_shared<State>(pool);
     connect(pool, &Pool::loadFinished, this, &ConcurrentPool::loadFinished);
 
+    std::shared_ptr<State> previous;
+    {
+        QMutexLocker lock(&m_stateMutex);
+        previous = std::exchange(m_state, state);
+    }
+    if (previous && previous->pool) {
+        disconnect(previous->pool.get(), nullptr, this, nullptr);
+    }
+
     m_threadPool = threadPool;
 }
 
+std::shared_ptr<ConcurrentPool::State> ConcurrentPool::state() const
+{
+    QMutexLocker lock(&m_stateMutex);
+    return m_state;
+}
+
+AppStream::Pool *ConcurrentPool::get() const
+{
+    const auto current = state();
+    return current ? current->pool.get() : nullptr;
+}
+
+void ConcurrentPool::setLockingMode(LockingMode mode)
+{
+    m_lockingMode = mode;
+}
+
 void ConcurrentPool::loadAsync()
 {
-    QMutexLocker lock(&m_mutex);
-    return m_pool->loadAsync();
+    const auto current = state();
+    QWriteLocker lock(&current->lock);
+    return current->pool->loadAsync();
 }
 
 QString ConcurrentPool::lastError()
 {
-    QMutexLocker lock(&m_mutex);
-    return m_pool->lastError();
+    const auto current = state();
+    PoolLocker lock(&current->lock, m_lockingMode);
+    return current->pool->lastError();
 }
 
-QFuture<ComponentBox> ConcurrentPool::search(const QString &term)
+template<typename Query>
+QFuture<ComponentBox> ConcurrentPool::runQuery(Query query)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, term] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->search(term);
+    // The query stays on the pool it was issued for, even if it's swapped out meanwhile
+    return QtConcurrent::run(m_threadPool.get(), [current = state(), query, mode = m_lockingMode.load()] {
+        PoolLocker lock(&current->lock, mode);
+        return query(current->pool.get());
     });
 }
 
+QFuture<ComponentBox> ConcurrentPool::search(const QString &term, QObject *requester)
+{
+    if (!requester) {
+        return runQuery([term](Pool *pool) {
+            return pool->search(term);
+        });
+    }
+
+    m_pendingSearches.removeIf([](const std::pair<const QString &, PendingSearch &> &pending) {
+        return pending.second.future.isFinished();
+    });
+
+    auto it = m_pendingSearches.find(term);
+    if (it == m_pendingSearches.end()) {
+        it = m_pendingSearches.insert(term,
+                                      {runQuery([term](Pool *pool) {
+                                           return pool->search(term);
+                                       }),
+                                       {}});
+    }
+    it->requesters.insert(requester);
+    connect(requester, &QObject::destroyed, this, &ConcurrentPool::requesterDestroyed, Qt::UniqueConnection);
+    return it->future;
+}
+
+void ConcurrentPool::requesterDestroyed(QObject *requester)
+{
+    for (auto it = m_pendingSearches.begin(); it != m_pendingSearches.end();) {
+        it->requesters.remove(requester);
+        if (it->requesters.isEmpty() || it->future.isFinished()) {
+            // Only prevents it from starting, a search that is running will be waited for
+            it->future.cancel();
+            it = m_pendingSearches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 QFuture<ComponentBox> ConcurrentPool::components()
 {
-    return QtConcurrent::run(m_threadPool.get(), [this] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->components();
+    return runQuery([](Pool *pool) {
+        return pool->components();
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsById(const QString &cid)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, cid] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsById(cid);
+    return runQuery([cid](Pool *pool) {
+        return pool->componentsById(cid);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByProvided(Provided::Kind kind, const QString &item)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, kind, item] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByProvided(kind, item);
+    return runQuery([kind, item](Pool *pool) {
+        return pool->componentsByProvided(kind, item);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByKind(Component::Kind kind)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, kind] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByKind(kind);
+    return runQuery([kind](Pool *pool) {
+        return pool->componentsByKind(kind);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByCategories(const QStringList &categories)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, categories] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByCategories(categories);
+    return runQuery([categories](Pool *pool) {
+        return pool->componentsByCategories(categories);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByLaunchable(Launchable::Kind kind, const QString &value)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, kind, value] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByLaunchable(kind, value);
+    return runQuery([kind, value](Pool *pool) {
+        return pool->componentsByLaunchable(kind, value);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByExtends(const QString &extendedId)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, extendedId] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByExtends(extendedId);
+    return runQuery([extendedId](Pool *pool) {
+        return pool->componentsByExtends(extendedId);
     });
 }
 
 QFuture<ComponentBox> ConcurrentPool::componentsByBundleId(Bundle::Kind kind, const QString &bundleId, bool matchPrefix)
 {
-    return QtConcurrent::run(m_threadPool.get(), [this, kind, bundleId, matchPrefix] {
-        QMutexLocker lock(&m_mutex);
-        return m_pool->componentsByBundleId(kind, bundleId, matchPrefix);
+    return runQuery([kind, bundleId, matchPrefix](Pool *pool) {
+        return pool->componentsByBundleId(kind, bundleId, matchPrefix);
     });
 }
 
@@ -114,15 +218,16 @@ ConcurrentPool::componentsByNames(QThreadPool *threadPool, const QList<Concurren
             if (!pool) {
                 return {};
             }
-            QMutexLocker lock(&pool->m_mutex);
+            const auto current = pool->state();
+            PoolLocker lock(&current->lock, pool->m_lockingMode);
             QList<Component> ret;
             for (const QString &name : names) {
-                ComponentBox components = pool->m_pool->componentsById(name);
+                ComponentBox components = current->pool->componentsById(name);
                 if (!components.isEmpty()) {
                     ret += components.toList();
                     break;
                 }
-                ret += pool->m_pool->componentsByProvided(AppStream::Provided::KindId, name).toList();
+                ret += current->pool->componentsByProvided(AppStream::Provided::KindId, name).toList();
             }
             return {pool, ret};
         },
@@ -7,8 +7,14 @@
 #pragma once
 
 #include <QFuture>
+#include <QHash>
 #include <QMutex>
 #include <QPointer>
+#include <QReadWriteLock>
+#include <QSet>
+
+#include <atomic>
+#include <memory>
 
 #include <AppStreamQt/pool.h>
 
@@ -24,15 +30,52 @@ class DISCOVERCOMMON_EXPORT ConcurrentPool : public QObject
 {
     Q_OBJECT
 public:
+    enum class LockingMode {
+        /// Queries are run one after the other
+        Serialized,
+        /**
+         * Queries run in parallel, only operations that change the pool are exclusive.
+         *
+         * AsPool guards its data and its cache with a GRWLock of its own, so
+         * queries can read from it at the same time. AppStreamPoolBenchmark
+         * checks that they find the same as serialized ones.
+         */
+        ConcurrentReads,
+    };
+    Q_ENUM(LockingMode)
+
+    explicit ConcurrentPool(LockingMode mode = LockingMode::ConcurrentReads);
+
     /**
      * Tells which @p pool to use and in which thread pool the jobs will be run
      *
+     * A pool that was set before is swapped out right away, queries that are
+     * running on it finish there and it's deleted after them.
+     *
      * @param pool takes ownership
      * @param threadPool does not take ownership
      */
     void reset(AppStream::Pool *pool, QThreadPool *threadPool);
 
-    QFuture<ComponentBox> search(const QString &term);
+    /**
+     * Sets how queries synchronize with each other, ConcurrentReads by default.
+     *
+     * Queries that were issued already keep the mode they were issued with.
+     */
+    void setLockingMode(LockingMode mode);
+    LockingMode lockingMode() const
+    {
+        return m_lockingMode;
+    }
+
+    /**
+     * Searches for @p term.
+     *
+     * If @p requester is set, a search for the same term that is still
+     * pending is shared rather than run again. A search that hasn't started
+     * yet gets cancelled once all of its requesters are destroyed.
+     */
+    QFuture<ComponentBox> search(const QString &term, QObject *requester = nullptr);
 
     QFuture<ComponentBox> components();
 
@@ -57,18 +100,34 @@ public:
     QString lastError();
     void loadAsync();
 
-    AppStream::Pool *get() const
-    {
-        return m_pool.get();
-    }
+    AppStream::Pool *get() const;
 
 Q_SIGNALS:
     void loadFinished(bool success);
 
 private:
-    QMutex m_mutex;
-    std::unique_ptr<AppStream::Pool> m_pool;
+    // A pool and what synchronizes access to it, kept alive by the queries that use it
+    struct State {
+        explicit State(AppStream::Pool *pool);
+        std::unique_ptr<AppStream::Pool, void (*)(AppStream::Pool *)> pool;
+        QReadWriteLock lock;
+    };
+
+    template<typename Query>
+    QFuture<ComponentBox> runQuery(Query query);
+    std::shared_ptr<State> state() const;
+    void requesterDestroyed(QObject *requester);
+
+    std::atomic<LockingMode> m_lockingMode;
+    mutable QMutex m_stateMutex;
+    std::shared_ptr<State> m_state;
     QPointer<QThreadPool> m_threadPool;
+
+    struct PendingSearch {
+        QFuture<ComponentBox> future;
+        QSet<QObject *> requesters;
+    };
+    QHash<QString, PendingSearch> m_pendingSearches;
 };
 
 }
@@ -0,0 +1,512 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "OdrsRatings.h"
+#include "libdiscover_debug.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <queue>
+
+static constexpr int s_starCount = 6;
+static constexpr quint32 s_cacheVersion = 1;
+static constexpr char s_cacheMagic[4] = {'O', 'D', 'R', 'S'};
+
+// Both are copied in and out of the buffer, which has no alignment guarantees
+struct OdrsRatings::Header {
+    char magic[4];
+    quint32 version;
+    quint32 count;
+    quint32 poolSize;
+    // Identifies the JSON file the cache was generated from
+    qint64 sourceModified;
+    qint64 sourceSize;
+};
+
+struct OdrsRatings::Entry {
+    quint32 idOffset;
+    quint32 idLength;
+    quint32 stars[s_starCount];
+};
+
+namespace
+{
+/**
+ * Reads JSON tokens straight from the document, without building a DOM.
+ * Only what the ratings file needs is interpreted, the rest is skipped.
+ */
+class JsonScanner
+{
+public:
+    explicit JsonScanner(QByteArrayView data)
+        : m_data(data)
+    {
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (m_pos < m_data.size() && m_data[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    char peek()
+    {
+        skipSpace();
+        return m_pos < m_data.size() ? m_data[m_pos] : '\0';
+    }
+
+    bool readString(QByteArray &out)
+    {
+        out.clear();
+        if (!consume('"')) {
+            return false;
+        }
+        while (m_pos < m_data.size()) {
+            const char c = m_data[m_pos++];
+            if (c == '"') {
+                return true;
+            } else if (c != '\\') {
+                out += c;
+            } else if (!readEscape(out)) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool readInteger(qint64 &out)
+    {
+        skipSpace();
+        const qsizetype start = m_pos;
+        if (m_pos < m_data.size() && m_data[m_pos] == '-') {
+            ++m_pos;
+        }
+        while (m_pos < m_data.size() && isNumberChar(m_data[m_pos])) {
+            ++m_pos;
+        }
+        bool ok = false;
+        out = qint64(m_data.sliced(start, m_pos - start).toDouble(&ok));
+        return ok;
+    }
+
+    bool skipValue(int depth = 0)
+    {
+        static constexpr int maxDepth = 64;
+        QByteArray ignored;
+        switch (peek()) {
+        case '"':
+            return readString(ignored);
+        case '{':
+        case '[': {
+            const char close = m_data[m_pos] == '{' ? '}' : ']';
+            ++m_pos;
+            if (depth >= maxDepth) {
+                return false;
+            }
+            if (consume(close)) {
+                return true;
+            }
+            do {
+                if (close == '}' && (!readString(ignored) || !consume(':'))) {
+                    return false;
+                }
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(close);
+        }
+        default: {
+            // Numbers, true, false and null
+            const qsizetype start = m_pos;
+            while (m_pos < m_data.size() && (isNumberChar(m_data[m_pos]) || m_data[m_pos] == '-' || (m_data[m_pos] >= 'a' && m_data[m_pos] <= 'z'))) {
+                ++m_pos;
+            }
+            return m_pos > start;
+        }
+        }
+    }
+
+private:
+    static bool isNumberChar(char c)
+    {
+        return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+';
+    }
+
+    void skipSpace()
+    {
+        while (m_pos < m_data.size() && (m_data[m_pos] == ' ' || m_data[m_pos] == '\n' || m_data[m_pos] == '\r' || m_data[m_pos] == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool readHex(char16_t &out)
+    {
+        if (m_pos + 4 > m_data.size()) {
+            return false;
+        }
+        bool ok = false;
+        out = m_data.sliced(m_pos, 4).toUShort(&ok, 16);
+        m_pos += 4;
+        return ok;
+    }
+
+    bool readEscape(QByteArray &out)
+    {
+        if (m_pos >= m_data.size()) {
+            return false;
+        }
+        const char c = m_data[m_pos++];
+        switch (c) {
+        case 'b':
+            out += '\b';
+            return true;
+        case 'f':
+            out += '\f';
+            return true;
+        case 'n':
+            out += '\n';
+            return true;
+        case 'r':
+            out += '\r';
+            return true;
+        case 't':
+            out += '\t';
+            return true;
+        case 'u': {
+            char16_t units[2];
+            qsizetype count = 1;
+            if (!readHex(units[0])) {
+                return false;
+            }
+            if (QChar::isHighSurrogate(units[0]) && m_data.sliced(m_pos).startsWith("\\u")) {
+                m_pos += 2;
+                if (!readHex(units[1])) {
+                    return false;
+                }
+                count = 2;
+            }
+            out += QStringView(units, count).toUtf8();
+            return true;
+        }
+        default:
+            // \" \\ and \/
+            out += c;
+            return true;
+        }
+    }
+
+    const QByteArrayView m_data;
+    qsizetype m_pos = 0;
+};
+
+QByteArray lowerId(QByteArrayView id)
+{
+    const bool ascii = std::all_of(id.begin(), id.end(), [](char c) {
+        return uchar(c) < 0x80;
+    });
+    if (!ascii) {
+        return QString::fromUtf8(id).toLower().toUtf8();
+    }
+    QByteArray ret = id.toByteArray();
+    for (char &c : ret) {
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+    }
+    return ret;
+}
+}
+
+OdrsRatings::OdrsRatings() = default;
+OdrsRatings::~OdrsRatings() = default;
+
+OdrsRatings::OdrsRatings(const QByteArray &data, const std::shared_ptr<QFile> &mapping)
+    : m_data(data)
+    , m_mapping(mapping)
+{
+}
+
+OdrsRatings OdrsRatings::load(const QString &path, const QString &cachePath)
+{
+    const QFileInfo source(path);
+    if (auto cached = fromCache(cachePath, source); !cached.isEmpty()) {
+        return cached;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(LIBDISCOVER_LOG) << "OdrsReviewsBackend: Could not open file" << file.fileName();
+        return {};
+    }
+
+    // Mapping lets the kernel page the document in as the scanner goes through it
+    const uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    const QByteArray read = mapped ? QByteArray() : file.readAll();
+    const QByteArrayView json = mapped ? QByteArrayView(mapped, file.size()) : QByteArrayView(read);
+
+    bool ok = false;
+    OdrsRatings ret = fromJson(json, &ok);
+    if (!ok) {
+        qCWarning(LIBDISCOVER_LOG) << "OdrsReviewsBackend: Error parsing ratings:" << file.fileName();
+    } else if (!ret.writeCache(cachePath, source)) {
+        qCWarning(LIBDISCOVER_LOG) << "OdrsReviewsBackend: Could not write the ratings cache" << cachePath;
+    }
+    return ret;
+}
+
+OdrsRatings OdrsRatings::fromJson(QByteArrayView json, bool *ok)
+{
+    struct Parsed {
+        QByteArray id;
+        quint32 stars[s_starCount];
+    };
+    std::vector<Parsed> parsed;
+
+    JsonScanner scanner(json);
+    const auto parse = [&scanner, &parsed]() -> bool {
+        if (!scanner.consume('{')) {
+            return false;
+        }
+        if (scanner.consume('}')) {
+            return true;
+        }
+
+        QByteArray key;
+        QByteArray field;
+        do {
+            if (!scanner.readString(key) || !scanner.consume(':')) {
+                return false;
+            }
+            if (scanner.peek() != '{') {
+                if (!scanner.skipValue()) {
+                    return false;
+                }
+                continue;
+            }
+
+            Parsed app{lowerId(key), {}};
+            scanner.consume('{');
+            if (!scanner.consume('}')) {
+                do {
+                    if (!scanner.readString(field) || !scanner.consume(':')) {
+                        return false;
+                    }
+                    // "star0" to "star5", "total" is their sum
+                    const int star = field.size() == 5 && field.startsWith("star") ? field[4] - '0' : -1;
+                    if (star >= 0 && star < s_starCount) {
+                        qint64 value;
+                        if (!scanner.readInteger(value)) {
+                            return false;
+                        }
+                        app.stars[star] = quint32(std::clamp<qint64>(value, 0, std::numeric_limits<quint32>::max()));
+                    } else if (!scanner.skipValue()) {
+                        return false;
+                    }
+                } while (scanner.consume(','));
+                if (!scanner.consume('}')) {
+                    return false;
+                }
+            }
+            parsed.push_back(std::move(app));
+        } while (scanner.consume(','));
+        return scanner.consume('}');
+    };
+    const bool parsedAll = parse();
+    if (ok) {
+        *ok = parsedAll;
+    }
+
+    // Sorted by id so lookups can bisect, a later duplicate replaces the earlier one
+    std::stable_sort(parsed.begin(), parsed.end(), [](const Parsed &left, const Parsed &right) {
+        return left.id < right.id;
+    });
+    auto last = std::unique(parsed.rbegin(), parsed.rend(), [](const Parsed &left, const Parsed &right) {
+        return left.id == right.id;
+    });
+    parsed.erase(parsed.begin(), last.base());
+
+    const qsizetype poolSize = std::accumulate(parsed.cbegin(), parsed.cend(), qsizetype(0), [](qsizetype size, const Parsed &app) {
+        return size + app.id.size();
+    });
+    QByteArray data(sizeof(Header) + parsed.size() * sizeof(Entry) + poolSize, Qt::Uninitialized);
+    Header header{};
+    std::copy(std::begin(s_cacheMagic), std::end(s_cacheMagic), header.magic);
+    header.version = s_cacheVersion;
+    header.count = parsed.size();
+    header.poolSize = poolSize;
+    std::memcpy(data.data(), &header, sizeof(Header));
+
+    char *entries = data.data() + sizeof(Header);
+    char *pool = entries + parsed.size() * sizeof(Entry);
+    quint32 offset = 0;
+    for (const Parsed &app : parsed) {
+        Entry entry{};
+        entry.idOffset = offset;
+        entry.idLength = app.id.size();
+        std::copy(std::begin(app.stars), std::end(app.stars), entry.stars);
+        std::memcpy(entries, &entry, sizeof(Entry));
+        entries += sizeof(Entry);
+        std::copy(app.id.cbegin(), app.id.cend(), pool + offset);
+        offset += app.id.size();
+    }
+    return OdrsRatings(data);
+}
+
+OdrsRatings OdrsRatings::fromCache(const QString &cachePath, const QFileInfo &source)
+{
+    auto file = std::make_shared<QFile>(cachePath);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(Header))) {
+        return {};
+    }
+
+    const uchar *mapped = file->map(0, file->size());
+    if (!mapped) {
+        return {};
+    }
+
+    OdrsRatings ret(QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file->size()), file);
+    const Header header = ret.header();
+    if (header.sourceModified != source.lastModified().toMSecsSinceEpoch() || header.sourceSize != source.size() || !ret.isValid()) {
+        return {};
+    }
+    return ret;
+}
+
+bool OdrsRatings::writeCache(const QString &cachePath, const QFileInfo &source) const
+{
+    QByteArray data = m_data;
+    Header header = this->header();
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    header.sourceSize = source.size();
+    std::memcpy(data.data(), &header, sizeof(Header));
+
+    QSaveFile file(cachePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+}
+
+bool OdrsRatings::isValid() const
+{
+    if (quint64(m_data.size()) < sizeof(Header)) {
+        return false;
+    }
+    const Header header = this->header();
+    if (!std::equal(std::begin(s_cacheMagic), std::end(s_cacheMagic), header.magic) || header.version != s_cacheVersion
+        || quint64(m_data.size()) != sizeof(Header) + quint64(header.count) * sizeof(Entry) + header.poolSize) {
+        return false;
+    }
+    for (qsizetype i = 0; i < qsizetype(header.count); ++i) {
+        const Entry entry = entryAt(i);
+        if (quint64(entry.idOffset) + entry.idLength > header.poolSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OdrsRatings::Header OdrsRatings::header() const
+{
+    Header ret;
+    std::memcpy(&ret, m_data.constData(), sizeof(Header));
+    return ret;
+}
+
+OdrsRatings::Entry OdrsRatings::entryAt(qsizetype index) const
+{
+    Entry ret;
+    std::memcpy(&ret, m_data.constData() + sizeof(Header) + index * sizeof(Entry), sizeof(Entry));
+    return ret;
+}
+
+qsizetype OdrsRatings::size() const
+{
+    return m_data.isEmpty() ? 0 : header().count;
+}
+
+QByteArrayView OdrsRatings::idAt(qsizetype index) const
+{
+    const Entry entry = entryAt(index);
+    const char *pool = m_data.constData() + sizeof(Header) + size() * sizeof(Entry);
+    return QByteArrayView(pool + entry.idOffset, entry.idLength);
+}
+
+qsizetype OdrsRatings::indexOf(const QString &appstreamId) const
+{
+    if (appstreamId.isEmpty() || isEmpty()) {
+        return -1;
+    }
+
+    const QByteArray id = appstreamId.toLower().toUtf8();
+    qsizetype first = 0;
+    qsizetype count = size();
+    while (count > 0) {
+        const qsizetype step = count / 2;
+        if (idAt(first + step) < id) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first < size() && idAt(first) == id ? first : -1;
+}
+
+quint64 OdrsRatings::ratingCount(const Entry &entry)
+{
+    return std::accumulate(std::begin(entry.stars), std::end(entry.stars), quint64(0));
+}
+
+Rating OdrsRatings::ratingAt(qsizetype index) const
+{
+    const Entry entry = entryAt(index);
+    int stars[s_starCount];
+    std::copy(std::begin(entry.stars), std::end(entry.stars), stars);
+    return Rating(QString::fromUtf8(idAt(index)), ratingCount(entry), stars);
+}
+
+Rating OdrsRatings::rating(const QString &appstreamId) const
+{
+    const qsizetype index = indexOf(appstreamId);
+    return index < 0 ? Rating() : ratingAt(index);
+}
+
+QList<Rating> OdrsRatings::top(qsizetype count) const
+{
+    // Most rated first, the earlier in the table (i.e. by id) on ties
+    using Candidate = std::pair<quint64, qsizetype>;
+    const auto better = [](const Candidate &left, const Candidate &right) {
+        return left.first > right.first || (left.first == right.first && left.second < right.second);
+    };
+
+    // The worst of the ones we keep is at the top, ready to be replaced
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(better)> heap(better);
+    for (qsizetype i = 0, c = size(); i < c; ++i) {
+        const Candidate candidate{ratingCount(entryAt(i)), i};
+        if (qsizetype(heap.size()) < count) {
+            heap.push(candidate);
+        } else if (count > 0 && better(candidate, heap.top())) {
+            heap.pop();
+            heap.push(candidate);
+        }
+    }
+
+    QList<Rating> ret(heap.size());
+    for (qsizetype i = heap.size() - 1; i >= 0; --i) {
+        ret[i] = ratingAt(heap.top().second);
+        heap.pop();
+    }
+    return ret;
+}
@@ -0,0 +1,85 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+
+#include <ReviewsBackend/Rating.h>
+
+#include "discovercommon_export.h"
+
+class QFile;
+class QFileInfo;
+
+/**
+ * \class OdrsRatings  OdrsRatings.h "OdrsRatings.h"
+ *
+ * \brief Table with the star counts of every application in the ODRS ratings file
+ *
+ * The table is a flat image: a header, one fixed-size entry per application
+ * sorted by lowercase AppStream id, and a pool with those ids. The same image
+ * is stored as a binary cache next to the ratings file so that it can be
+ * memory-mapped on the next start instead of parsing the JSON again.
+ */
+class DISCOVERCOMMON_EXPORT OdrsRatings
+{
+public:
+    OdrsRatings();
+    ~OdrsRatings();
+
+    /**
+     * Loads the ratings in the JSON file @p path.
+     *
+     * The binary cache at @p cachePath is used if it was generated from the
+     * current @p path, otherwise it is written after parsing.
+     */
+    static OdrsRatings load(const QString &path, const QString &cachePath);
+
+    /// Parses an ODRS ratings document, skipping anything it doesn't know about
+    static OdrsRatings fromJson(QByteArrayView json, bool *ok = nullptr);
+
+    qsizetype size() const;
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /// @returns the position of @p appstreamId in the table, -1 if it's not there
+    qsizetype indexOf(const QString &appstreamId) const;
+    bool contains(const QString &appstreamId) const
+    {
+        return indexOf(appstreamId) >= 0;
+    }
+
+    Rating ratingAt(qsizetype index) const;
+    Rating rating(const QString &appstreamId) const;
+
+    /// @returns the @p count applications with the most ratings, most rated first
+    QList<Rating> top(qsizetype count) const;
+
+private:
+    struct Header;
+    struct Entry;
+
+    explicit OdrsRatings(const QByteArray &data, const std::shared_ptr<QFile> &mapping = {});
+
+    static OdrsRatings fromCache(const QString &cachePath, const QFileInfo &source);
+    bool writeCache(const QString &cachePath, const QFileInfo &source) const;
+    bool isValid() const;
+
+    Header header() const;
+    Entry entryAt(qsizetype index) const;
+    QByteArrayView idAt(qsizetype index) const;
+    static quint64 ratingCount(const Entry &entry);
+
+    // Either owned or a view on m_mapping
+    QByteArray m_data;
+    std::shared_ptr<QFile> m_mapping;
+};
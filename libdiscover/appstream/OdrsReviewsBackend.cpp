@@ -170,11 +170,7 @@ ReviewsJob *OdrsReviewsBackend::fetchReviews(AbstractResource *resource, int pag
 
 Rating OdrsReviewsBackend::ratingForApplication(AbstractResource *resource) const
 {
-    if (resource->appstreamId().isEmpty()) {
-        return {};
-    }
-
-    return m_current.ratings[resource->appstreamId().toLower()];
+    return m_current.ratings.rating(resource->appstreamId());
 }
 
 void OdrsReviewsBackend::submitUsefulness(Review *review, bool useful)
@@ -253,57 +249,16 @@ void OdrsReviewsBackend::parseRatings()
     connect(fw, &QFutureWatcher<State>::finished, this, [this, fw] {
         fw->deleteLater();
         m_current = fw->result();
+        invalidateRatings();
         Q_EMIT ratingsReady();
     });
     fw->setFuture(QtConcurrent::run([]() -> State {
-        QFile ratingsDocument(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1StringView("/ratings/ratings"));
-        if (!ratingsDocument.open(QIODevice::ReadOnly)) {
-            qCWarning(LIBDISCOVER_LOG) << "OdrsReviewsBackend: Could not open file" << ratingsDocument.fileName();
-            return {};
-        }
-
-        QJsonParseError error;
-        const auto jsonDocument = QJsonDocument::fromJson(ratingsDocument.readAll(), &error);
-        if (error.error) {
-            qCWarning(LIBDISCOVER_LOG) << "OdrsReviewsBackend: Error parsing ratings:" << ratingsDocument.errorString() << error.errorString();
-        }
+        const QString ratingsPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1StringView("/ratings/ratings");
 
         State state;
-        const auto jsonObject = jsonDocument.object();
-        state.ratings.reserve(jsonObject.size());
+        state.ratings = OdrsRatings::load(ratingsPath, ratingsPath + QLatin1StringView(".bin"));
         constexpr uint topSize = 25;
-        for (auto it = jsonObject.begin(); it != jsonObject.end(); it++) {
-            const auto appJsonObject = it.value().toObject();
-            const auto packageName = it.key().toLower();
-
-            const int ratingCount = appJsonObject.value(QLatin1String("total")).toInt();
-            int ratingMap[] = {
-                appJsonObject.value(QLatin1String("star0")).toInt(),
-                appJsonObject.value(QLatin1String("star1")).toInt(),
-                appJsonObject.value(QLatin1String("star2")).toInt(),
-                appJsonObject.value(QLatin1String("star3")).toInt(),
-                appJsonObject.value(QLatin1String("star4")).toInt(),
-                appJsonObject.value(QLatin1String("star5")).toInt(),
-            };
-
-            const auto rating = Rating(packageName, ratingCount, ratingMap);
-            const auto finder = [&rating](const Rating &review) {
-                return review.ratingCount() < rating.ratingCount();
-            };
-            const auto topIt = std::find_if(state.top.begin(), state.top.end(), finder);
-            if (topIt == state.top.end()) {
-                if (state.top.size() < topSize) {
-                    state.top.append(rating);
-                }
-            } else {
-                state.top.insert(topIt, rating);
-            }
-            if (state.top.size() > topSize) {
-                state.top.resize(topSize);
-            }
-
-            state.ratings.insert(packageName, rating);
-        }
+        state.top = state.ratings.top(topSize);
 
         // Filter out non-apps, to match behavior of lists backed by ResourcesProxyModel
         AppStream::Pool appstreamData;
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "OdrsRatings.h"
 #include <ReviewsBackend/AbstractReviewsBackend.h>
 #include <ReviewsBackend/ReviewsModel.h>
 
@@ -65,6 +66,12 @@ public:
         return m_current.top;
     }
 
+    /// The table is implicitly shared and immutable, so copies can be read from any thread
+    OdrsRatings ratings() const
+    {
+        return m_current.ratings;
+    }
+
 private Q_SLOTS:
     void ratingsFetched(KJob *job);
     void usefulnessSubmitted();
@@ -89,7 +96,7 @@ private:
     QHash<QByteArray, ReviewsJob *> m_jobs;
 
     struct State {
-        QHash<QString, Rating> ratings;
+        OdrsRatings ratings;
         QList<Rating> top;
     } m_current;
 };
@@ -0,0 +1,27 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "AlpineApkAppStreamIndex.h"
+
+void AlpineApkAppStreamIndex::add(const AppStream::Component &component)
+{
+    const QStringList packageNames = component.packageNames();
+    for (const QString &packageName : packageNames) {
+        // workaround for kate (Kate Sessions is found first, but
+        //   package name = "kate" too, bugged metadata?)
+        if (packageName == QLatin1String("kate") && component.id() != QLatin1String("org.kde.kate")) {
+            continue;
+        }
+        if (!m_components.contains(packageName)) {
+            m_components.insert(packageName, component);
+        }
+    }
+}
+
+AppStream::Component AlpineApkAppStreamIndex::component(const QString &packageName) const
+{
+    return m_components.value(packageName);
+}
@@ -0,0 +1,40 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef ALPINEAPKAPPSTREAMINDEX_H
+#define ALPINEAPKAPPSTREAMINDEX_H
+
+#include <AppStreamQt/component.h>
+#include <QHash>
+#include <QString>
+
+/**
+ * @class AlpineApkAppStreamIndex
+ *
+ * @details Finds the AppStream component of a package by its name.
+ *
+ * Components are added in the order the pool lists them, and the first
+ * one to name a package gets it, so looking a package up is the same as
+ * going through the pool until a component names it.
+ */
+class AlpineApkAppStreamIndex
+{
+public:
+    void add(const AppStream::Component &component);
+
+    /// The component of @p packageName, an empty one if it has none
+    AppStream::Component component(const QString &packageName) const;
+
+    qsizetype size() const
+    {
+        return m_components.size();
+    }
+
+private:
+    QHash<QString, AppStream::Component> m_components;
+};
+
+#endif // ALPINEAPKAPPSTREAMINDEX_H
@@ -19,7 +19,13 @@
 
 #include <KLocalizedString>
 
+#include <AppStreamQt/component-box.h>
+#include <AppStreamQt/developer.h>
+#include <AppStreamQt/icon.h>
+#include <AppStreamQt/image.h>
 #include <AppStreamQt/pool.h>
+#include <AppStreamQt/release.h>
+#include <AppStreamQt/screenshot.h>
 #include <AppStreamQt/version.h>
 
 #include <QAction>
@@ -33,6 +39,7 @@
 #include <QTimer>
 #include <QtConcurrentRun>
 
+#include <algorithm>
 #include <utility>
 
 DISCOVER_BACKEND_PLUGIN(AlpineApkBackend)
@@ -42,7 +49,6 @@ AlpineApkBackend::AlpineApkBackend(QObject *parent)
     , m_updater(new AlpineApkUpdater(this))
     , m_reviews(new AlpineApkReviewsBackend(this))
     , m_updatesTimeoutTimer(new QTimer(this))
-    , m_appStreamComponents(AppStream::ComponentBox::Flag::FlagNone)
 {
 #ifndef QT_DEBUG
     const_cast<QLoggingCategory &>(LOG_ALPINEAPK()).setEnabled(QtDebugMsg, false);
@@ -72,9 +78,10 @@ AlpineApkBackend::AlpineApkBackend(QObject *parent)
     SourcesModel::global()->addSourcesBackend(new AlpineApkSourcesBackend(this));
 }
 
-// this fills in m_appStreamComponents
-void AlpineApkBackend::loadAppStreamComponents()
+// this indexes all AppStream components by package name
+AlpineApkAppStreamIndex AlpineApkBackend::loadAppStreamIndex()
 {
+    AlpineApkAppStreamIndex index;
     AppStream::Pool *appStreamPool = new AppStream::Pool();
     // use newer API and flags available only since 0.15.0
     appStreamPool->setFlags(AppStream::Pool::Flags(AppStream::Pool::Flag::FlagLoadOsCatalog | AppStream::Pool::Flag::FlagLoadOsDesktopFiles
@@ -86,11 +93,14 @@ void AlpineApkBackend::loadAppStreamComponents()
     if (!appStreamPool->load()) {
         qCWarning(LOG_ALPINEAPK) << "backend: Failed to load appstream data:" << appStreamPool->lastError();
     } else {
-        m_appStreamComponents = appStreamPool->components();
-        qCDebug(LOG_ALPINEAPK) << "backend: loaded AppStream metadata OK:" << m_appStreamComponents.size() << "components.";
+        const AppStream::ComponentBox components = appStreamPool->components();
+        for (const AppStream::Component &component : components) {
+            index.add(component);
+        }
+        qCDebug(LOG_ALPINEAPK) << "backend: loaded AppStream metadata OK:" << components.size() << "components for" << index.size() << "packages.";
         // collect all categories present in appstream metadata
         // QSet<QString> collectedCategories;
-        // for (const AppStream::Component &component : m_appStreamComponents) {
+        // for (const AppStream::Component &component : components) {
         //     const QStringList cats = component.categories();
         //     for (const QString &cat : cats) {
         //         collectedCategories.insert(cat);
@@ -102,37 +112,68 @@ void AlpineApkBackend::loadAppStreamComponents()
         // }
     }
     delete appStreamPool;
+    return index;
 }
 
-// this uses m_appStreamComponents and m_availablePackages
-//      to fill in m_resourcesAppstreamData
-void AlpineApkBackend::parseAppStreamMetadata()
-{
-    if (m_availablePackages.size() > 0) {
-        for (const QtApk::Package &pkg : std::as_const(m_availablePackages)) {
-            // try to find appstream data for this package
-            AppStream::Component appstreamComponent;
-            for (const auto &appsC : std::as_const(m_appStreamComponents)) {
-                // find result which package name is exactly the one we want
-                if (appsC.packageNames().contains(pkg.name)) {
-                    // workaround for kate (Kate Sessions is found first, but
-                    //   package name = "kate" too, bugged metadata?)
-                    if (pkg.name == QStringLiteral("kate")) {
-                        // qCDebug(LOG_ALPINEAPK) << appsC.packageNames() << appsC.id();
-                        // ^^ ("kate") "org.kde.plasma.katesessions"
-                        if (appsC.id() != QStringLiteral("org.kde.kate")) {
-                            continue;
-                        }
-                    }
-                    appstreamComponent = appsC;
-                    break; // exit for() loop
-                }
-            }
-
-            const QString key = pkg.name.toLower();
-            m_resourcesAppstreamData.insert(key, appstreamComponent);
-        }
+// this looks up the AppStream data of every package,
+//      keyed by lowercase package name like m_resourcesAppstreamData
+QHash<QString, AppStream::Component> AlpineApkBackend::matchAppStreamData(const QVector<QtApk::Package> &packages, const AlpineApkAppStreamIndex &index)
+{
+    QHash<QString, AppStream::Component> ret;
+    ret.reserve(packages.size());
+    for (const QtApk::Package &pkg : packages) {
+        ret.insert(pkg.name.toLower(), index.component(pkg.name));
     }
+    return ret;
+}
+
+template<typename T, typename Same>
+static bool sameLists(const QList<T> &a, const QList<T> &b, Same same)
+{
+    return std::equal(a.cbegin(), a.cend(), b.cbegin(), b.cend(), same);
+}
+
+static bool sameReleases(const AppStream::ReleaseList &a, const AppStream::ReleaseList &b)
+{
+    return sameLists(a.entries(), b.entries(), [](const AppStream::Release &left, const AppStream::Release &right) {
+        return left.version() == right.version() && left.timestamp() == right.timestamp() && left.description() == right.description();
+    });
+}
+
+static bool sameScreenshots(const QList<AppStream::Screenshot> &a, const QList<AppStream::Screenshot> &b)
+{
+    return sameLists(a, b, [](const AppStream::Screenshot &left, const AppStream::Screenshot &right) {
+        return left.mediaKind() == right.mediaKind()
+            && sameLists(left.images(), right.images(), [](const AppStream::Image &leftImage, const AppStream::Image &rightImage) {
+                   return leftImage.kind() == rightImage.kind() && leftImage.url() == rightImage.url() && leftImage.size() == rightImage.size();
+               });
+    });
+}
+
+static bool sameUrls(const AppStream::Component &a, const AppStream::Component &b)
+{
+    static constexpr auto urlKinds = {AppStream::Component::UrlKindHomepage,
+                                      AppStream::Component::UrlKindHelp,
+                                      AppStream::Component::UrlKindBugtracker,
+                                      AppStream::Component::UrlKindDonation};
+    return std::all_of(urlKinds.begin(), urlKinds.end(), [&a, &b](AppStream::Component::UrlKind kind) {
+        return a.url(kind) == b.url(kind);
+    });
+}
+
+static bool sameIcons(const QList<AppStream::Icon> &a, const QList<AppStream::Icon> &b)
+{
+    return sameLists(a, b, [](const AppStream::Icon &left, const AppStream::Icon &right) {
+        return left.kind() == right.kind() && left.name() == right.name() && left.url() == right.url() && left.size() == right.size();
+    });
+}
+
+// whether a reload brought anything new for a package, that is anything AlpineApkResource reads
+static bool sameAppStreamData(const AppStream::Component &a, const AppStream::Component &b)
+{
+    return a.id() == b.id() && a.kind() == b.kind() && a.name() == b.name() && a.summary() == b.summary() && a.description() == b.description()
+        && a.categories() == b.categories() && a.keywords() == b.keywords() && a.developer().name() == b.developer().name() && sameUrls(a, b)
+        && sameIcons(a.icons(), b.icons()) && sameReleases(a.releasesPlain(), b.releasesPlain()) && sameScreenshots(a.screenshotsAll(), b.screenshotsAll());
 }
 
 static AbstractResource::Type toDiscoverResourceType(const AppStream::Component &component)
@@ -155,46 +196,70 @@ static AbstractResource::Type toDiscoverResourceType(const AppStream::Component
     return resType;
 }
 
-void AlpineApkBackend::fillResourcesAndApplyAppStreamData()
+void AlpineApkBackend::createResources()
 {
-    // now the tricky part - we need to reapply appstream component metadata to each resource
-    if (m_availablePackages.size() > 0) {
-        for (const QtApk::Package &pkg : m_availablePackages) {
-            const QString key = pkg.name.toLower();
+    for (const QtApk::Package &pkg : std::as_const(m_availablePackages)) {
+        const QString key = pkg.name.toLower();
+        if (m_resources.contains(key)) {
+            continue;
+        }
 
-            AppStream::Component &appsComponent = m_resourcesAppstreamData[key];
-            const AbstractResource::Type resType = toDiscoverResourceType(appsComponent);
-
-            AlpineApkResource *res = m_resources.value(key, nullptr);
-            if (res == nullptr) {
-                // during first run of this function during initial load
-                //   m_resources hash is empty, so we need to insert new items
-                res = new AlpineApkResource(pkg, appsComponent, resType, this);
-                res->setCategoryName(QStringLiteral("alpine_packages"));
-                res->setOriginSource(QStringLiteral("apk"));
-                res->setSection(QStringLiteral("dummy"));
-                m_resources.insert(key, res);
-                QObject::connect(res, &AlpineApkResource::stateChanged, this, &AlpineApkBackend::updatesCountChanged);
-            } else {
-                // this is not an initial run, just update existing resource
-                res->setAppStreamData(appsComponent);
-            }
+        AppStream::Component &appsComponent = m_resourcesAppstreamData[key];
+        const AbstractResource::Type resType = toDiscoverResourceType(appsComponent);
+
+        AlpineApkResource *res = new AlpineApkResource(pkg, appsComponent, resType, this);
+        res->setCategoryName(QStringLiteral("alpine_packages"));
+        res->setOriginSource(QStringLiteral("apk"));
+        res->setSection(QStringLiteral("dummy"));
+        m_resources.insert(key, res);
+        QObject::connect(res, &AlpineApkResource::stateChanged, this, &AlpineApkBackend::updatesCountChanged);
+    }
+}
+
+void AlpineApkBackend::applyAppStreamData(const QHash<QString, AppStream::Component> &changed)
+{
+    // only the resources whose metadata changed need it reapplied
+    for (auto it = changed.cbegin(); it != changed.cend(); ++it) {
+        if (AlpineApkResource *res = m_resources.value(it.key(), nullptr)) {
+            res->setAppStreamData(it.value());
         }
     }
 }
 
+namespace
+{
+struct AppStreamReload {
+    QHash<QString, AppStream::Component> components;
+    QHash<QString, AppStream::Component> changed;
+};
+}
+
 void AlpineApkBackend::reloadAppStreamMetadata()
 {
     // mark us as "Loading..."
     m_fetching = true;
+    Q_EMIT fetchingUpdatesProgressChanged();
 
-    loadAppStreamComponents();
-    parseAppStreamMetadata();
-    fillResourcesAndApplyAppStreamData();
-
-    // mark us as "done loading"
-    m_fetching = false;
-    Q_EMIT contentsChanged();
+    // loading and matching metadata takes a while, do it in a background thread;
+    //    the GUI thread only touches resources whose metadata changed
+    QtConcurrent::run([packages = m_availablePackages, previous = m_resourcesAppstreamData]() {
+        AppStreamReload reload;
+        reload.components = matchAppStreamData(packages, loadAppStreamIndex());
+        for (auto it = reload.components.cbegin(); it != reload.components.cend(); ++it) {
+            if (!sameAppStreamData(previous.value(it.key()), it.value())) {
+                reload.changed.insert(it.key(), it.value());
+            }
+        }
+        return reload;
+    }).then(this, [this](const AppStreamReload &reload) {
+        qCDebug(LOG_ALPINEAPK) << "AppStream metadata changed for" << reload.changed.size() << "packages";
+        m_resourcesAppstreamData = reload.components;
+        applyAppStreamData(reload.changed);
+
+        // mark us as "done loading"
+        m_fetching = false;
+        Q_EMIT contentsChanged();
+    });
 }
 
 // this function is executed in the background thread
@@ -204,7 +269,7 @@ void AlpineApkBackend::loadResources()
 
     qCDebug(LOG_ALPINEAPK) << "backend: loading AppStream metadata...";
 
-    loadAppStreamComponents();
+    const AlpineApkAppStreamIndex appStreamIndex = loadAppStreamIndex();
 
     qCDebug(LOG_ALPINEAPK) << "backend: populating resources...";
 
@@ -214,7 +279,7 @@ void AlpineApkBackend::loadResources()
         m_apkdb.close();
     }
 
-    parseAppStreamMetadata();
+    m_resourcesAppstreamData = matchAppStreamData(m_availablePackages, appStreamIndex);
 
     qCDebug(LOG_ALPINEAPK) << "  available" << m_availablePackages.size() << "packages";
     qCDebug(LOG_ALPINEAPK) << "  installed" << m_installedPackages.size() << "packages";
@@ -224,7 +289,7 @@ void AlpineApkBackend::onLoadResourcesFinished()
 {
     qCDebug(LOG_ALPINEAPK) << "backend: appstream data loaded and sorted; fill in resources";
 
-    fillResourcesAndApplyAppStreamData();
+    createResources();
 
     // update "installed/not installed" state
     if (m_installedPackages.size() > 0) {
@@ -340,7 +405,7 @@ ResultsStream *AlpineApkBackend::search(const AbstractResourcesBackend::Filters
                 continue;
             }
 
-            if (resource->name().contains(filter.search, Qt::CaseInsensitive) || resource->comment().contains(filter.search, Qt::CaseInsensitive)) {
+            if (matchesSearch(resource, filter.search)) {
                 ret += resource;
             }
         }
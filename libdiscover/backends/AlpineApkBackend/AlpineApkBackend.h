@@ -14,7 +14,7 @@
 
 #include <QtApk>
 
-#include <AppStreamQt/component-box.h>
+#include "AlpineApkAppStreamIndex.h"
 
 class AlpineApkReviewsBackend;
 class AlpineApkUpdater;
@@ -56,16 +56,18 @@ public:
     void checkForUpdates() override;
     QString displayName() const override;
     bool hasApplications() const override;
+    bool hasCheapEnumeration() const override
+    {
+        // All packages are kept in memory
+        return true;
+    }
 
 public Q_SLOTS:
     void setFetchingUpdatesProgress(int percent);
 
 private Q_SLOTS:
     void finishCheckForUpdates();
-    void loadAppStreamComponents();
-    void parseAppStreamMetadata();
     void reloadAppStreamMetadata();
-    void fillResourcesAndApplyAppStreamData();
     void loadResources();
     void onLoadResourcesFinished();
     void onAppstreamDataDownloaded();
@@ -77,6 +79,11 @@ public:
     }
 
 private:
+    static AlpineApkAppStreamIndex loadAppStreamIndex();
+    static QHash<QString, AppStream::Component> matchAppStreamData(const QVector<QtApk::Package> &packages, const AlpineApkAppStreamIndex &index);
+    void createResources();
+    void applyAppStreamData(const QHash<QString, AppStream::Component> &changed);
+
     QHash<QString, AlpineApkResource *> m_resources;
     QHash<QString, AppStream::Component> m_resourcesAppstreamData;
     AlpineApkUpdater *m_updater;
@@ -87,7 +94,6 @@ private:
     bool m_fetching = false;
     int m_fetchProgress = 0;
     QTimer *m_updatesTimeoutTimer;
-    AppStream::ComponentBox m_appStreamComponents;
     // QVector<QString> m_collectedCategories;
     QFutureWatcher<void> m_voidFutureWatcher;
     AppstreamDataDownloader *m_appstreamDownloader;
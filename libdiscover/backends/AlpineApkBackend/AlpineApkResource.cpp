@@ -218,6 +218,14 @@ QString AlpineApkResource::appstreamId() const
     return QString();
 }
 
+QStringList AlpineApkResource::keywords() const
+{
+    if (hasAppStreamData()) {
+        return m_appsC.keywords();
+    }
+    return {};
+}
+
 void AlpineApkResource::setState(AbstractResource::State state)
 {
     m_state = state;
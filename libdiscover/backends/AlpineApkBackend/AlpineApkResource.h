@@ -47,6 +47,7 @@ public:
     void fetchChangelog() override;
     void fetchScreenshots() override;
     QString appstreamId() const override;
+    QStringList keywords() const override;
     QUrl url() const override;
     QString author() const override;
     QString sourceIcon() const override;
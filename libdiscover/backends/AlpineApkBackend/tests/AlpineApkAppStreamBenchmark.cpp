@@ -0,0 +1,137 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "AlpineApkAppStreamIndex.h"
+
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+struct Corpus {
+    QStringList packages;
+    QList<AppStream::Component> components;
+};
+
+// Roughly what Alpine edge looks like: one package in five has a component,
+// and some components are shared by several packages
+static Corpus makeCorpus(int packagesCount)
+{
+    Corpus ret;
+    for (int i = 0; i < packagesCount; ++i) {
+        ret.packages += u"pkg-%1"_s.arg(i);
+    }
+    ret.packages += u"kate"_s;
+
+    for (int i = 0; i < packagesCount; i += 5) {
+        AppStream::Component component;
+        component.setId(u"org.example.pkg%1"_s.arg(i));
+        component.setKind(AppStream::Component::KindDesktopApp);
+        QStringList packageNames = {u"pkg-%1"_s.arg(i)};
+        if (i % 20 == 0 && i + 1 < packagesCount) {
+            packageNames += u"pkg-%1"_s.arg(i + 1);
+        }
+        component.setPackageNames(packageNames);
+        ret.components += component;
+    }
+
+    // Kate Sessions comes first and names kate as well
+    AppStream::Component sessions;
+    sessions.setId(u"org.kde.plasma.katesessions"_s);
+    sessions.setPackageNames({u"kate"_s});
+    ret.components.insert(ret.components.size() / 2, sessions);
+    AppStream::Component kate;
+    kate.setId(u"org.kde.kate"_s);
+    kate.setPackageNames({u"kate"_s});
+    ret.components += kate;
+    return ret;
+}
+
+// How packages used to be matched, going through every component for each of them
+static AppStream::Component scanComponents(const QList<AppStream::Component> &components, const QString &packageName)
+{
+    for (const auto &component : components) {
+        if (component.packageNames().contains(packageName)) {
+            if (packageName == QLatin1String("kate") && component.id() != QLatin1String("org.kde.kate")) {
+                continue;
+            }
+            return component;
+        }
+    }
+    return {};
+}
+
+static AlpineApkAppStreamIndex makeIndex(const QList<AppStream::Component> &components)
+{
+    AlpineApkAppStreamIndex index;
+    for (const auto &component : components) {
+        index.add(component);
+    }
+    return index;
+}
+
+class AlpineApkAppStreamBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSameMatches()
+    {
+        const Corpus corpus = makeCorpus(2000);
+        const AlpineApkAppStreamIndex index = makeIndex(corpus.components);
+        for (const QString &package : corpus.packages) {
+            QCOMPARE(index.component(package).id(), scanComponents(corpus.components, package).id());
+        }
+        QCOMPARE(index.component(u"kate"_s).id(), u"org.kde.kate"_s);
+    }
+
+    void benchmarkScan_data()
+    {
+        corpusSizes();
+    }
+    void benchmarkScan()
+    {
+        QFETCH(int, packagesCount);
+        const Corpus corpus = makeCorpus(packagesCount);
+        int matched = 0;
+        QBENCHMARK_ONCE {
+            for (const QString &package : corpus.packages) {
+                matched += !scanComponents(corpus.components, package).id().isEmpty();
+            }
+        }
+        QVERIFY(matched > 0);
+    }
+
+    void benchmarkIndex_data()
+    {
+        corpusSizes();
+    }
+    void benchmarkIndex()
+    {
+        QFETCH(int, packagesCount);
+        const Corpus corpus = makeCorpus(packagesCount);
+        int matched = 0;
+        QBENCHMARK {
+            const AlpineApkAppStreamIndex index = makeIndex(corpus.components);
+            for (const QString &package : corpus.packages) {
+                matched += !index.component(package).id().isEmpty();
+            }
+        }
+        QVERIFY(matched > 0);
+    }
+
+private:
+    void corpusSizes()
+    {
+        QTest::addColumn<int>("packagesCount");
+        QTest::newRow("2k packages") << 2000;
+        QTest::newRow("20k packages") << 20000;
+    }
+};
+
+QTEST_GUILESS_MAIN(AlpineApkAppStreamBenchmark)
+
+#include "AlpineApkAppStreamBenchmark.moc"
@@ -50,7 +50,7 @@ DummyBackend::DummyBackend(QObject *parent)
     , m_updater(new StandardBackendUpdater(this))
     , m_reviews(new DummyReviewsBackend(this))
     , m_fetching(true)
-    , m_startElements(120)
+    , m_startElements(qEnvironmentVariableIsSet("DISCOVER_DUMMY_START_ELEMENTS") ? qEnvironmentVariableIntValue("DISCOVER_DUMMY_START_ELEMENTS") : 120)
 {
     auto initializationJob = new DummyBackendInitializationJob(this);
     initializationJob->start();
@@ -136,9 +136,21 @@ ResultsStream *DummyBackend::search(const AbstractResourcesBackend::Filters &fil
             if (r->state() < filter.state)
                 continue;
 
-            if (r->name().contains(filter.search, Qt::CaseInsensitive) || r->comment().contains(filter.search, Qt::CaseInsensitive))
+            if (matchesSearch(r, filter.search))
                 ret += r;
         }
+
+    if (m_searchBatchSize > 0 && ret.size() > m_searchBatchSize) {
+        // Deliver the results in several batches, like the backends that query their sources incrementally
+        auto stream = new ResultsStream(QStringLiteral("DummyStream-batched"));
+        QTimer::singleShot(0, stream, [stream, ret, batchSize = m_searchBatchSize]() {
+            for (qsizetype i = 0; i < ret.size(); i += batchSize) {
+                Q_EMIT stream->resourcesFound(ret.mid(i, batchSize));
+            }
+            stream->finish();
+        });
+        return stream;
+    }
     return new ResultsStream(QStringLiteral("DummyStream"), ret);
 }
 
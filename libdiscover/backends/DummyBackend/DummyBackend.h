@@ -16,6 +16,7 @@ class DummyBackend : public AbstractResourcesBackend
 {
     Q_OBJECT
     Q_PROPERTY(int startElements MEMBER m_startElements)
+    Q_PROPERTY(int searchBatchSize MEMBER m_searchBatchSize)
 public:
     explicit DummyBackend(QObject *parent = nullptr);
 
@@ -39,6 +40,14 @@ public:
     void checkForUpdates() override;
     QString displayName() const override;
     bool hasApplications() const override;
+    bool hasTextualSearch() const override
+    {
+        return true;
+    }
+    bool hasCheapEnumeration() const override
+    {
+        return true;
+    }
     InlineMessage *explainDysfunction() const override;
 
     int fetchingUpdatesProgress() const override
@@ -57,4 +66,5 @@ private:
     DummyReviewsBackend *m_reviews;
     bool m_fetching;
     int m_startElements;
+    int m_searchBatchSize = 0;
 };
@@ -17,7 +17,9 @@
 #include <resources/ResourcesModel.h>
 #include <resources/ResourcesProxyModel.h>
 #include <resources/ResourcesUpdatesModel.h>
+#include <resources/SearchIndex.h>
 
+#include <QElapsedTimer>
 #include <QSignalSpy>
 #include <QStandardPaths>
 #include <QTest>
@@ -284,6 +286,62 @@ void DummyTest::testScreenshotsModel()
     }
 }
 
+void DummyTest::testSearchIndex()
+{
+    AbstractResourcesBackend::Filters filter;
+    filter.search = QStringLiteral("addon1");
+    const auto fromBackend = fetchResources(m_appBackend->search(filter));
+    QVERIFY(!fromBackend.isEmpty());
+
+    // The first search starts indexing the backend, later ones are answered by the index
+    QSignalSpy indexedSpy(m_model->searchIndex(), &SearchIndex::indexed);
+    fetchResources(m_model->search(filter));
+    QVERIFY(indexedSpy.count() || indexedSpy.wait());
+    QVERIFY(m_model->searchIndex()->isIndexed(m_appBackend));
+    const auto fromIndex = fetchResources(m_model->search(filter));
+    QCOMPARE(QSet(fromIndex.constBegin(), fromIndex.constEnd()), QSet(fromBackend.constBegin(), fromBackend.constEnd()));
+}
+
+void DummyTest::testAggregatedBatches()
+{
+    const auto resources = fetchResources(m_appBackend->search({}));
+    QVERIFY(resources.size() > 10);
+
+    auto stream = new AggregatedResultsStream({new ResultsStream(QStringLiteral("twice"), resources + resources)});
+    stream->setMaxBatchSize(10);
+    const auto frameBudget = stream->frameBudget();
+    QVector<qsizetype> batchSizes;
+    QVector<qint64> emittedAt;
+    QElapsedTimer clock;
+    clock.start();
+    connect(stream, &ResultsStream::resourcesFound, this, [&batchSizes, &emittedAt, &clock](const QVector<StreamResult> &results) {
+        batchSizes += results.size();
+        emittedAt += clock.nsecsElapsed();
+    });
+    AggregatedResultsStream::Metrics metrics;
+    connect(stream, &AggregatedResultsStream::finished, this, [&metrics, stream] {
+        metrics = stream->metrics();
+    });
+
+    // Pending duplicates are dropped and no batch goes over the limit
+    QCOMPARE(fetchResources(stream).size(), resources.size());
+    QCOMPARE(batchSizes.size(), (resources.size() + 9) / 10);
+    QVERIFY(std::all_of(batchSizes.cbegin(), batchSizes.cend(), [](qsizetype size) {
+        return size <= 10;
+    }));
+
+    QCOMPARE(metrics.batches, batchSizes.size());
+    QCOMPARE(metrics.results, resources.size());
+    QCOMPARE(metrics.largestBatch, qsizetype(10));
+    QVERIFY(metrics.timeToFirstBatch >= 0);
+    // Later batches wait for the next frame. The wait is computed in whole milliseconds
+    // and coarse timers may fire a little early, hence the margin.
+    const qint64 minimumGap = std::chrono::nanoseconds(frameBudget - std::chrono::milliseconds(2)).count();
+    for (qsizetype i = 1; i < emittedAt.size(); ++i) {
+        QVERIFY2(emittedAt[i] - emittedAt[i - 1] >= minimumGap, qPrintable(QStringLiteral("batch %1 came after %2ns").arg(i).arg(emittedAt[i] - emittedAt[i - 1])));
+    }
+}
+
 // TODO test cancel transaction
 
 #include "moc_DummyTest.cpp"
@@ -29,6 +29,8 @@ private Q_SLOTS:
     void testReviewsModel();
     void testUpdateModel();
     void testScreenshotsModel();
+    void testSearchIndex();
+    void testAggregatedBatches();
 
 private:
     AbstractResourcesBackend *m_appBackend;
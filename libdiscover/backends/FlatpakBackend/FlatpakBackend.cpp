@@ -9,6 +9,7 @@
 #include "FlatpakFetchDataJob.h"
 #include "FlatpakJobTransaction.h"
 #include "FlatpakRefreshAppstreamMetadataJob.h"
+#include "FlatpakRemoteRefFetcher.h"
 #include "FlatpakSourcesBackend.h"
 #include "libdiscover_backend_flatpak_debug.h"
 
@@ -231,15 +232,31 @@ public:
 
     AppStream::ComponentBox componentsByFlatpakId(const QString &ref)
     {
-        auto components = m_pool->componentsByBundleId(AppStream::Bundle::KindFlatpak, ref, false);
-        if (!components.result().isEmpty())
-            return components.result();
+        auto components = ownComponents(m_pool->componentsByBundleId(AppStream::Bundle::KindFlatpak, ref, false).result());
+        if (!components.isEmpty())
+            return components;
 
-        components = m_pool->componentsByProvided(AppStream::Provided::KindId, ref.section('/'_L1, 1, 1));
-        return components.result();
+        return ownComponents(m_pool->componentsByProvided(AppStream::Provided::KindId, ref.section('/'_L1, 1, 1)).result());
     }
 
-    std::unique_ptr<AppStream::ConcurrentPool> m_pool;
+    // When the pool is shared, it has the components of the other remotes too
+    bool ownsComponent(const AppStream::Component &component) const
+    {
+        return !m_sharedPool || component.origin() == name();
+    }
+
+    AppStream::ComponentBox ownComponents(AppStream::ComponentBox components) const
+    {
+        if (m_sharedPool) {
+            for (auto it = components.begin(); it != components.end();) {
+                it = ownsComponent(*it) ? std::next(it) : components.erase(it);
+            }
+        }
+        return components;
+    }
+
+    std::shared_ptr<AppStream::ConcurrentPool> m_pool;
+    bool m_sharedPool = false;
     QHash<FlatpakResource::Id, FlatpakResource *> m_resources;
 
 private:
@@ -337,6 +354,46 @@ static std::optional<AppStream::Metadata> metadataFromBytes(GBytes *appstreamGz,
     return metadata;
 }
 
+static int maxConcurrentPoolLoads()
+{
+    const int value = qEnvironmentVariableIntValue("DISCOVER_FLATPAK_MAX_POOL_LOADS");
+    if (value > 0) {
+        return value;
+    }
+    // Loading is mostly bound by the disk, many loads at once only make each of them slower
+    return std::max(2, QThread::idealThreadCount() / 2);
+}
+
+// Loads the catalogs of several remotes into one pool. Flatpak tags every
+// catalog with the same origin, so each component is given its remote's name.
+static AppStream::Pool *loadSharedCatalogs(const QMap<QString, QString> &catalogs, QThread *thread)
+{
+    auto pool = new AppStream::Pool;
+    pool->setLoadStdDataLocations(false);
+    if (!pool->load()) {
+        qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Could not open the shared AppStream metadata pool" << pool->lastError();
+        delete pool;
+        return nullptr;
+    }
+
+    for (auto it = catalogs.cbegin(); it != catalogs.cend(); ++it) {
+        AppStream::Metadata metadata;
+        metadata.setFormatStyle(AppStream::Metadata::FormatStyleCatalog);
+        const auto error = metadata.parseFile(it.value() + "/appstream.xml"_L1, AppStream::Metadata::FormatKindXml);
+        if (error != AppStream::Metadata::MetadataErrorNoError) {
+            qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Could not read the catalog of" << it.key() << metadata.lastError();
+            continue;
+        }
+        auto components = metadata.components();
+        for (auto component : components) {
+            component.setOrigin(it.key());
+        }
+        pool->addComponents(components);
+    }
+    pool->moveToThread(thread);
+    return pool;
+}
+
 FlatpakBackend::FlatpakBackend(QObject *parent)
     : AbstractResourcesBackend(parent)
     , m_updater(new StandardBackendUpdater(this))
@@ -344,6 +401,9 @@ FlatpakBackend::FlatpakBackend(QObject *parent)
     , m_cancellable(g_cancellable_new())
     , m_checkForUpdatesTimer(new QTimer(this))
     , m_collector(new Utils::ProgressCollector(this))
+    , m_remoteRefs(new FlatpakRemoteRefFetcher(&m_threadPool, m_cancellable, this))
+    , m_maxConcurrentPoolLoads(maxConcurrentPoolLoads())
+    , m_unifiedPools(qEnvironmentVariableIntValue("DISCOVER_FLATPAK_UNIFIED_POOL") > 0)
 {
     g_autoptr(GError) error = nullptr;
 
@@ -355,6 +415,9 @@ FlatpakBackend::FlatpakBackend(QObject *parent)
         qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to setup flatpak installations:" << error->message;
     } else {
         m_sources = new FlatpakSourcesBackend(m_installations, this);
+        for (auto installation : std::as_const(m_installations)) {
+            watchInstalledRefs(installation);
+        }
         loadAppsFromAppstreamData();
 
         SourcesModel::global()->addSourcesBackend(m_sources);
@@ -386,6 +449,15 @@ FlatpakBackend::~FlatpakBackend()
     }
     m_threadPool.clear();
 
+    for (const auto &installedRefs : std::as_const(m_installedRefs)) {
+        if (installedRefs.monitor) {
+            g_signal_handlers_disconnect_by_data(installedRefs.monitor, this);
+            g_object_unref(installedRefs.monitor);
+        }
+    }
+    m_installedRefs.clear();
+    qDeleteAll(m_pendingPoolLoads);
+
     for (auto installation : std::as_const(m_installations)) {
         g_object_unref(installation);
     }
@@ -470,23 +542,6 @@ private:
     const QUrl m_url;
 };
 
-FlatpakInstalledRef *FlatpakBackend::getInstalledRefForApp(const FlatpakResource *resource) const
-{
-    Q_ASSERT(resource->resourceType() != FlatpakResource::Source);
-    g_autoptr(GError) localError = nullptr;
-
-    const auto type = resource->resourceType() == FlatpakResource::DesktopApp ? FLATPAK_REF_KIND_APP : FLATPAK_REF_KIND_RUNTIME;
-
-    auto ref = flatpak_installation_get_installed_ref(resource->installation(),
-                                                      type,
-                                                      resource->flatpakName().toUtf8().constData(),
-                                                      resource->arch().toUtf8().constData(),
-                                                      resource->branch().toUtf8().constData(),
-                                                      m_cancellable,
-                                                      &localError);
-    return ref;
-}
-
 static QString refToBundleId(FlatpakRef *ref)
 {
     const auto typeAsString = flatpak_ref_get_kind(ref) == FLATPAK_REF_KIND_APP ? QLatin1String("app") : QLatin1String("runtime");
@@ -505,6 +560,127 @@ static QString refToBundleId(FlatpakRef *ref)
     return ret;
 }
 
+struct FlatpakBackend::InstalledRefsIndex {
+    explicit InstalledRefsIndex(GPtrArray *refs)
+        : refs(refs)
+    {
+        byRef.reserve(refs->len);
+        for (uint i = 0; i < refs->len; i++) {
+            auto ref = FLATPAK_INSTALLED_REF(g_ptr_array_index(refs, i));
+            byRef.insert(refToBundleId(FLATPAK_REF(ref)), ref);
+        }
+    }
+    ~InstalledRefsIndex()
+    {
+        g_ptr_array_unref(refs);
+    }
+    Q_DISABLE_COPY_MOVE(InstalledRefsIndex)
+
+    // Blocks, call it from the thread pool
+    static std::shared_ptr<const InstalledRefsIndex> list(FlatpakInstallation *installation, GCancellable *cancellable)
+    {
+        g_autoptr(GError) localError = nullptr;
+        GPtrArray *refs = flatpak_installation_list_installed_refs(installation, cancellable, &localError);
+        if (!refs) {
+            qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to list installed refs:" << localError->message;
+            return {};
+        }
+        return std::make_shared<const InstalledRefsIndex>(refs);
+    }
+
+    GPtrArray *const refs;
+    // Keyed by kind/name/arch/branch, owned by refs
+    QHash<QString, FlatpakInstalledRef *> byRef;
+};
+
+void FlatpakBackend::watchInstalledRefs(FlatpakInstallation *installation)
+{
+    g_autoptr(GError) localError = nullptr;
+    auto &installedRefs = m_installedRefs[installation];
+    installedRefs.monitor = flatpak_installation_create_monitor(installation, m_cancellable, &localError);
+    if (!installedRefs.monitor) {
+        // Without a monitor we wouldn't know when the list is outdated, so we ask every time
+        qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to monitor installation" << installation << localError->message;
+        return;
+    }
+    g_signal_connect(installedRefs.monitor, "changed", G_CALLBACK(&FlatpakBackend::installedRefsChanged), this);
+    listInstalledRefs(installation);
+}
+
+void FlatpakBackend::installedRefsChanged(GFileMonitor *monitor, GFile *child, GFile *otherFile, GFileMonitorEvent eventType, gpointer data)
+{
+    Q_UNUSED(child);
+    Q_UNUSED(otherFile);
+    Q_UNUSED(eventType);
+
+    auto backend = static_cast<FlatpakBackend *>(data);
+    for (auto it = backend->m_installedRefs.cbegin(), end = backend->m_installedRefs.cend(); it != end; ++it) {
+        if (it->monitor == monitor) {
+            backend->invalidateInstalledRefs(it.key());
+            return;
+        }
+    }
+}
+
+void FlatpakBackend::invalidateInstalledRefs(FlatpakInstallation *installation)
+{
+    auto it = m_installedRefs.find(installation);
+    if (it == m_installedRefs.end() || !it->monitor) {
+        return;
+    }
+    it->index.reset();
+    listInstalledRefs(installation);
+}
+
+void FlatpakBackend::listInstalledRefs(FlatpakInstallation *installation)
+{
+    auto &installedRefs = m_installedRefs[installation];
+    if (installedRefs.listing) {
+        installedRefs.stale = true;
+        return;
+    }
+    installedRefs.listing = true;
+    installedRefs.stale = false;
+
+    using Index = std::shared_ptr<const InstalledRefsIndex>;
+    auto fw = new QFutureWatcher<Index>(this);
+    connect(fw, &QFutureWatcher<Index>::finished, this, [this, installation, fw] {
+        fw->deleteLater();
+        auto &installedRefs = m_installedRefs[installation];
+        installedRefs.listing = false;
+        if (installedRefs.stale) {
+            // It changed while we were listing it
+            listInstalledRefs(installation);
+        } else if (!fw->isCanceled()) {
+            installedRefs.index = fw->result();
+        }
+    });
+    fw->setFuture(QtConcurrent::run(&m_threadPool, &InstalledRefsIndex::list, installation, m_cancellable));
+}
+
+FlatpakInstalledRef *FlatpakBackend::getInstalledRefForApp(const FlatpakResource *resource) const
+{
+    Q_ASSERT(resource->resourceType() != FlatpakResource::Source);
+
+    const auto installedRefs = m_installedRefs.constFind(resource->installation());
+    if (installedRefs != m_installedRefs.cend() && installedRefs->index) {
+        auto ref = installedRefs->index->byRef.value(resource->ref());
+        return ref ? FLATPAK_INSTALLED_REF(g_object_ref(ref)) : nullptr;
+    }
+
+    g_autoptr(GError) localError = nullptr;
+    const auto type = resource->resourceType() == FlatpakResource::DesktopApp ? FLATPAK_REF_KIND_APP : FLATPAK_REF_KIND_RUNTIME;
+
+    auto ref = flatpak_installation_get_installed_ref(resource->installation(),
+                                                      type,
+                                                      resource->flatpakName().toUtf8().constData(),
+                                                      resource->arch().toUtf8().constData(),
+                                                      resource->branch().toUtf8().constData(),
+                                                      m_cancellable,
+                                                      &localError);
+    return ref;
+}
+
 FlatpakResource *FlatpakBackend::getAppForInstalledRef(FlatpakInstallation *installation, FlatpakInstalledRef *ref, bool *freshResource) const
 {
     if (freshResource) {
@@ -1117,6 +1293,9 @@ void FlatpakBackend::unloadRemote(FlatpakInstallation *installation, FlatpakRemo
     for (auto it = m_flatpakSources.begin(); it != m_flatpakSources.end();) {
         if ((*it)->url() == copyAndFree(flatpak_remote_get_url(remote)) && (*it)->installation() == installation) {
             qCDebug(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "unloading remote" << (*it) << remote;
+            if ((*it)->m_sharedPool) {
+                removeFromSharedPool(*it);
+            }
             it = m_flatpakSources.erase(it);
         } else {
             ++it;
@@ -1147,6 +1326,11 @@ void FlatpakBackend::createPool(QSharedPointer<FlatpakSource> source)
         return;
     }
 
+    if (m_unifiedPools) {
+        addToSharedPool(source);
+        return;
+    }
+
     AppStream::Pool *pool = new AppStream::Pool;
     acquireFetching(true);
 
@@ -1154,6 +1338,12 @@ void FlatpakBackend::createPool(QSharedPointer<FlatpakSource> source)
     pool->addExtraDataLocation(appstreamDirPath, AppStream::Metadata::FormatStyleCatalog);
 
     const auto loadDone = [this, source, pool](bool result) {
+        if (const auto timer = m_runningPoolLoads.take(pool); timer.isValid()) {
+            const std::chrono::milliseconds loadTime(timer.elapsed());
+            qCDebug(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "loaded the pool of" << source->disambiguatedName() << "in" << loadTime;
+            startPoolLoads();
+        }
+
         source->m_pool.reset(new AppStream::ConcurrentPool);
         source->m_pool->reset(pool, &m_threadPool);
         m_flatpakLoadingSources.removeAll(source);
@@ -1176,7 +1366,89 @@ void FlatpakBackend::createPool(QSharedPointer<FlatpakSource> source)
             },
             Qt::QueuedConnection);
     });
-    pool->loadAsync();
+    m_pendingPoolLoads.enqueue(pool);
+    startPoolLoads();
+}
+
+void FlatpakBackend::startPoolLoads()
+{
+    // These pools are only wrapped in a ConcurrentPool once loaded, nothing queries them yet
+    while (!m_pendingPoolLoads.isEmpty() && m_runningPoolLoads.size() < m_maxConcurrentPoolLoads) {
+        auto pool = m_pendingPoolLoads.dequeue();
+        m_runningPoolLoads[pool].start();
+        pool->loadAsync();
+    }
+}
+
+void FlatpakBackend::addToSharedPool(const QSharedPointer<FlatpakSource> &source)
+{
+    acquireFetching(true);
+    source->m_sharedPool = true;
+
+    auto &shared = m_sharedPools[source->installation()];
+    // A remote that is added again replaces its catalog
+    shared.catalogs.insert(source->name(), source->appstreamDir());
+    shared.waiting += source;
+    loadSharedPool(source->installation());
+}
+
+void FlatpakBackend::loadSharedPool(FlatpakInstallation *installation)
+{
+    // The pool that's being queried is never loaded into, it's replaced by one that has all the catalogs
+    auto &shared = m_sharedPools[installation];
+    if (shared.isLoading) {
+        shared.stale = true;
+        return;
+    }
+    shared.isLoading = true;
+    shared.stale = false;
+    shared.loading += std::exchange(shared.waiting, {});
+
+    QElapsedTimer timer;
+    timer.start();
+    auto watcher = new QFutureWatcher<AppStream::Pool *>(this);
+    connect(watcher, &QFutureWatcher<AppStream::Pool *>::finished, this, [this, installation, watcher, timer] {
+        watcher->deleteLater();
+        qCDebug(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "loaded the shared pool in" << timer.elapsed() << "ms";
+        sharedPoolLoaded(installation, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&m_threadPool, &loadSharedCatalogs, shared.catalogs, thread()));
+}
+
+void FlatpakBackend::sharedPoolLoaded(FlatpakInstallation *installation, AppStream::Pool *pool)
+{
+    auto &shared = m_sharedPools[installation];
+    shared.isLoading = false;
+    const auto loaded = std::exchange(shared.loading, {});
+
+    if (pool) {
+        if (!shared.pool) {
+            shared.pool = std::make_shared<AppStream::ConcurrentPool>();
+        }
+        shared.pool->reset(pool, &m_threadPool);
+    }
+    if (shared.stale || !shared.waiting.isEmpty()) {
+        loadSharedPool(installation);
+    }
+
+    for (const auto &source : loaded) {
+        m_flatpakLoadingSources.removeAll(source);
+        if (pool) {
+            source->m_pool = shared.pool;
+            m_flatpakSources += source;
+        }
+        metadataRefreshed(source->remote());
+        acquireFetching(false);
+    }
+}
+
+void FlatpakBackend::removeFromSharedPool(const QSharedPointer<FlatpakSource> &source)
+{
+    const auto it = m_sharedPools.find(source->installation());
+    if (it == m_sharedPools.end() || !it->catalogs.remove(source->name())) {
+        return;
+    }
+    loadSharedPool(source->installation());
 }
 
 QSharedPointer<FlatpakSource> FlatpakBackend::integrateRemote(GLibHolder<FlatpakInstallation> flatpakInstallation, GLibHolder<FlatpakRemote> remote)
@@ -1308,15 +1580,11 @@ bool FlatpakBackend::updateAppMetadata(FlatpakResource *resource)
     if (QFile::exists(path)) {
         return updateAppMetadata(resource, path);
     } else {
-        auto fw = new QFutureWatcher<QByteArray>(this);
-        connect(fw, &QFutureWatcher<QByteArray>::finished, this, [this, resource, fw]() {
-            const auto metadata = fw->result();
-            if (!metadata.isEmpty()) {
-                onFetchMetadataFinished(resource, metadata);
+        m_remoteRefs->fetch(resource, [this, resource](const FlatpakRemoteRefInfo &info) {
+            if (!info.metadata.isEmpty()) {
+                onFetchMetadataFinished(resource, info.metadata);
             }
-            fw->deleteLater();
         });
-        fw->setFuture(QtConcurrent::run(&m_threadPool, &FlatpakRunnables::fetchMetadata, resource, m_cancellable));
 
         // Return false to indicate we cannot continue (right now used only in updateAppSize())
         return false;
@@ -1423,21 +1691,16 @@ bool FlatpakBackend::updateAppSizeFromRemote(FlatpakResource *resource)
             return true;
         }
 
-        auto futureWatcher = new QFutureWatcher<FlatpakRemoteRef *>(this);
-        connect(futureWatcher, &QFutureWatcher<FlatpakRemoteRef *>::finished, this, [this, resource, futureWatcher]() {
-            g_autoptr(FlatpakRemoteRef) remoteRef = futureWatcher->result();
-            if (remoteRef) {
-                onFetchSizeFinished(resource, flatpak_remote_ref_get_download_size(remoteRef), flatpak_remote_ref_get_installed_size(remoteRef));
+        resource->setPropertyState(FlatpakResource::DownloadSize, FlatpakResource::Fetching);
+        resource->setPropertyState(FlatpakResource::InstalledSize, FlatpakResource::Fetching);
+        m_remoteRefs->fetch(resource, [this, resource](const FlatpakRemoteRefInfo &info) {
+            if (info.found) {
+                onFetchSizeFinished(resource, info.downloadSize, info.installedSize);
             } else {
                 resource->setPropertyState(FlatpakResource::DownloadSize, FlatpakResource::UnknownOrFailed);
                 resource->setPropertyState(FlatpakResource::InstalledSize, FlatpakResource::UnknownOrFailed);
             }
-            futureWatcher->deleteLater();
         });
-        resource->setPropertyState(FlatpakResource::DownloadSize, FlatpakResource::Fetching);
-        resource->setPropertyState(FlatpakResource::InstalledSize, FlatpakResource::Fetching);
-
-        futureWatcher->setFuture(QtConcurrent::run(&m_threadPool, &FlatpakRunnables::findRemoteRef, resource, m_cancellable));
     }
 
     return true;
@@ -1478,6 +1741,9 @@ void FlatpakBackend::acquireFetching(bool f)
         m_isFetching--;
     }
 
+    if (!f) {
+        Q_EMIT loadingProgressed();
+    }
     if (!f && m_isFetching == 0) {
         Q_EMIT contentsChanged();
         Q_EMIT initialized();
@@ -1515,16 +1781,17 @@ bool FlatpakBackend::flatpakResourceLessThan(AbstractResource *left, AbstractRes
     return left < right;
 }
 
-ResultsStream *FlatpakBackend::deferredResultStream(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback)
+ResultsStream *
+FlatpakBackend::deferredResultStream(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback, bool waitForInitialization)
 {
     ResultsStream *stream = new ResultsStream(streamName);
     stream->setParent(this);
 
     // Don't capture variables into a coroutine lambda, pass them in as arguments instead
     // See https://devblogs.microsoft.com/oldnewthing/20211103-00/?p=105870
-    [](FlatpakBackend *self, ResultsStream *stream, std::function<QCoro::Task<>(ResultsStream *)> callback) -> QCoro::Task<> {
+    [](FlatpakBackend *self, ResultsStream *stream, std::function<QCoro::Task<>(ResultsStream *)> callback, bool waitForInitialization) -> QCoro::Task<> {
         QPointer<ResultsStream> guard = stream;
-        if (self->m_isFetching > 0) {
+        if (waitForInitialization && self->m_isFetching > 0) {
             co_await qCoro(self, &FlatpakBackend::initialized);
         } else {
             co_await QCoro::sleepFor(0ms);
@@ -1537,33 +1804,7 @@ ResultsStream *FlatpakBackend::deferredResultStream(const QString &streamName, s
             co_return;
         }
         stream->finish();
-    }(this, stream, std::move(callback));
-
-    return stream;
-}
-
-ResultsStream *FlatpakBackend::deferredResultStreamNoFinish(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback)
-{
-    ResultsStream *stream = new ResultsStream(streamName);
-    stream->setParent(this);
-
-    // Don't capture variables into a coroutine lambda, pass them in as arguments instead
-    // See https://devblogs.microsoft.com/oldnewthing/20211103-00/?p=105870
-    [](FlatpakBackend *self, ResultsStream *stream, std::function<QCoro::Task<>(ResultsStream *)> callback) -> QCoro::Task<> {
-        QPointer<ResultsStream> guard = stream;
-        if (self->m_isFetching > 0) {
-            co_await qCoro(self, &FlatpakBackend::initialized);
-        } else {
-            co_await QCoro::sleepFor(0ms);
-        }
-        if (guard.isNull()) {
-            co_return;
-        }
-        co_await callback(stream);
-        if (guard.isNull()) {
-            co_return;
-        }
-    }(this, stream, std::move(callback));
+    }(this, stream, std::move(callback), waitForInitialization);
 
     return stream;
 }
@@ -1587,41 +1828,155 @@ static bool isFlatpakSubRef(const QLatin1String &name)
     return name.endsWith(QLatin1String(".Debug")) || name.endsWith(QLatin1String(".Locale")) || name.endsWith(QLatin1String(".Docs"));
 }
 
-void triage(FlatpakResource *resource,
-            QVector<StreamResult> &prioritary,
-            QVector<StreamResult> &rest,
-            const AbstractResourcesBackend::Filters &filter,
-            bool filtered)
+enum class SearchMatch {
+    None,
+    Prioritary,
+    Rest,
+};
+
+/**
+ * What triage() needs to know about a component that has no FlatpakResource yet.
+ *
+ * Unlike FlatpakResource, it's a value that can be used from the thread pool.
+ */
+class ComponentCandidate
+{
+public:
+    ComponentCandidate(const AppStream::Component &component, QStringView bundleId, bool installed)
+        : m_component(component)
+        , m_bundleId(bundleId)
+        , m_installed(installed)
+    {
+    }
+
+    QString appstreamId() const
+    {
+        return m_component.id();
+    }
+
+    // Same as FlatpakResource::name()
+    QString name() const
+    {
+        QString name = m_component.name();
+        if (name.isEmpty()) {
+            // app/org.kde.name/arch/branch
+            name = m_bundleId.split('/'_L1).value(1).toString();
+        }
+        if (name.startsWith(QLatin1String("(Nightly) "))) {
+            return name.mid(10);
+        }
+        return name;
+    }
+
+    QString comment() const
+    {
+        return m_component.summary();
+    }
+
+    // Same as FlatpakResource::type() once updated from the bundle
+    AbstractResource::Type type() const
+    {
+        if (!m_bundleId.startsWith("runtime/"_L1)) {
+            return AbstractResource::Application;
+        }
+        return extends().isEmpty() ? AbstractResource::ApplicationSupport : AbstractResource::Addon;
+    }
+
+    AbstractResource::State state() const
+    {
+        return m_installed ? AbstractResource::Installed : AbstractResource::None;
+    }
+
+    QStringList extends() const
+    {
+        return m_component.extends();
+    }
+
+    QStringList mimetypes() const
+    {
+        return m_component.provided(AppStream::Provided::KindMimetype).items();
+    }
+
+private:
+    const AppStream::Component &m_component;
+    const QStringView m_bundleId;
+    const bool m_installed;
+};
+
+template<typename Candidate>
+static SearchMatch triage(Candidate &candidate, const AbstractResourcesBackend::Filters &filter, bool filtered)
 {
-    const bool matchById = resource->appstreamId().compare(filter.search, Qt::CaseInsensitive) == 0;
+    const bool matchById = candidate.appstreamId().compare(filter.search, Qt::CaseInsensitive) == 0;
     // Note: FlatpakResource can not have type == System
-    if (resource->type() == AbstractResource::ApplicationSupport && filter.state != AbstractResource::Upgradeable && !matchById) {
-        return;
+    if (candidate.type() == AbstractResource::ApplicationSupport && filter.state != AbstractResource::Upgradeable && !matchById) {
+        return SearchMatch::None;
     }
 
-    if (resource->state() < filter.state) {
-        return;
+    if (candidate.state() < filter.state) {
+        return SearchMatch::None;
     }
 
-    if (!filter.extends.isEmpty() && !resource->extends().contains(filter.extends)) {
-        return;
+    if (!filter.extends.isEmpty() && !candidate.extends().contains(filter.extends)) {
+        return SearchMatch::None;
     }
 
-    if (!filter.mimetype.isEmpty() && !resource->mimetypes().contains(filter.mimetype)) {
-        return;
+    if (!filter.mimetype.isEmpty() && !candidate.mimetypes().contains(filter.mimetype)) {
+        return SearchMatch::None;
     }
 
     if (filter.search.isEmpty() || matchById) {
-        rest += resource;
-    } else if (resource->name().contains(filter.search, Qt::CaseInsensitive)) {
-        prioritary += resource;
-    } else if (filtered || resource->comment().contains(filter.search, Qt::CaseInsensitive)) {
-        rest += resource;
+        return SearchMatch::Rest;
+    } else if (candidate.name().contains(filter.search, Qt::CaseInsensitive)) {
+        return SearchMatch::Prioritary;
+    } else if (filtered || candidate.comment().contains(filter.search, Qt::CaseInsensitive)) {
         // trust The search terms provided by appstream are relevant, this makes possible finding "gimp"
         // since the name() is "GNU Image Manipulation Program"
-    } else if (resource->appstreamId().contains(filter.search, Qt::CaseInsensitive)) {
-        rest += resource;
+        return SearchMatch::Rest;
+    } else if (candidate.appstreamId().contains(filter.search, Qt::CaseInsensitive)) {
+        return SearchMatch::Rest;
+    }
+    return SearchMatch::None;
+}
+
+// A search result sorted on the thread pool, before its FlatpakResource is created
+struct FlatpakSearchRecord {
+    // Only set if the resource existed already
+    QPointer<FlatpakResource> resource;
+    AppStream::Component component;
+    qsizetype source = -1;
+
+    // What flatpakResourceLessThan() looks at
+    bool prioritary = false;
+    bool installed = false;
+    QString origin;
+    int originIndex = 0;
+    int ratingPoints = 0;
+};
+
+// Tells which of the searched sources the components a pool returns belong to
+struct FlatpakPoolQuery {
+    FlatpakInstallation *installation = nullptr;
+    // The only source using the pool, or those sharing it by origin
+    qsizetype source = -1;
+    QHash<QString, qsizetype> sharedBy;
+};
+
+// How many resources are created before going back to the event loop
+static constexpr qsizetype s_searchPageSize = 100;
+
+// Prioritary results first, then the same order as FlatpakBackend::flatpakResourceLessThan()
+static bool searchRecordLessThan(const FlatpakSearchRecord &left, const FlatpakSearchRecord &right)
+{
+    if (left.prioritary != right.prioritary) {
+        return left.prioritary;
+    }
+    if (left.installed != right.installed) {
+        return left.installed;
     }
+    if (left.origin != right.origin) {
+        return left.originIndex < right.originIndex;
+    }
+    return left.ratingPoints > right.ratingPoints;
 }
 
 int FlatpakBackend::fetchingUpdatesProgress() const
@@ -1832,67 +2187,170 @@ ResultsStream *FlatpakBackend::search(const AbstractResourcesBackend::Filters &f
             }(this, stream, filter);
         });
     } else {
-        // Multithreading is nearly impossible for this stream, since child
-        // objects are created and interact with this backend object. So the
-        // task is split into hunks, interleaved by zero timers.
-        return deferredResultStreamNoFinish(u"FlatpakStream"_s, [this, filter](ResultsStream *stream) -> QCoro::Task<> {
-            return [](FlatpakBackend *self, ResultsStream *stream, const AbstractResourcesBackend::Filters filter) -> QCoro::Task<> {
-                FLATPAK_BACKEND_GUARD
-                const auto flatpakSources = self->m_flatpakSources;
-                QVector<StreamResult> prioritary, rest;
-                QMap<QSharedPointer<FlatpakSource>, QFuture<AppStream::ComponentBox>> futures;
-                QList<FlatpakResource *> unpooled;
-
-                for (const auto &source : flatpakSources) {
-                    if (source->m_pool) {
-                        if (!filter.search.isEmpty()) {
-                            futures.insert(source, source->m_pool->search(filter.search));
-                        } else if (filter.category) {
-                            futures.insert(source,
-                                           AppStreamUtils::componentsByCategoriesTask(source->m_pool.get(), filter.category, AppStream::Bundle::KindFlatpak));
-                        } else {
-                            futures.insert(source, source->m_pool->components());
-                        }
+        // Sources are searched as they are loaded, without waiting for the others
+        return deferredResultStream(
+            u"FlatpakStream"_s,
+            [this, filter](ResultsStream *stream) -> QCoro::Task<> {
+                return searchSources(stream, filter);
+            },
+            false);
+    }
+}
+
+// Resources are QObjects that interact with this backend, so they can only be created here.
+// Components are filtered and sorted as values on the thread pool instead, then only the
+// results get their resource, page by page.
+//
+// Every source is searched once it's loaded, while the others load. What each round finds
+// is merged with what was found before, so that the results are offered sorted as a whole.
+QCoro::Task<> FlatpakBackend::searchSources(ResultsStream *stream, AbstractResourcesBackend::Filters filter)
+{
+    auto self = this;
+    FLATPAK_BACKEND_GUARD
+    const auto ratings = self->m_reviews->ratings();
+    // What the records' source refers to. Holding the sources keeps a removed one from
+    // being mistaken for a new one.
+    QList<QSharedPointer<FlatpakSource>> searched;
+    QList<FlatpakSearchRecord> found;
+
+    while (true) {
+        FLATPAK_BACKEND_CHECK
+
+        const qsizetype firstSource = searched.size();
+        for (const auto &source : std::as_const(self->m_flatpakSources)) {
+            if (!searched.contains(source)) {
+                searched << source;
+            }
+        }
+        if (searched.size() == firstSource) {
+            if (self->m_isFetching == 0) {
+                break;
+            }
+            co_await qCoro(self, &FlatpakBackend::loadingProgressed);
+            continue;
+        }
+
+        QList<FlatpakPoolQuery> queries;
+        QHash<AppStream::ConcurrentPool *, qsizetype> queryForPool;
+        QList<QFuture<AppStream::ComponentBox>> futures;
+        QHash<FlatpakInstallation *, std::shared_ptr<const InstalledRefsIndex>> installedRefs;
+        QList<FlatpakSearchRecord> records;
+
+        for (qsizetype index = firstSource; index < searched.size(); ++index) {
+            const auto &source = searched[index];
+            if (source->m_pool) {
+                // A shared pool is only queried once for all the sources using it
+                auto queryIt = queryForPool.constFind(source->m_pool.get());
+                if (queryIt == queryForPool.cend()) {
+                    queryIt = queryForPool.insert(source->m_pool.get(), queries.size());
+                    queries.append({.installation = source->installation()});
+                    if (!filter.search.isEmpty()) {
+                        futures << source->m_pool->search(filter.search, stream);
+                    } else if (filter.category) {
+                        futures << AppStreamUtils::componentsByCategoriesTask(source->m_pool.get(), filter.category, AppStream::Bundle::KindFlatpak);
                     } else {
-                        unpooled += source->m_resources.values();
+                        futures << source->m_pool->components();
                     }
                 }
-                using QFS = QFutureWatcher<QList<QFuture<AppStream::ComponentBox>>>;
-                auto *fw = new QFS(stream);
-                fw->setFuture(QtFuture::whenAll(futures.begin(), futures.end()));
-                FLATPAK_BACKEND_YIELD
-                for (auto r : std::as_const(unpooled)) {
-                    triage(r, prioritary, rest, filter, false);
+                auto &query = queries[*queryIt];
+                if (source->m_sharedPool) {
+                    query.sharedBy.insert(source->name(), index);
+                } else {
+                    query.source = index;
                 }
-                connect(fw, &QFS::finished, stream, [self, futures, stream, _rest = rest, _prioritary = prioritary, filter, fw]() {
-                    QVector<StreamResult> rest(_rest), prioritary(_prioritary);
-                    for (const auto [source, future] : futures.asKeyValueRange()) {
-                        for (const auto &component : future.result()) {
-                            triage(self->resourceForComponent(component, source), prioritary, rest, filter, true);
-                        }
-                    }
-
-                    auto f = [self](auto left, auto right) {
-                        return self->flatpakResourceLessThan(left, right);
-                    };
+                installedRefs.insert(source->installation(), self->m_installedRefs.value(source->installation()).index);
+                continue;
+            }
 
-                    // Even sorting can not be performed in other thread, and it can take a while
-                    std::sort(rest.begin(), rest.end(), f);
-                    std::sort(prioritary.begin(), prioritary.end(), f);
+            for (auto resource : std::as_const(source->m_resources)) {
+                const auto match = triage(*resource, filter, false);
+                if (match == SearchMatch::None) {
+                    continue;
+                }
+                records.append({
+                    .resource = resource,
+                    .prioritary = match == SearchMatch::Prioritary,
+                    .installed = resource->isInstalled(),
+                    .origin = resource->origin(),
+                    .originIndex = self->m_sources->originIndex(resource->disambiguatedOrigin()),
+                    .ratingPoints = resource->rating().ratingPoints(),
+                });
+            }
+        }
+        const auto origins = kTransform<QStringList>(searched, [](const auto &source) {
+            return source->name();
+        });
+        const auto originIndexes = kTransform<QList<int>>(searched, [self](const auto &source) {
+            return self->m_sources->originIndex(source->disambiguatedName());
+        });
 
-                    QList<StreamResult> resources;
-                    resources.reserve(prioritary.size() + rest.size());
-                    resources.append(std::move(prioritary));
-                    resources.append(std::move(rest));
+        const auto boxes = co_await QtFuture::whenAll(futures.begin(), futures.end());
+        FLATPAK_BACKEND_CHECK
+
+        const auto filterAndSort = [boxes, queries, origins, originIndexes, installedRefs, ratings, filter, records, cancellable] {
+            auto snapshots = installedRefs;
+            auto ret = records;
+            for (qsizetype i = 0; i < boxes.size() && !g_cancellable_is_cancelled(cancellable); ++i) {
+                const auto &query = queries[i];
+                auto &installed = snapshots[query.installation];
+                if (!installed) {
+                    // The backend hasn't listed it yet, don't wait for it
+                    installed = InstalledRefsIndex::list(query.installation, cancellable);
+                }
 
-                    if (!resources.isEmpty()) {
-                        Q_EMIT stream->resourcesFound(resources);
+                for (const auto &component : boxes[i].result()) {
+                    const qsizetype source = query.sharedBy.isEmpty() ? query.source : query.sharedBy.value(component.origin(), -1);
+                    if (source < 0) {
+                        // From a source sharing the pool that isn't being searched now
+                        continue;
                     }
-                    stream->finish();
-                    fw->deleteLater();
-                });
-            }(this, stream, filter);
-        });
+                    const QString bundleId = component.bundle(AppStream::Bundle::KindFlatpak).id();
+                    const ComponentCandidate candidate(component, bundleId, installed && installed->byRef.contains(bundleId));
+                    const auto match = triage(candidate, filter, true);
+                    if (match == SearchMatch::None) {
+                        continue;
+                    }
+                    ret.append({
+                        .component = component,
+                        .source = source,
+                        .prioritary = match == SearchMatch::Prioritary,
+                        .installed = candidate.state() == AbstractResource::Installed,
+                        .origin = origins[source],
+                        .originIndex = originIndexes[source],
+                        .ratingPoints = ratings.rating(component.id()).ratingPoints(),
+                    });
+                }
+            }
+
+            std::stable_sort(ret.begin(), ret.end(), searchRecordLessThan);
+            return ret;
+        };
+        records = co_await QtConcurrent::run(&self->m_threadPool, filterAndSort);
+        FLATPAK_BACKEND_CHECK
+
+        const qsizetype middle = found.size();
+        found += records;
+        std::inplace_merge(found.begin(), found.begin() + middle, found.end(), searchRecordLessThan);
+    }
+
+    QVector<StreamResult> page;
+    for (const auto &record : std::as_const(found)) {
+        if (record.source >= 0) {
+            page += self->resourceForComponent(record.component, searched[record.source]);
+        } else if (record.resource) {
+            page += record.resource.data();
+        } else {
+            // Gone while the other sources were loading
+            continue;
+        }
+        if (page.size() == s_searchPageSize) {
+            Q_EMIT stream->resourcesFound(page);
+            page.clear();
+            FLATPAK_BACKEND_YIELD
+        }
+    }
+    if (!page.isEmpty()) {
+        Q_EMIT stream->resourcesFound(page);
     }
 }
 
@@ -1964,9 +2422,13 @@ ResultsStream *FlatpakBackend::findResourceByPackageName(const QUrl &url)
         } else {
             auto stream = new ResultsStream(QStringLiteral("FlatpakStream-AppStreamUrl"));
             auto f = [this, stream, appstreamIds] {
-                const auto pools = kTransform<QList<AppStream::ConcurrentPool *>>(m_flatpakSources, [](const auto &x) {
-                    return x->m_pool.get();
-                });
+                // Shared pools only need to be asked once
+                QList<AppStream::ConcurrentPool *> pools;
+                for (const auto &source : std::as_const(m_flatpakSources)) {
+                    if (!pools.contains(source->m_pool.get())) {
+                        pools << source->m_pool.get();
+                    }
+                }
                 AppStream::ConcurrentPool::componentsByNames(&m_threadPool, pools, appstreamIds)
                     .then(this, [this, stream](const QMap<AppStream::ConcurrentPool *, QList<AppStream::Component>> &componentsList) {
                         QList<StreamResult> resourcesFound;
@@ -1980,14 +2442,14 @@ ResultsStream *FlatpakBackend::findResourceByPackageName(const QUrl &url)
                             if (!pool) {
                                 continue;
                             }
-                            const auto sourceIt = std::ranges::find_if(m_flatpakSources, [pool](const QSharedPointer<FlatpakSource> &s) -> bool {
-                                return s->m_pool.get() == pool;
-                            });
-                            Q_ASSERT(sourceIt != m_flatpakSources.end());
-                            const QSharedPointer<FlatpakSource> source = *sourceIt;
-                            resourcesFound << kTransform<QVector<StreamResult>>(components, [this, source](const AppStream::Component &comp) -> StreamResult {
-                                return {resourceForComponent(comp, source), comp.sortScore()};
-                            });
+                            for (const auto &comp : components) {
+                                const auto sourceIt = std::ranges::find_if(m_flatpakSources, [pool, &comp](const QSharedPointer<FlatpakSource> &s) -> bool {
+                                    return s->m_pool.get() == pool && s->ownsComponent(comp);
+                                });
+                                if (sourceIt != m_flatpakSources.end()) {
+                                    resourcesFound.append(StreamResult(resourceForComponent(comp, *sourceIt), comp.sortScore()));
+                                }
+                            }
                         }
                         std::sort(resourcesFound.begin(), resourcesFound.end(), sorter);
                         for (auto result : resourcesFound) {
@@ -2198,6 +2660,14 @@ void FlatpakBackend::checkForRemoteUpdates(FlatpakInstallation *installation, Fl
     }
 
     auto job = new FlatpakRefreshAppstreamMetadataJob(installation, remote);
+    connect(job,
+            &FlatpakRefreshAppstreamMetadataJob::jobRefreshAppstreamMetadataFinished,
+            this,
+            [this](GLibHolder<FlatpakInstallation> installation, GLibHolder<FlatpakRemote> remote, bool changed) {
+                if (changed) {
+                    m_remoteRefs->invalidate(installation.get(), QString::fromUtf8(flatpak_remote_get_name(remote.get())));
+                }
+            });
     if (needsIntegration) {
         connect(job, &FlatpakRefreshAppstreamMetadataJob::jobRefreshAppstreamMetadataFinished, this, &FlatpakBackend::integrateRemote);
     }
@@ -9,6 +9,8 @@
 
 #include "FlatpakResource.h"
 
+#include <QElapsedTimer>
+#include <QQueue>
 #include <QSharedPointer>
 #include <QThreadPool>
 #include <QVariantList>
@@ -18,9 +20,12 @@
 
 #include <QCoroTask>
 
+#include <memory>
+
 #include "FlatpakRefreshAppstreamMetadataJob.h"
 #include "flatpak-helper.h"
 
+class FlatpakRemoteRefFetcher;
 class FlatpakSourcesBackend;
 class FlatpakSource;
 class StandardBackendUpdater;
@@ -28,6 +33,7 @@ class OdrsReviewsBackend;
 
 namespace AppStream
 {
+class ConcurrentPool;
 class Pool;
 }
 
@@ -80,6 +86,8 @@ public:
 
     bool updateAppSize(FlatpakResource *resource);
     FlatpakInstalledRef *getInstalledRefForApp(const FlatpakResource *resource) const;
+    /// Forgets which refs are installed in @p installation until they are listed again
+    void invalidateInstalledRefs(FlatpakInstallation *installation);
     void loadRemote(FlatpakInstallation *installation, FlatpakRemote *remote);
     void unloadRemote(FlatpakInstallation *installation, FlatpakRemote *remote);
 
@@ -106,10 +114,34 @@ private Q_SLOTS:
 
 Q_SIGNALS: // for tests
     void initialized();
+    /// Something we were fetching is done, e.g. a source finished loading
+    void loadingProgressed();
 
 private:
     friend class FlatpakSource;
 
+    struct InstalledRefsIndex;
+    struct InstalledRefs {
+        GFileMonitor *monitor = nullptr;
+        // Null until the installation is listed, and from every change until it's listed again
+        std::shared_ptr<const InstalledRefsIndex> index;
+        bool listing = false;
+        bool stale = false;
+    };
+    // With DISCOVER_FLATPAK_UNIFIED_POOL, the remotes of an installation share one pool
+    struct SharedPool {
+        // What gets queried, set once the first load is done
+        std::shared_ptr<AppStream::ConcurrentPool> pool;
+        // The catalog of each remote, by remote name
+        QMap<QString, QString> catalogs;
+        // Sources in the current load, and those that arrived after it started
+        QList<QSharedPointer<FlatpakSource>> loading;
+        QList<QSharedPointer<FlatpakSource>> waiting;
+        bool isLoading = false;
+        // Whether the catalogs changed during the current load
+        bool stale = false;
+    };
+
     void metadataRefreshed(FlatpakRemote *remote);
     bool flatpakResourceLessThan(const StreamResult &left, const StreamResult &right) const;
     bool flatpakResourceLessThan(AbstractResource *left, AbstractResource *right) const;
@@ -127,6 +159,9 @@ private:
     void loadLocalUpdates();
     void loadLocalUpdates(FlatpakInstallation *flatpakInstallation);
     bool setupFlatpakInstallations(GError **error);
+    void watchInstalledRefs(FlatpakInstallation *installation);
+    void listInstalledRefs(FlatpakInstallation *installation);
+    static void installedRefsChanged(GFileMonitor *monitor, GFile *child, GFile *otherFile, GFileMonitorEvent eventType, gpointer data);
     void updateAppInstalledMetadata(FlatpakInstalledRef *installedRef, FlatpakResource *resource);
     bool updateAppMetadata(FlatpakResource *resource);
     bool updateAppMetadata(FlatpakResource *resource, const QByteArray &data);
@@ -140,10 +175,15 @@ private:
     void acquireFetching(bool f);
     void checkForRemoteUpdates(FlatpakInstallation *flatpakInstallation, FlatpakRemote *remote);
     void createPool(QSharedPointer<FlatpakSource> source);
+    void startPoolLoads();
+    void addToSharedPool(const QSharedPointer<FlatpakSource> &source);
+    void loadSharedPool(FlatpakInstallation *installation);
+    void sharedPoolLoaded(FlatpakInstallation *installation, AppStream::Pool *pool);
+    void removeFromSharedPool(const QSharedPointer<FlatpakSource> &source);
     FlatpakRemote *installSource(FlatpakResource *resource);
 
-    ResultsStream *deferredResultStream(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback);
-    ResultsStream *deferredResultStreamNoFinish(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback);
+    ResultsStream *deferredResultStream(const QString &streamName, std::function<QCoro::Task<>(ResultsStream *)> callback, bool waitForInitialization = true);
+    QCoro::Task<> searchSources(ResultsStream *stream, AbstractResourcesBackend::Filters filter);
     // Returned Installation and Ref objects are g_object_ref'ed, caller is responsible for calling g_object_unref.
     QCoro::Task<QHash<FlatpakInstallation *, QList<FlatpakInstalledRef *>>> listInstalledRefsForUpdate();
 
@@ -155,6 +195,7 @@ private:
 
     GCancellable *m_cancellable;
     QVector<FlatpakInstallation *> m_installations;
+    QHash<FlatpakInstallation *, InstalledRefs> m_installedRefs;
     QThreadPool m_threadPool;
     QVector<QSharedPointer<FlatpakSource>> m_flatpakSources;
     QVector<QSharedPointer<FlatpakSource>> m_flatpakLoadingSources;
@@ -163,4 +204,12 @@ private:
 
     friend class Utils::ProgressCollector;
     Utils::ProgressCollector *const m_collector;
+    FlatpakRemoteRefFetcher *const m_remoteRefs;
+
+    // Pools wait here for one of the m_maxConcurrentPoolLoads slots
+    const int m_maxConcurrentPoolLoads;
+    QQueue<AppStream::Pool *> m_pendingPoolLoads;
+    QHash<AppStream::Pool *, QElapsedTimer> m_runningPoolLoads;
+    const bool m_unifiedPools;
+    QHash<FlatpakInstallation *, SharedPool> m_sharedPools;
 };
@@ -15,6 +15,9 @@
 #include <QDebug>
 #include <QScopeGuard>
 #include <QTimer>
+
+using namespace std::chrono_literals;
+
 namespace
 {
     struct InstallationContext {
@@ -119,9 +122,14 @@ private:
 FlatpakJobTransaction::FlatpakJobTransaction(FlatpakResource *app, Role role)
     : Transaction(app->backend(), app, role, {})
     , m_app(app)
+    , m_progressState(std::make_shared<FlatpakProgressState>())
 {
     setCancellable(true);
 
+    // About once per frame, there's no point in updating the UI more often than it's painted
+    m_sampler.setInterval(16ms);
+    connect(&m_sampler, &QTimer::timeout, this, &FlatpakJobTransaction::sampleProgress);
+
     setStatus(QueuedStatus);
     FlatpakTransactionsMerger::instance()->schedule(this);
 }
@@ -138,9 +146,32 @@ void FlatpakJobTransaction::cancel()
     }
 }
 
+void FlatpakJobTransaction::startSampling()
+{
+    m_sampler.start();
+}
+
+void FlatpakJobTransaction::sampleProgress()
+{
+    setProgress(m_progressState->progress.load(std::memory_order_relaxed));
+    setDownloadSpeed(m_progressState->speed.load(std::memory_order_relaxed));
+    const auto status = m_progressState->status.load(std::memory_order_relaxed);
+    if (status != QueuedStatus) {
+        setStatus(status);
+    }
+}
+
 void FlatpakJobTransaction::finishTransaction(bool cancelled, const QString &errorMessage, const FlatpakTransactionThread::Repositories &addedRepositories, bool success)
 {
-    if (static_cast<FlatpakBackend *>(m_app->backend())->getInstalledRefForApp(m_app)) {
+    // Whatever the thread left last, before the final status
+    m_sampler.stop();
+    sampleProgress();
+
+    auto backend = static_cast<FlatpakBackend *>(m_app->backend());
+    // Don't wait for the installation monitor to tell us what we just changed
+    backend->invalidateInstalledRefs(m_app->installation());
+    g_autoptr(FlatpakInstalledRef) ref = backend->getInstalledRefForApp(m_app);
+    if (ref) {
         m_app->setState(AbstractResource::Installed);
     } else {
         m_app->setState(AbstractResource::None);
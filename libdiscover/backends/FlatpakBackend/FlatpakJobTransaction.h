@@ -9,6 +9,7 @@
 
 #include "flatpak-helper.h"
 #include <QPointer>
+#include <QTimer>
 #include <Transaction/Transaction.h>
 
 #include <gio/gio.h>
@@ -32,6 +33,7 @@ public:
 
 public Q_SLOTS:
     void finishTransaction(bool cancelled, const QString &errorMessage, const FlatpakTransactionThread::Repositories &addedRepositories, bool success);
+    void startSampling();
 
 Q_SIGNALS:
     void repositoriesAdded(const FlatpakJobTransaction::Repositories &repositories);
@@ -39,4 +41,11 @@ Q_SIGNALS:
 public:
     QPointer<FlatpakResource> m_app;
     QPointer<FlatpakTransactionThread> m_thread;
+    // Written by m_thread, see FlatpakProgressState
+    const std::shared_ptr<FlatpakProgressState> m_progressState;
+
+private:
+    void sampleProgress();
+
+    QTimer m_sampler;
 };
@@ -0,0 +1,293 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "FlatpakRemoteRefFetcher.h"
+#include "FlatpakResource.h"
+#include "libdiscover_backend_flatpak_debug.h"
+
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+using namespace std::chrono_literals;
+
+struct FlatpakRemoteRefFetcher::Listing {
+    explicit Listing(GPtrArray *refs)
+        : refs(refs)
+    {
+        byRef.reserve(refs->len);
+        for (uint i = 0; i < refs->len; i++) {
+            auto ref = FLATPAK_REMOTE_REF(g_ptr_array_index(refs, i));
+            byRef.insert(QString::fromUtf8(flatpak_ref_format_ref_cached(FLATPAK_REF(ref))), ref);
+        }
+    }
+    ~Listing()
+    {
+        g_ptr_array_unref(refs);
+    }
+    Q_DISABLE_COPY_MOVE(Listing)
+
+    static std::shared_ptr<const Listing> list(FlatpakInstallation *installation, const QString &remote, GCancellable *cancellable)
+    {
+        g_autoptr(GError) localError = nullptr;
+        GPtrArray *refs =
+            flatpak_installation_list_remote_refs_sync_full(installation, remote.toUtf8().constData(), FLATPAK_QUERY_FLAGS_ONLY_CACHED, cancellable, &localError);
+        if (!refs) {
+            qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to list the refs in" << remote << localError->message;
+            return {};
+        }
+        return std::make_shared<const Listing>(refs);
+    }
+
+    GPtrArray *const refs;
+    // Keyed by kind/name/arch/branch, owned by refs
+    QHash<QString, FlatpakRemoteRef *> byRef;
+};
+
+struct FlatpakRemoteRefFetcher::Batch {
+    std::shared_ptr<const Listing> listing;
+    QHash<QString, FlatpakRemoteRefInfo> results;
+    // Refs to fetch on their own, what the listing knows about them is in results
+    QStringList toFetch;
+};
+
+static FlatpakRemoteRefInfo refInfo(FlatpakRemoteRef *remoteRef)
+{
+    FlatpakRemoteRefInfo info;
+    if (!remoteRef) {
+        return info;
+    }
+    info.found = true;
+    info.downloadSize = flatpak_remote_ref_get_download_size(remoteRef);
+    info.installedSize = flatpak_remote_ref_get_installed_size(remoteRef);
+    if (GBytes *metadata = flatpak_remote_ref_get_metadata(remoteRef)) {
+        gsize len = 0;
+        auto data = g_bytes_get_data(metadata, &len);
+        info.metadata = QByteArray(static_cast<const char *>(data), len);
+    }
+    return info;
+}
+
+static FlatpakRemoteRef *fetchRemoteRef(FlatpakInstallation *installation, const QString &remote, const QString &refString, GCancellable *cancellable)
+{
+    g_autoptr(GError) localError = nullptr;
+    g_autoptr(FlatpakRef) ref = flatpak_ref_parse(refString.toUtf8().constData(), &localError);
+    if (!ref) {
+        qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to parse ref" << refString << localError->message;
+        return nullptr;
+    }
+
+    auto ret = flatpak_installation_fetch_remote_ref_sync_full(installation,
+                                                               remote.toUtf8().constData(),
+                                                               flatpak_ref_get_kind(ref),
+                                                               flatpak_ref_get_name(ref),
+                                                               flatpak_ref_get_arch(ref),
+                                                               flatpak_ref_get_branch(ref),
+                                                               FLATPAK_QUERY_FLAGS_ONLY_CACHED,
+                                                               cancellable,
+                                                               &localError);
+    if (localError) {
+        qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Failed to find remote ref:" << localError->message;
+    }
+    return ret;
+}
+
+FlatpakRemoteRefFetcher::FlatpakRemoteRefFetcher(QThreadPool *threadPool, GCancellable *cancellable, QObject *parent)
+    : QObject(parent)
+    , m_threadPool(threadPool)
+    , m_cancellable(G_CANCELLABLE(g_object_ref(cancellable)))
+{
+    // Long enough to gather what a page of resources asks for
+    m_window.setInterval(50ms);
+    m_window.setSingleShot(true);
+    connect(&m_window, &QTimer::timeout, this, &FlatpakRemoteRefFetcher::flush);
+}
+
+FlatpakRemoteRefFetcher::~FlatpakRemoteRefFetcher()
+{
+    g_object_unref(m_cancellable);
+}
+
+void FlatpakRemoteRefFetcher::fetch(FlatpakResource *resource, const Callback &callback)
+{
+    const QString origin = resource->origin();
+    if (origin.isEmpty()) {
+        qCWarning(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Cannot look up" << resource->name() << "because of missing origin";
+        QMetaObject::invokeMethod(
+            resource,
+            [callback] {
+                callback({});
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    auto &remote = m_remotes[{resource->installation(), origin}];
+    const QString ref = resource->ref();
+    const auto result = remote.results.constFind(ref);
+    if (result != remote.results.cend()) {
+        QMetaObject::invokeMethod(
+            resource,
+            [callback, info = *result] {
+                callback(info);
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    remote.pending[ref].append({resource, callback});
+    if (!remote.fetching && !m_window.isActive()) {
+        m_window.start();
+    }
+}
+
+void FlatpakRemoteRefFetcher::invalidate(FlatpakInstallation *installation, const QString &remote)
+{
+    const auto it = m_remotes.find({installation, remote});
+    if (it == m_remotes.end()) {
+        return;
+    }
+    it->listing.reset();
+    it->results.clear();
+    it->stale = it->fetching;
+}
+
+void FlatpakRemoteRefFetcher::flush()
+{
+    for (auto it = m_remotes.cbegin(), end = m_remotes.cend(); it != end; ++it) {
+        if (!it->fetching && !it->pending.isEmpty()) {
+            fetchRemote(it.key());
+        }
+    }
+}
+
+void FlatpakRemoteRefFetcher::fetchRemote(const RemoteKey &key)
+{
+    auto &remote = m_remotes[key];
+    remote.fetching = true;
+    remote.stale = false;
+
+    const QStringList refs = remote.pending.keys();
+    auto fw = new QFutureWatcher<Batch>(this);
+    connect(fw, &QFutureWatcher<Batch>::finished, this, [this, key, fw, refs] {
+        fw->deleteLater();
+
+        // The lookup doesn't run when the thread pool is cleared, and stops early once cancelled
+        const bool canceled = fw->isCanceled();
+        const Batch batch = canceled ? Batch{} : fw->result();
+        if (auto &remote = m_remotes[key]; !canceled && !remote.stale) {
+            remote.listing = batch.listing;
+            for (auto it = batch.results.cbegin(), end = batch.results.cend(); it != end; ++it) {
+                if (!batch.toFetch.contains(it.key())) {
+                    remote.results.insert(it.key(), it.value());
+                }
+            }
+        }
+        // Every request gets an answer, refs the lookup didn't get to are reported as not found
+        for (const QString &ref : refs) {
+            if (!batch.toFetch.contains(ref)) {
+                answer(key, ref, batch.results.value(ref));
+            }
+        }
+
+        if (batch.toFetch.isEmpty()) {
+            fetchFinished(key);
+        } else {
+            fetchRefs(key, batch);
+        }
+    });
+    fw->setFuture(QtConcurrent::run(m_threadPool, &FlatpakRemoteRefFetcher::lookUp, key.first, key.second, remote.listing, refs, m_cancellable));
+}
+
+void FlatpakRemoteRefFetcher::fetchRefs(const RemoteKey &key, const Batch &batch)
+{
+    qCDebug(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Fetching" << batch.toFetch.size() << "refs the listing of" << key.second << "doesn't cover";
+
+    auto fw = new QFutureWatcher<RefResult>(this);
+    connect(fw, &QFutureWatcher<RefResult>::resultReadyAt, this, [this, key, fw, batch](int index) {
+        auto [ref, info] = fw->resultAt(index);
+        if (!info.found) {
+            info = batch.results.value(ref);
+        }
+        if (auto &remote = m_remotes[key]; !remote.stale) {
+            remote.results.insert(ref, info);
+        }
+        answer(key, ref, info);
+    });
+    connect(fw, &QFutureWatcher<RefResult>::finished, this, [this, key, fw, batch] {
+        fw->deleteLater();
+        // Once cancelled, the rest get what the listing knows
+        for (const QString &ref : batch.toFetch) {
+            if (m_remotes[key].pending.contains(ref)) {
+                answer(key, ref, batch.results.value(ref));
+            }
+        }
+        fetchFinished(key);
+    });
+
+    const auto installation = key.first;
+    const auto remote = key.second;
+    const auto cancellable = m_cancellable;
+    fw->setFuture(QtConcurrent::mapped(m_threadPool, batch.toFetch, [installation, remote, cancellable](const QString &ref) -> RefResult {
+        if (g_cancellable_is_cancelled(cancellable)) {
+            return {ref, {}};
+        }
+        g_autoptr(FlatpakRemoteRef) fetched = fetchRemoteRef(installation, remote, ref, cancellable);
+        return {ref, refInfo(fetched)};
+    }));
+}
+
+void FlatpakRemoteRefFetcher::fetchFinished(const RemoteKey &key)
+{
+    auto &remote = m_remotes[key];
+    remote.fetching = false;
+
+    // Refs that were asked for while we were busy
+    if (!remote.pending.isEmpty() && !m_window.isActive()) {
+        m_window.start();
+    }
+}
+
+void FlatpakRemoteRefFetcher::answer(const RemoteKey &key, const QString &ref, const FlatpakRemoteRefInfo &info)
+{
+    const auto requests = m_remotes[key].pending.take(ref);
+    for (const auto &request : requests) {
+        if (request.resource) {
+            request.callback(info);
+        }
+    }
+}
+
+FlatpakRemoteRefFetcher::Batch FlatpakRemoteRefFetcher::lookUp(FlatpakInstallation *installation,
+                                                               const QString &remote,
+                                                               std::shared_ptr<const Listing> listing,
+                                                               const QStringList &refs,
+                                                               GCancellable *cancellable)
+{
+    if (!listing) {
+        listing = Listing::list(installation, remote, cancellable);
+    }
+
+    Batch batch{listing, {}, {}};
+    batch.results.reserve(refs.size());
+    for (const QString &ref : refs) {
+        if (g_cancellable_is_cancelled(cancellable)) {
+            break;
+        }
+
+        FlatpakRemoteRef *remoteRef = listing ? listing->byRef.value(ref) : nullptr;
+        // Depending on the summary format, listings can lack the metadata. The ref is fetched
+        // on its own then, or if the listing failed altogether.
+        if (remoteRef ? !flatpak_remote_ref_get_metadata(remoteRef) : !listing) {
+            batch.toFetch += ref;
+        }
+        batch.results.insert(ref, refInfo(remoteRef));
+    }
+    return batch;
+}
+
+#include "moc_FlatpakRemoteRefFetcher.cpp"
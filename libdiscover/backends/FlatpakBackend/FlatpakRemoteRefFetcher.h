@@ -0,0 +1,99 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+#include <memory>
+
+#include "flatpak-helper.h"
+
+class FlatpakResource;
+class QThreadPool;
+
+/// What a remote knows about a ref
+struct FlatpakRemoteRefInfo {
+    bool found = false;
+    guint64 downloadSize = 0;
+    guint64 installedSize = 0;
+    QByteArray metadata;
+};
+
+/**
+ * \class FlatpakRemoteRefFetcher  FlatpakRemoteRefFetcher.h "FlatpakRemoteRefFetcher.h"
+ *
+ * \brief Looks resources up in their remote, in batches
+ *
+ * Requests made within a short window are grouped by remote and deduplicated
+ * by ref. Then every remote is listed once on the thread pool, from its locally
+ * cached summary, and what it answers is delivered right away. Refs the listing
+ * lacks the metadata of are then fetched on their own, concurrently. Listings
+ * and results are kept until the remote is refreshed, so that refs many
+ * resources ask about, like runtimes, are only looked up once.
+ */
+class FlatpakRemoteRefFetcher : public QObject
+{
+    Q_OBJECT
+public:
+    using Callback = std::function<void(const FlatpakRemoteRefInfo &info)>;
+
+    FlatpakRemoteRefFetcher(QThreadPool *threadPool, GCancellable *cancellable, QObject *parent = nullptr);
+    ~FlatpakRemoteRefFetcher() override;
+
+    /**
+     * Calls @p callback with what the origin of @p resource knows about it.
+     *
+     * The callback is always called later from the event loop, and never if
+     * @p resource is destroyed in the meantime. When the lookup can't be done,
+     * e.g. because it was cancelled, it gets an info that wasn't found.
+     */
+    void fetch(FlatpakResource *resource, const Callback &callback);
+
+    /// Forgets what we know about @p remote, e.g. because its metadata was refreshed
+    void invalidate(FlatpakInstallation *installation, const QString &remote);
+
+private:
+    struct Listing;
+    struct Batch;
+    struct Request {
+        QPointer<FlatpakResource> resource;
+        Callback callback;
+    };
+    struct RemoteRefs {
+        // Null until the remote is listed
+        std::shared_ptr<const Listing> listing;
+        QHash<QString, FlatpakRemoteRefInfo> results;
+        // Requests waiting for a lookup, by ref
+        QHash<QString, QList<Request>> pending;
+        bool fetching = false;
+        // Invalidated while fetching, what comes back can't be kept
+        bool stale = false;
+    };
+    using RemoteKey = std::pair<FlatpakInstallation *, QString>;
+    using RefResult = std::pair<QString, FlatpakRemoteRefInfo>;
+
+    void flush();
+    void fetchRemote(const RemoteKey &key);
+    void fetchRefs(const RemoteKey &key, const Batch &batch);
+    void fetchFinished(const RemoteKey &key);
+    void answer(const RemoteKey &key, const QString &ref, const FlatpakRemoteRefInfo &info);
+    static Batch lookUp(FlatpakInstallation *installation,
+                        const QString &remote,
+                        std::shared_ptr<const Listing> listing,
+                        const QStringList &refs,
+                        GCancellable *cancellable);
+
+    QThreadPool *const m_threadPool;
+    GCancellable *const m_cancellable;
+    QTimer m_window;
+    QHash<RemoteKey, RemoteRefs> m_remotes;
+};
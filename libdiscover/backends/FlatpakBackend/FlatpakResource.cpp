@@ -740,6 +740,11 @@ QStringList FlatpakResource::mimetypes() const
     return m_appdata.provided(AppStream::Provided::KindMimetype).items();
 }
 
+QStringList FlatpakResource::keywords() const
+{
+    return m_appdata.keywords();
+}
+
 QString FlatpakResource::versionString()
 {
     QString version;
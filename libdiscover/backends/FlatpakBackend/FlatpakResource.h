@@ -159,6 +159,7 @@ public:
     void fetchScreenshots() override;
     QSet<QString> alternativeAppstreamIds() const override;
     QStringList mimetypes() const override;
+    QStringList keywords() const override;
 
     void setBranch(const QString &branch);
     void setBundledIcon(const QPixmap &pixmap);
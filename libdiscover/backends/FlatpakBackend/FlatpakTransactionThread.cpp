@@ -41,23 +41,24 @@ void FlatpakTransactionThread::progress_changed_cb(FlatpakTransactionProgress *p
     auto obj = static_cast<FlatpakTransactionThread *>(user_data);
 
     if (flatpak_transaction_progress_get_is_estimating(progress)) {
-        Q_EMIT obj->statusChanged(Transaction::SetupStatus);
+        obj->setStatus(Transaction::SetupStatus);
         return;
     }
     // We do not know if downloading or installing, but downloading generally takes longer
-    Q_EMIT obj->statusChanged(Transaction::DownloadingStatus);
+    obj->setStatus(Transaction::DownloadingStatus);
 
-    g_autolist(GObject) ops = flatpak_transaction_get_operations(obj->m_transaction);
-    g_autoptr(FlatpakTransactionOperation) op = flatpak_transaction_get_current_operation(obj->m_transaction);
-    const int idx = g_list_index(ops, op);
-    obj->setProgress(qMin<int>(99, (100 * idx + flatpak_transaction_progress_get_progress(progress)) / g_list_length(ops)));
-
-#ifdef FLATPAK_VERBOSE_PROGRESS
-    guint64 start_time = flatpak_transaction_progress_get_start_time(progress);
-    guint64 elapsed_time = (g_get_monotonic_time() - start_time) / G_USEC_PER_SEC;
-    if (elapsed_time > 0) {
-        guint64 transferred = flatpak_transaction_progress_get_bytes_transferred(progress);
-        obj->setSpeed(transferred / elapsed_time);
+    obj->setProgress(qMin<int>(99, (100 * obj->m_operationIndex + flatpak_transaction_progress_get_progress(progress)) / obj->m_operationCount));
+
+#if FLATPAK_CHECK_VERSION(1, 1, 2)
+    // Measured over the last second rather than since the operation started, so that it follows the actual rate
+    const gint64 now = g_get_monotonic_time();
+    const guint64 transferred = flatpak_transaction_progress_get_bytes_transferred(progress);
+    if (now - obj->m_speedMarkTime >= G_USEC_PER_SEC) {
+        if (transferred >= obj->m_speedMarkBytes) {
+            obj->setSpeed((transferred - obj->m_speedMarkBytes) * G_USEC_PER_SEC / (now - obj->m_speedMarkTime));
+        }
+        obj->m_speedMarkTime = now;
+        obj->m_speedMarkBytes = transferred;
     }
 #endif
 }
@@ -71,6 +72,12 @@ void FlatpakTransactionThread::new_operation_cb(FlatpakTransaction * /*object*/,
 
     obj->setCurrentRef(flatpak_transaction_operation_get_ref(operation));
 
+    g_autolist(GObject) ops = flatpak_transaction_get_operations(obj->m_transaction);
+    obj->m_operationIndex = qMax(0, g_list_index(ops, operation));
+    obj->m_operationCount = qMax<int>(1, g_list_length(ops));
+    obj->m_speedMarkTime = g_get_monotonic_time();
+    obj->m_speedMarkBytes = 0;
+
     g_signal_connect(progress, "changed", G_CALLBACK(&FlatpakTransactionThread::progress_changed_cb), obj);
     flatpak_transaction_progress_set_update_frequency(progress, FLATPAK_CLI_UPDATE_FREQUENCY);
 }
@@ -372,17 +379,23 @@ void FlatpakTransactionThread::setProgress(int progress)
         return;
     }
 
-    if (m_progress != progress) {
-        m_progress = progress;
-        Q_EMIT progressChanged(m_progress);
+    m_progress = progress;
+    if (m_progressState) {
+        m_progressState->progress.store(progress, std::memory_order_relaxed);
     }
 }
 
 void FlatpakTransactionThread::setSpeed(quint64 speed)
 {
-    if (m_speed != speed) {
-        m_speed = speed;
-        Q_EMIT speedChanged(m_speed);
+    if (m_progressState) {
+        m_progressState->speed.store(speed, std::memory_order_relaxed);
+    }
+}
+
+void FlatpakTransactionThread::setStatus(Transaction::Status status)
+{
+    if (m_progressState) {
+        m_progressState->status.store(status, std::memory_order_relaxed);
     }
 }
 
@@ -496,6 +509,7 @@ bool FlatpakTransactionThread::end_of_lifed_with_rebase(const char *remote,
         if (correct) {
             auto job = m_jobTransactionsByRef.value(QLatin1String(ref));
             m_jobTransactionsByRef.insert(QLatin1String(rebased_to_ref), job);
+            m_progressStatesByRef.insert(QLatin1String(rebased_to_ref), m_progressStatesByRef.value(QLatin1String(ref)));
         }
 #else
         correct = flatpak_transaction_add_rebase(m_transaction, remote, rebased_to_ref, nullptr, previous_ids, &localError)
@@ -526,6 +540,7 @@ void FlatpakTransactionThread::addJobTransaction(FlatpakJobTransaction *jobTrans
     const QString ref = jobTransaction->m_app->ref();
     Q_ASSERT(!m_jobTransactionsByRef.contains(ref));
     m_jobTransactionsByRef.insert(ref, jobTransaction);
+    m_progressStatesByRef.insert(ref, jobTransaction->m_progressState);
 }
 
 void FlatpakTransactionThread::setCurrentRef(const char *ref_cstr)
@@ -558,18 +573,17 @@ void FlatpakTransactionThread::setCurrentRef(const char *ref_cstr)
     m_addedRepositories.clear();
     m_operationSuccess.reset();
     m_progress = 0;
-    m_speed = 0;
+    m_progressState = m_progressStatesByRef.value(ref);
 
     qCDebug(LIBDISCOVER_BACKEND_FLATPAK_LOG) << "Connecting to ref" << ref << job;
     m_currentJobTransaction = job;
     connect(this, &FlatpakTransactionThread::finished, job, &FlatpakJobTransaction::finishTransaction);
-    connect(this, &FlatpakTransactionThread::progressChanged, job, &FlatpakJobTransaction::setProgress);
-    connect(this, &FlatpakTransactionThread::speedChanged, job, &FlatpakJobTransaction::setDownloadSpeed);
+    connect(this, &FlatpakTransactionThread::jobStarted, job, &FlatpakJobTransaction::startSampling);
     connect(this, &FlatpakTransactionThread::passiveMessage, job, &FlatpakJobTransaction::passiveMessage);
     connect(this, &FlatpakTransactionThread::webflowStarted, job, &FlatpakJobTransaction::webflowStarted);
     connect(this, &FlatpakTransactionThread::webflowDone, job, &FlatpakJobTransaction::webflowDone);
     connect(this, &FlatpakTransactionThread::proceedRequest, job, &FlatpakJobTransaction::proceedRequest);
-    connect(this, &FlatpakTransactionThread::statusChanged, job, &FlatpakJobTransaction::setStatus);
+    Q_EMIT jobStarted();
 }
 
 void FlatpakTransactionThread::operationError(GError *error)
@@ -606,6 +620,8 @@ void FlatpakTransactionThread::finishAllJobTransactions()
             Qt::QueuedConnection);
     }
     m_jobTransactionsByRef.clear();
+    m_progressStatesByRef.clear();
+    m_progressState.reset();
 }
 
 int FlatpakTransactionThread::choose_remote_for_ref(const char *for_ref,
@@ -20,6 +20,9 @@
 #include <QWaitCondition>
 #include <Transaction/Transaction.h>
 
+#include <atomic>
+#include <memory>
+
 #include <QThreadPool>
 class FlatpakThreadPool : public QThreadPool
 {
@@ -42,6 +45,18 @@ private:
     }
 };
 
+/**
+ * Where the transaction thread leaves the progress of a job transaction.
+ *
+ * It's written on every libflatpak tick and read by the job at frame rate,
+ * so that ticks don't queue up as signals to the GUI thread.
+ */
+struct FlatpakProgressState {
+    std::atomic<int> progress = 0;
+    std::atomic<quint64> speed = 0;
+    std::atomic<Transaction::Status> status = Transaction::QueuedStatus;
+};
+
 class FlatpakJobTransaction;
 class FlatpakResource;
 class FlatpakTransactionThread : public QObject, public QRunnable
@@ -70,14 +85,13 @@ public:
     void proceed();
 
 Q_SIGNALS: // Signals vastly simplify our live with regards to threading since Qt schedules them into the correct thread
-    void progressChanged(int progress);
-    void speedChanged(quint64 speed);
+    /// The current job transaction starts, it's time to sample its FlatpakProgressState
+    void jobStarted();
     void passiveMessage(const QString &msg);
     void webflowStarted(const QUrl &url, int id);
     void webflowDone(int id);
     void finished(bool cancelled, const QString &errorMessage, const FlatpakTransactionThread::Repositories &addedRepositories, bool success);
     void proceedRequest(const QString &title, const QString &description);
-    void statusChanged(Transaction::Status status);
 
 private:
     static gboolean
@@ -86,6 +100,7 @@ private:
     static void
     new_operation_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation *operation, FlatpakTransactionProgress *progress, gpointer user_data);
     void fail(const char *refName, GError *error);
+    void setStatus(Transaction::Status status);
 
     QString errorMessage() const;
     bool cancelled() const;
@@ -102,7 +117,15 @@ private:
     GCancellable *m_cancellable;
     FlatpakTransaction *m_transaction = nullptr;
     int m_progress = 0;
-    quint64 m_speed = 0;
+    // Of the current job transaction, null until there's one
+    std::shared_ptr<FlatpakProgressState> m_progressState;
+    QHash<QString, std::shared_ptr<FlatpakProgressState>> m_progressStatesByRef;
+    // Where the current operation is in the transaction, looked up once per operation instead of on every tick
+    int m_operationIndex = 0;
+    int m_operationCount = 1;
+    // What was transferred when the speed was last measured
+    gint64 m_speedMarkTime = 0;
+    guint64 m_speedMarkBytes = 0;
     QString m_errorMessage;
     const Transaction::Role m_role;
     FlatpakInstallation *m_installation;
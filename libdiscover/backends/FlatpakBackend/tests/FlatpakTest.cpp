@@ -105,12 +105,42 @@ private Q_SLOTS:
 
         const auto ourResource = res.constFirst();
         QCOMPARE(ourResource->state(), AbstractResource::None);
-        QCOMPARE(waitTransaction(m_appBackend->installApplication(ourResource)), Transaction::DoneStatus);
+        auto install = m_appBackend->installApplication(ourResource);
+        QSignalSpy progressSpy(install, &Transaction::progressChanged);
+        QCOMPARE(waitTransaction(install), Transaction::DoneStatus);
         QCOMPARE(ourResource->state(), AbstractResource::Installed);
+        // Progress is sampled while the transaction runs
+        QVERIFY(!progressSpy.isEmpty());
+        for (const auto &arguments : std::as_const(progressSpy)) {
+            const int progress = arguments.constFirst().toInt();
+            QVERIFY(progress >= 0 && progress <= 100);
+        }
+
+        // Searches tell it's installed right away, not once the installation monitor notices
         f.resourceUrl = QUrl(QStringLiteral("flatpak:app/") + s_testId + u'/' + QLatin1StringView(flatpak_get_default_arch()) + QLatin1StringView("/stable"));
-        QCOMPARE(getResources(m_appBackend->search(f)).count(), 1);
+        const auto installed = getResources(m_appBackend->search(f));
+        QCOMPARE(installed.count(), 1);
+        QCOMPARE(installed.constFirst()->state(), AbstractResource::Installed);
+        AbstractResourcesBackend::Filters installedFilter;
+        installedFilter.state = AbstractResource::Installed;
+        QVERIFY(getResources(m_appBackend->search(installedFilter)).contains(ourResource));
+
         QCOMPARE(waitTransaction(m_appBackend->removeApplication(ourResource)), Transaction::DoneStatus);
         QCOMPARE(ourResource->state(), AbstractResource::None);
+        QVERIFY(!getResources(m_appBackend->search(installedFilter)).contains(ourResource));
+    }
+
+    void testRemoteSize()
+    {
+        AbstractResourcesBackend::Filters f;
+        f.resourceUrl = QUrl(QStringLiteral("appstream://") + s_testId);
+        const auto res = getResources(m_appBackend->search(f));
+        QCOMPARE(res.count(), 1);
+
+        // Looked up in the remote's listing, along with whatever else was asked for meanwhile
+        const auto resource = res.constFirst();
+        resource->sizeDescription();
+        QTRY_VERIFY_WITH_TIMEOUT(resource->size() > 0, 20000);
     }
 
     void testFlatpakref()
@@ -151,6 +181,70 @@ private Q_SLOTS:
         QVERIFY(m_appBackend->extends(res[0]->appstreamId()));
     }
 
+    void testSearchSorted()
+    {
+        // Results from all the sources come sorted as a whole: those matching by name first
+        AbstractResourcesBackend::Filters f;
+        f.search = QStringLiteral("gra");
+        const auto res = getResources(m_appBackend->search(f));
+        QVERIFY(!res.isEmpty());
+        QCOMPARE(QSet(res.constBegin(), res.constEnd()).count(), res.count());
+        bool byName = true;
+        for (auto resource : res) {
+            const bool nameMatches = resource->name().contains(f.search, Qt::CaseInsensitive);
+            QVERIFY2(byName || !nameMatches, qPrintable(resource->name()));
+            byName = nameMatches;
+        }
+    }
+
+    void testSearchOrigin()
+    {
+        // Every result comes from the remote that offers it, once, with or without a shared pool
+        AbstractResourcesBackend::Filters f;
+        f.search = QStringLiteral("GrafX2");
+        const auto res = getResources(m_appBackend->search(f));
+        QVERIFY(!res.isEmpty());
+        QCOMPARE(QSet(res.constBegin(), res.constEnd()).count(), res.count());
+        for (auto resource : res) {
+            QCOMPARE(resource->origin(), QStringLiteral("flathub"));
+        }
+    }
+
+    void testRemoveAndAddSource()
+    {
+        auto bk = qobject_cast<AbstractSourcesBackend *>(SourcesModel::global()->index(0, 0).data(SourcesModel::SourcesBackend).value<QObject *>());
+        QVERIFY(bk);
+        QString flathubId;
+        for (int i = 0, c = bk->sources()->rowCount(); i < c; ++i) {
+            const auto index = bk->sources()->index(i, 0);
+            if (index.data(AbstractSourcesBackend::IdRole) == QLatin1String("flathub")) {
+                flathubId = index.data(AbstractSourcesBackend::DisambiguatedIdRole).toString();
+            }
+        }
+        QVERIFY(!flathubId.isEmpty());
+
+        // Its components go away with it, along with what was installed from it
+        connect(bk, &AbstractSourcesBackend::proceedRequest, bk, &AbstractSourcesBackend::proceed);
+        bk->removeSource(flathubId);
+        AbstractResourcesBackend::Filters f;
+        f.search = QStringLiteral("GrafX2");
+        QTRY_VERIFY_WITH_TIMEOUT(getResources(m_appBackend->search(f)).isEmpty(), 20000);
+
+        // And are only there once when it's back
+        QSignalSpy spy(bk->sources(), &QAbstractItemModel::rowsInserted);
+        qobject_cast<DiscoverAction *>(bk->actions().constFirst().value<QObject *>())->trigger();
+        QVERIFY(spy.count() || spy.wait(200000));
+        // A search made while it loads waits for it instead of finishing empty
+        auto stream = m_appBackend->search(f);
+        QSignalSpy destroyedSpy(stream, &QObject::destroyed);
+        QSignalSpy foundSpy(stream, &ResultsStream::resourcesFound);
+        QVERIFY(destroyedSpy.wait(200000));
+        QVERIFY(!foundSpy.isEmpty());
+        f.search.clear();
+        f.resourceUrl = QUrl(QStringLiteral("appstream://") + s_testId);
+        QCOMPARE(getResources(m_appBackend->search(f)).count(), 1);
+    }
+
     /*
         void testCancelInstallation()
         {
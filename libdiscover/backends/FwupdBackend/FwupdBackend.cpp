@@ -11,6 +11,7 @@
 #include "FwupdSourcesBackend.h"
 #include "FwupdTransaction.h"
 #include <QtConcurrent/QtConcurrentRun>
+#include <utils.h>
 #include <Transaction/Transaction.h>
 #include <Transaction/TransactionModel.h>
 #include <resources/SourcesModel.h>
@@ -31,6 +32,8 @@ FwupdBackend::FwupdBackend(QObject *parent)
     , m_updater(new StandardBackendUpdater(this))
     , m_cancellable(g_cancellable_new())
 {
+    m_threadPool.setMaxThreadCount(2);
+
     auto init = [this] {
         g_autoptr(GError) error = nullptr;
         if (!fwupd_client_connect(client, m_cancellable, &error)) {
@@ -70,6 +73,7 @@ QMap<GChecksumType, QCryptographicHash::Algorithm> FwupdBackend::gchecksumToQChr
 FwupdBackend::~FwupdBackend()
 {
     g_cancellable_cancel(m_cancellable);
+    m_threadPool.waitForDone();
     g_object_unref(m_cancellable);
 
     g_object_unref(client);
@@ -101,74 +105,101 @@ FwupdResource *FwupdBackend::createRelease(FwupdDevice *device)
     return res;
 }
 
-void FwupdBackend::addUpdates()
+static bool isUpgradable(FwupdDevice *device)
 {
-    g_autoptr(GError) error = nullptr;
-    g_autoptr(GPtrArray) devices = fwupd_client_get_devices(client, m_cancellable, &error);
+    return fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_SUPPORTED) && !fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_LOCKED)
+        && fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+}
 
-    if (!devices) {
-        if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO))
-            qDebug() << "Fwupd Info: No Devices Found";
-        else
+void FwupdBackend::setUpgrades(FwupdDevice *device, GPtrArray *rels, GError *error)
+{
+    if (!rels) {
+        if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+            qWarning() << "fwupd: Device not supported:" << fwupd_device_get_name(device);
+        } else if (!g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO)) {
             handleError(error);
+        }
+        resolveDevice(m_resources.value(QString::fromUtf8(fwupd_device_get_name(device))));
         return;
     }
 
-    for (uint i = 0; i < devices->len && !g_cancellable_is_cancelled(m_cancellable); i++) {
-        FwupdDevice *device = (FwupdDevice *)g_ptr_array_index(devices, i);
+    if ((fwupd_device_get_flags(device) & FWUPD_DEVICE_FLAG_NEEDS_REBOOT) && fwupd_device_get_update_state(device) == FWUPD_UPDATE_STATE_SUCCESS) {
+        m_updater->setNeedsReboot(true);
+        resolveDevice(m_resources.value(QString::fromUtf8(fwupd_device_get_name(device))));
+        return;
+    }
 
-        if (!fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_SUPPORTED))
-            continue;
+    fwupd_device_add_release(device, (FwupdRelease *)g_ptr_array_index(rels, 0));
+    auto res = createApp(device);
+    if (!res) {
+        qWarning() << "Fwupd Error: Cannot Create App From Device" << fwupd_device_get_name(device);
+        resolveDevice(m_resources.value(QString::fromUtf8(fwupd_device_get_name(device))));
+        return;
+    }
 
-        if (fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_LOCKED))
+    QString longdescription;
+    for (uint j = 0; j < rels->len; j++) {
+        FwupdRelease *release = (FwupdRelease *)g_ptr_array_index(rels, j);
+        if (!fwupd_release_get_description(release))
             continue;
+        if (rels->len > 1) {
+            longdescription += QStringLiteral("Version %1\n").arg(QString::fromUtf8(fwupd_release_get_version(release)));
+        }
+        longdescription += QString::fromUtf8(fwupd_release_get_description(release));
+        if (rels->len > 1) {
+            longdescription += QLatin1Char('\n');
+        }
+    }
+    res->setDescription(longdescription);
 
-        if (!fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE))
-            continue;
+    // Make sure to set the installed version of the current thing so
+    // they can both be shown in the update page UI
+    auto installedResource = m_resources.value(res->packageName());
+    if (installedResource) {
+        res->setInstalledVersion(installedResource->availableVersion());
+    }
 
-        g_autoptr(GError) error2 = nullptr;
-        g_autoptr(GPtrArray) rels = fwupd_client_get_upgrades(client, fwupd_device_get_id(device), m_cancellable, &error2);
-        if (rels) {
-            if ((fwupd_device_get_flags(device) & FWUPD_DEVICE_FLAG_NEEDS_REBOOT) && fwupd_device_get_update_state(device) == FWUPD_UPDATE_STATE_SUCCESS) {
-                m_updater->setNeedsReboot(true);
-                continue;
-            }
+    /* Checking for firmware in the cache? */
+    const QString filename_cache = res->cacheFile();
+    if (!QFile::exists(filename_cache)) {
+        addUpdate(res);
+        return;
+    }
 
-            fwupd_device_add_release(device, (FwupdRelease *)g_ptr_array_index(rels, 0));
-            auto res = createApp(device);
-            if (!res) {
-                qWarning() << "Fwupd Error: Cannot Create App From Device" << fwupd_device_get_name(device);
-            } else {
-                QString longdescription;
-                for (uint j = 0; j < rels->len; j++) {
-                    FwupdRelease *release = (FwupdRelease *)g_ptr_array_index(rels, j);
-                    if (!fwupd_release_get_description(release))
-                        continue;
-                    if (rels->len > 1) {
-                        longdescription += QStringLiteral("Version %1\n").arg(QString::fromUtf8(fwupd_release_get_version(release)));
-                    }
-                    longdescription += QString::fromUtf8(fwupd_release_get_description(release));
-                    if (rels->len > 1) {
-                        longdescription += QLatin1Char('\n');
-                    }
-                }
-                res->setDescription(longdescription);
-
-                // Make sure to set the installed version of the current thing so
-                // they can both be shown in the update page UI
-                auto installedResource = m_resources[res->packageName()];
-                if (installedResource) {
-                    res->setInstalledVersion(installedResource->availableVersion());
-                }
-                addResource(res);
-            }
-        } else {
-            if (g_error_matches(error2, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-                qWarning() << "fwupd: Device not supported:" << fwupd_device_get_name(device);
-            } else if (!g_error_matches(error2, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO)) {
-                handleError(error2);
-            }
+    // Hashing firmware takes a while, it's only offered once a stale download is out of the way
+    /* Currently LVFS supports SHA1 only*/
+    GPtrArray *checksums = fwupd_release_get_checksums(fwupd_device_get_release_default(device));
+    const QByteArray checksum_tmp(fwupd_checksum_get_by_kind(checksums, G_CHECKSUM_SHA1));
+    QtConcurrent::run(&m_threadPool, [filename_cache, checksum_tmp] {
+        const QByteArray checksum = getChecksum(filename_cache, QCryptographicHash::Sha1);
+        if (checksum_tmp != checksum) {
+            QFile::remove(filename_cache);
         }
+    }).then(this, [this, res] {
+        addUpdate(res);
+    });
+}
+
+void FwupdBackend::addUpdate(FwupdResource *res)
+{
+    addResource(res);
+    resolveDevice(res);
+}
+
+void FwupdBackend::resolveDevice(FwupdResource *res)
+{
+    if (res) {
+        m_resolved += res;
+        Q_EMIT deviceResolved(res);
+    }
+
+    --m_pendingDevices;
+    Q_EMIT fetchingUpdatesProgressChanged();
+    if (m_pendingDevices == 0) {
+        m_fetching = false;
+        m_resolved.clear();
+        Q_EMIT contentsChanged();
+        Q_EMIT initialized();
     }
 }
 
@@ -210,8 +241,7 @@ FwupdResource *FwupdBackend::createApp(FwupdDevice *device)
         return nullptr;
     }
 
-    GPtrArray *checksums = fwupd_release_get_checksums(release);
-    if (checksums->len == 0) {
+    if (fwupd_release_get_checksums(release)->len == 0) {
         qWarning() << "Fwupd Error: " << app->name() << "[" << app->id() << "] has no checksums, ignoring as unsafe";
         return nullptr;
     }
@@ -227,17 +257,6 @@ FwupdResource *FwupdBackend::createApp(FwupdDevice *device)
         return nullptr;
     }
 
-    /* Checking for firmware in the cache? */
-    const QString filename_cache = app->cacheFile();
-    if (QFile::exists(filename_cache)) {
-        /* Currently LVFS supports SHA1 only*/
-        const QByteArray checksum_tmp(fwupd_checksum_get_by_kind(checksums, G_CHECKSUM_SHA1));
-        const QByteArray checksum = getChecksum(filename_cache, QCryptographicHash::Sha1);
-        if (checksum_tmp != checksum) {
-            QFile::remove(filename_cache);
-        }
-    }
-
     app->setState(AbstractResource::Upgradeable);
     return app.release();
 }
@@ -275,36 +294,84 @@ static void fwupd_client_get_devices_cb(GObject * /*source*/, GAsyncResult *res,
     FwupdBackend *helper = (FwupdBackend *)user_data;
     g_autoptr(GError) error = nullptr;
     auto array = fwupd_client_get_devices_finish(helper->client, res, &error);
-    if (!error)
-        helper->setDevices(array);
-    else
-        helper->handleError(error);
+    if (error) {
+        if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO))
+            qDebug() << "Fwupd Info: No Devices Found";
+        else
+            helper->handleError(error);
+    }
+    helper->setDevices(array);
+}
+
+namespace
+{
+// What a request about a device needs once it's answered, the backend might be gone by then
+struct DeviceRequest {
+    DeviceRequest(FwupdBackend *backend, FwupdDevice *device)
+        : backend(backend)
+        , device(FWUPD_DEVICE(g_object_ref(device)))
+    {
+    }
+    ~DeviceRequest()
+    {
+        g_object_unref(device);
+    }
+    Q_DISABLE_COPY_MOVE(DeviceRequest)
+
+    const QPointer<FwupdBackend> backend;
+    FwupdDevice *const device;
+};
+}
+
+static void fwupd_client_get_releases_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    std::unique_ptr<DeviceRequest> request((DeviceRequest *)user_data);
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GPtrArray) releases = fwupd_client_get_releases_finish(FWUPD_CLIENT(source), res, &error);
+    if (request->backend)
+        request->backend->setReleases(request->device, releases, error);
+}
+
+static void fwupd_client_get_upgrades_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    std::unique_ptr<DeviceRequest> request((DeviceRequest *)user_data);
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(GPtrArray) releases = fwupd_client_get_upgrades_finish(FWUPD_CLIENT(source), res, &error);
+    if (request->backend)
+        request->backend->setUpgrades(request->device, releases, error);
 }
 
 void FwupdBackend::setDevices(GPtrArray *devices)
 {
+    // All devices are asked about at once and offered as they're answered
+    m_pendingDevices = 1;
     for (uint i = 0; devices && i < devices->len; i++) {
         FwupdDevice *device = (FwupdDevice *)g_ptr_array_index(devices, i);
 
         if (!fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_SUPPORTED))
             continue;
 
-        g_autoptr(GError) error = nullptr;
-        g_autoptr(GPtrArray) releases = fwupd_client_get_releases(client, fwupd_device_get_id(device), m_cancellable, &error);
+        ++m_pendingDevices;
+        fwupd_client_get_releases_async(client, fwupd_device_get_id(device), m_cancellable, fwupd_client_get_releases_cb, new DeviceRequest(this, device));
+    }
+    if (devices)
+        g_ptr_array_unref(devices);
 
-        if (error) {
-            if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-                qWarning() << "fwupd: Device not supported:" << fwupd_device_get_name(device) << error->message;
-                continue;
-            }
-            if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE)) {
-                continue;
-            }
+    m_devicesCount = m_pendingDevices - 1;
+    resolveDevice(nullptr);
+}
 
+void FwupdBackend::setReleases(FwupdDevice *device, GPtrArray *releases, GError *error)
+{
+    FwupdResource *res = nullptr;
+    if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+        qWarning() << "fwupd: Device not supported:" << fwupd_device_get_name(device) << error->message;
+    } else if (!g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE)) {
+        if (error) {
             handleError(error);
         }
 
-        auto res = new FwupdResource(device, this);
+        res = new FwupdResource(device, this);
         for (uint i = 0; releases && i < releases->len; ++i) {
             FwupdRelease *release = (FwupdRelease *)g_ptr_array_index(releases, i);
             if (res->installedVersion() == QUtf8StringView(fwupd_release_get_version(release))) {
@@ -314,13 +381,12 @@ void FwupdBackend::setDevices(GPtrArray *devices)
         }
         addResource(res);
     }
-    g_ptr_array_unref(devices);
-
-    addUpdates();
 
-    m_fetching = false;
-    Q_EMIT contentsChanged();
-    Q_EMIT initialized();
+    if (isUpgradable(device)) {
+        fwupd_client_get_upgrades_async(client, fwupd_device_get_id(device), m_cancellable, fwupd_client_get_upgrades_cb, new DeviceRequest(this, device));
+    } else {
+        resolveDevice(res);
+    }
 }
 
 static void fwupd_client_get_remotes_cb(GObject * /*source*/, GAsyncResult *res, gpointer user_data)
@@ -368,6 +434,9 @@ void FwupdBackend::checkForUpdates()
         return;
 
     m_fetching = true;
+    // Until the devices are known, the previous refresh's counts would report it as done
+    m_devicesCount = 0;
+    m_pendingDevices = 0;
     Q_EMIT fetchingUpdatesProgressChanged();
 
     fwupd_client_get_devices_async(client, m_cancellable, fwupd_client_get_devices_cb, this);
@@ -391,26 +460,37 @@ ResultsStream *FwupdBackend::search(const AbstractResourcesBackend::Filters &fil
     }
 
     auto stream = new ResultsStream(QStringLiteral("FwupdStream"));
-    auto f = [this, stream, filter]() {
-        QVector<StreamResult> ret;
-        for (AbstractResource *r : std::as_const(m_resources)) {
-            if (r->state() < filter.state)
-                continue;
-
-            if (filter.search.isEmpty() || r->name().contains(filter.search, Qt::CaseInsensitive)
-                || r->comment().contains(filter.search, Qt::CaseInsensitive)) {
-                ret += r;
-            }
-        }
-        if (!ret.isEmpty())
-            Q_EMIT stream->resourcesFound(ret);
-        stream->finish();
+    const auto matches = [filter](AbstractResource *r) {
+        return r->state() >= filter.state
+            && (filter.search.isEmpty() || r->name().contains(filter.search, Qt::CaseInsensitive)
+                || r->comment().contains(filter.search, Qt::CaseInsensitive));
     };
-    if (m_fetching) {
-        connect(this, &FwupdBackend::initialized, stream, f);
-    } else {
-        QTimer::singleShot(0, this, f);
+    if (!m_fetching) {
+        QTimer::singleShot(0, this, [this, stream, matches]() {
+            const auto ret = kFilter<QVector<StreamResult>>(m_resources, matches);
+            if (!ret.isEmpty())
+                Q_EMIT stream->resourcesFound(ret);
+            stream->finish();
+        });
+        return stream;
     }
+
+    // Offer what's known already and every device as it's resolved
+    QVector<StreamResult> resolved;
+    for (const auto &r : std::as_const(m_resolved)) {
+        if (r && matches(r))
+            resolved += r.data();
+    }
+    if (!resolved.isEmpty()) {
+        QTimer::singleShot(0, stream, [stream, resolved]() {
+            Q_EMIT stream->resourcesFound(resolved);
+        });
+    }
+    connect(this, &FwupdBackend::deviceResolved, stream, [stream, matches](FwupdResource *res) {
+        if (matches(res))
+            Q_EMIT stream->resourcesFound({res});
+    });
+    connect(this, &FwupdBackend::initialized, stream, &ResultsStream::finish);
     return stream;
 }
 
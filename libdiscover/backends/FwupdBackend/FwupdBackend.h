@@ -15,11 +15,13 @@
 #include <QFileInfo>
 #include <QMap>
 #include <QMimeDatabase>
+#include <QPointer>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSet>
 #include <QString>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariantList>
 
@@ -70,10 +72,15 @@ public:
     static QString cacheFile(const QString &kind, const QString &baseName);
     void setDevices(GPtrArray *);
     void setRemotes(GPtrArray *);
+    void setReleases(FwupdDevice *device, GPtrArray *releases, GError *error);
+    void setUpgrades(FwupdDevice *device, GPtrArray *releases, GError *error);
 
     int fetchingUpdatesProgress() const override
     {
-        return m_fetching > 0 ? 42 : 100;
+        if (!m_fetching) {
+            return 100;
+        }
+        return m_devicesCount > 0 ? (m_devicesCount - m_pendingDevices) * 100 / m_devicesCount : 0;
     }
     uint fetchingUpdatesProgressWeight() const override
     {
@@ -82,11 +89,14 @@ public:
 
 Q_SIGNALS:
     void initialized();
+    /// A device is known, @p resource is what it has to offer
+    void deviceResolved(FwupdResource *resource);
 
 private:
     ResultsStream *resourceForFile(const QUrl &);
-    void addUpdates();
     void addResource(FwupdResource *res);
+    void addUpdate(FwupdResource *res);
+    void resolveDevice(FwupdResource *res);
 
     static QMap<GChecksumType, QCryptographicHash::Algorithm> gchecksumToQChryptographicHash();
     static QByteArray getChecksum(const QString &filename, QCryptographicHash::Algorithm hashAlgorithm);
@@ -97,6 +107,11 @@ private:
     QHash<QString, FwupdResource *> m_resources;
     StandardBackendUpdater *m_updater;
     bool m_fetching = false;
+    // Devices being asked about in the current refresh
+    int m_devicesCount = 0;
+    int m_pendingDevices = 0;
+    QList<QPointer<FwupdResource>> m_resolved;
+    QThreadPool m_threadPool;
     int m_startElements;
     QList<AbstractResource *> m_toUpdate;
     GCancellable *m_cancellable;
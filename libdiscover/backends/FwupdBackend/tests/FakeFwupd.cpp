@@ -0,0 +1,134 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "FakeFwupd.h"
+
+#include <QCryptographicHash>
+#include <QDBusMetaType>
+#include <QTimer>
+
+#include <algorithm>
+
+#include <fwupd.h>
+
+using namespace Qt::StringLiterals;
+
+FakeFwupd::FakeFwupd(int devicesCount, int delay, QObject *parent)
+    : QObject(parent)
+    , m_devicesCount(devicesCount)
+    , m_delay(delay)
+    , m_connection(QDBusConnection::sessionBus())
+{
+    qDBusRegisterMetaType<QList<QVariantMap>>();
+    qDBusRegisterMetaType<QMap<QString, QString>>();
+}
+
+bool FakeFwupd::registerOn(QDBusConnection connection)
+{
+    m_connection = connection;
+    return connection.registerObject(QStringLiteral(FWUPD_DBUS_PATH), this, QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllProperties)
+        && connection.registerService(QStringLiteral(FWUPD_DBUS_SERVICE));
+}
+
+QString FakeFwupd::daemonVersion() const
+{
+    return u"2.0.0"_s;
+}
+
+QString FakeFwupd::hostVendor() const
+{
+    return u"KDE"_s;
+}
+
+QString FakeFwupd::hostProduct() const
+{
+    return u"Docking Station Lab"_s;
+}
+
+QString FakeFwupd::deviceName(int device)
+{
+    return u"Dock %1"_s.arg(device);
+}
+
+QString FakeFwupd::firmwareFileName(int device)
+{
+    return u"dock%1.cab"_s.arg(device);
+}
+
+QByteArray FakeFwupd::firmware(int device)
+{
+    return "firmware payload " + QByteArray::number(device);
+}
+
+QList<QVariantMap> FakeFwupd::GetDevices()
+{
+    QList<QVariantMap> ret;
+    for (int i = 0; i < m_devicesCount; ++i) {
+        ret += QVariantMap{
+            {QStringLiteral(FWUPD_RESULT_KEY_DEVICE_ID), u"%1"_s.arg(i, 40, 10, QLatin1Char('0'))},
+            {QStringLiteral(FWUPD_RESULT_KEY_NAME), deviceName(i)},
+            {QStringLiteral(FWUPD_RESULT_KEY_VENDOR), u"KDE"_s},
+            {QStringLiteral(FWUPD_RESULT_KEY_VERSION), u"1.0"_s},
+            {QStringLiteral(FWUPD_RESULT_KEY_FLAGS), quint64(FWUPD_DEVICE_FLAG_UPDATABLE | FWUPD_DEVICE_FLAG_SUPPORTED)},
+            {QStringLiteral(FWUPD_RESULT_KEY_GUID), QStringList{u"2082b5e0-7a64-478a-b1b2-e3404fab6dad"_s}},
+        };
+    }
+    return ret;
+}
+
+QList<QVariantMap> FakeFwupd::GetReleases(const QString &deviceId, const QDBusMessage &message)
+{
+    replyLater(message, {release(deviceIndex(deviceId), u"1.0"_s)});
+    return {};
+}
+
+QList<QVariantMap> FakeFwupd::GetUpgrades(const QString &deviceId, const QDBusMessage &message)
+{
+    replyLater(message, {release(deviceIndex(deviceId), u"2.0"_s)});
+    return {};
+}
+
+QList<QVariantMap> FakeFwupd::GetRemotes()
+{
+    return {};
+}
+
+void FakeFwupd::SetHints(const QMap<QString, QString> & /*hints*/)
+{
+}
+
+void FakeFwupd::replyLater(const QDBusMessage &message, const QList<QVariantMap> &releases)
+{
+    message.setDelayedReply(true);
+    ++m_requestsCount;
+    m_maxPending = std::max(m_maxPending, ++m_pending);
+    QTimer::singleShot(m_delay, this, [this, message, releases] {
+        --m_pending;
+        m_connection.send(message.createReply(QVariant::fromValue(releases)));
+    });
+}
+
+int FakeFwupd::deviceIndex(const QString &deviceId) const
+{
+    // Device ids are 40 hexadecimal digits, ours end with the device index
+    return deviceId.right(8).toInt();
+}
+
+QVariantMap FakeFwupd::release(int device, const QString &version) const
+{
+    return {
+        {QStringLiteral(FWUPD_RESULT_KEY_APPSTREAM_ID), u"org.kde.dock%1.firmware"_s.arg(device)},
+        {QStringLiteral(FWUPD_RESULT_KEY_NAME), deviceName(device)},
+        {QStringLiteral(FWUPD_RESULT_KEY_SUMMARY), u"Firmware for the dock"_s},
+        {QStringLiteral(FWUPD_RESULT_KEY_DESCRIPTION), u"<p>Version %1 of the firmware</p>"_s.arg(version)},
+        {QStringLiteral(FWUPD_RESULT_KEY_VERSION), version},
+        {QStringLiteral(FWUPD_RESULT_KEY_CHECKSUM), QString::fromLatin1(QCryptographicHash::hash(firmware(device), QCryptographicHash::Sha1).toHex())},
+        {QStringLiteral(FWUPD_RESULT_KEY_LOCATIONS), QStringList{u"https://fwupd.invalid/downloads/"_s + firmwareFileName(device)}},
+        {QStringLiteral(FWUPD_RESULT_KEY_SIZE), quint64(firmware(device).size())},
+    };
+}
+
+#include "moc_FakeFwupd.cpp"
@@ -0,0 +1,89 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QList>
+#include <QObject>
+#include <QVariantMap>
+
+/**
+ * Stands in for the fwupd daemon on D-Bus, with @p devicesCount updatable devices.
+ *
+ * Releases and upgrades are answered after @p delay, like a daemon that has
+ * to talk to the hardware. It records how many of them were asked at once.
+ */
+class FakeFwupd : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.fwupd")
+    Q_PROPERTY(QString DaemonVersion READ daemonVersion)
+    Q_PROPERTY(QString HostVendor READ hostVendor)
+    Q_PROPERTY(QString HostProduct READ hostProduct)
+    Q_PROPERTY(bool Tainted READ tainted)
+    Q_PROPERTY(bool Interactive READ interactive)
+    Q_PROPERTY(uint Status READ status)
+    Q_PROPERTY(uint Percentage READ percentage)
+public:
+    FakeFwupd(int devicesCount, int delay, QObject *parent = nullptr);
+
+    bool registerOn(QDBusConnection connection);
+
+    QString daemonVersion() const;
+    QString hostVendor() const;
+    QString hostProduct() const;
+    bool tainted() const
+    {
+        return false;
+    }
+    bool interactive() const
+    {
+        return false;
+    }
+    uint status() const
+    {
+        return 1; // FWUPD_STATUS_IDLE
+    }
+    uint percentage() const
+    {
+        return 0;
+    }
+
+    static QString deviceName(int device);
+    /// Where the upgrade of @p device gets downloaded to
+    static QString firmwareFileName(int device);
+    static QByteArray firmware(int device);
+
+    int maxPending() const
+    {
+        return m_maxPending;
+    }
+    int requestsCount() const
+    {
+        return m_requestsCount;
+    }
+
+public Q_SLOTS:
+    QList<QVariantMap> GetDevices();
+    QList<QVariantMap> GetReleases(const QString &deviceId, const QDBusMessage &message);
+    QList<QVariantMap> GetUpgrades(const QString &deviceId, const QDBusMessage &message);
+    QList<QVariantMap> GetRemotes();
+    void SetHints(const QMap<QString, QString> &hints);
+
+private:
+    void replyLater(const QDBusMessage &message, const QList<QVariantMap> &releases);
+    int deviceIndex(const QString &deviceId) const;
+    QVariantMap release(int device, const QString &version) const;
+
+    const int m_devicesCount;
+    const int m_delay;
+    QDBusConnection m_connection;
+    int m_pending = 0;
+    int m_maxPending = 0;
+    int m_requestsCount = 0;
+};
@@ -0,0 +1,119 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "FakeFwupd.h"
+
+#include <resources/AbstractResource.h>
+#include <resources/ResourcesModel.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+static constexpr int s_devicesCount = 12;
+static constexpr int s_delay = 300;
+
+class FwupdTest : public QObject
+{
+    Q_OBJECT
+public:
+    AbstractResourcesBackend *backendByName(ResourcesModel *m, const QString &name)
+    {
+        const QVector<AbstractResourcesBackend *> backends = m->backends();
+        for (AbstractResourcesBackend *backend : backends) {
+            if (QLatin1String(backend->metaObject()->className()) == name) {
+                return backend;
+            }
+        }
+        return nullptr;
+    }
+
+    explicit FwupdTest(QObject *parent = nullptr)
+        : QObject(parent)
+        , m_fwupd(s_devicesCount, s_delay)
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // The fwupd client talks to the system bus, which is our session bus here
+        QVERIFY(m_fwupd.registerOn(QDBusConnection::sessionBus()));
+        qputenv("DBUS_SYSTEM_BUS_ADDRESS", qgetenv("DBUS_SESSION_BUS_ADDRESS"));
+
+        QElapsedTimer timer;
+        timer.start();
+        m_model = new ResourcesModel(u"fwupd-backend"_s, this);
+        m_backend = backendByName(m_model, u"FwupdBackend"_s);
+        QVERIFY(m_backend);
+        QSignalSpy initializedSpy(m_backend, SIGNAL(initialized()));
+        QVERIFY(initializedSpy.wait(s_devicesCount * s_delay * 2));
+
+        // Releases and then upgrades, one after the other for each device but all devices at once
+        QCOMPARE(m_fwupd.requestsCount(), s_devicesCount * 2);
+        QCOMPARE(m_fwupd.maxPending(), s_devicesCount);
+        QVERIFY(timer.elapsed() < s_devicesCount * s_delay);
+        QCOMPARE(m_backend->fetchingUpdatesProgress(), 100);
+    }
+
+    void testStreamWhileFetching()
+    {
+        QSignalSpy initializedSpy(m_backend, SIGNAL(initialized()));
+        m_backend->checkForUpdates();
+        QVERIFY(m_backend->fetchingUpdatesProgress() < 100);
+
+        AbstractResourcesBackend::Filters filters;
+        filters.state = AbstractResource::Upgradeable;
+        auto stream = m_backend->search(filters);
+        int found = 0;
+        int batches = 0;
+        connect(stream, &ResultsStream::resourcesFound, this, [&found, &batches](const QVector<StreamResult> &results) {
+            found += results.count();
+            ++batches;
+        });
+        QSignalSpy destroyedSpy(stream, &QObject::destroyed);
+        QVERIFY(destroyedSpy.wait(s_devicesCount * s_delay * 2));
+        QCOMPARE(initializedSpy.count(), 1);
+
+        // Every device comes as soon as it's known, rather than all of them at the end
+        QCOMPARE(found, s_devicesCount);
+        QVERIFY(batches > 1);
+    }
+
+    void testCachedFirmwareVerified()
+    {
+        const QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + u"/fwupd"_s);
+        QVERIFY(cacheDir.mkpath(u"."_s));
+        const QString stale = cacheDir.filePath(FakeFwupd::firmwareFileName(0));
+        const QString good = cacheDir.filePath(FakeFwupd::firmwareFileName(1));
+        for (const auto &[fileName, contents] : {std::pair{stale, QByteArray("truncated download")}, std::pair{good, FakeFwupd::firmware(1)}}) {
+            QFile file(fileName);
+            QVERIFY(file.open(QFile::WriteOnly));
+            file.write(contents);
+        }
+
+        QSignalSpy initializedSpy(m_backend, SIGNAL(initialized()));
+        m_backend->checkForUpdates();
+        QVERIFY(initializedSpy.wait(s_devicesCount * s_delay * 2));
+        QVERIFY(!QFile::exists(stale));
+        QVERIFY(QFile::exists(good));
+    }
+
+private:
+    FakeFwupd m_fwupd;
+    ResourcesModel *m_model = nullptr;
+    AbstractResourcesBackend *m_backend = nullptr;
+};
+
+QTEST_GUILESS_MAIN(FwupdTest)
+
+#include "FwupdTest.moc"
@@ -8,6 +8,7 @@
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 #include <QStandardPaths>
 #include <QTimer>
@@ -29,6 +30,7 @@
 
 // Own includes
 #include "KNSBackend.h"
+#include "KNSEngineMultiplexer.h"
 #include "KNSResource.h"
 #include "KNSReviews.h"
 #include "KNSTransaction.h"
@@ -198,18 +200,12 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
     const KConfigGroup group = hasVersionlessGrp ? conf.group(u"KNewStuff"_s) : conf.group(u"KNewStuff3"_s);
     m_extends = group.readEntry("Extends", QStringList());
 
-    setFetching(true);
+    m_providersUrl = group.readEntry("ProvidersUrl", QString());
 
     // This ensures we have something to track when checking after the initialization timeout
     connect(this, &KNSBackend::initialized, this, [this]() {
         m_initialized = true;
     });
-    // If we have not initialized in 60 seconds, consider this KNS backend invalid
-    QTimer::singleShot(60000, this, [this]() {
-        if (!m_initialized) {
-            markInvalid(i18n("Backend %1 took too long to initialize", m_displayName));
-        }
-    });
 
     const CategoryFilter filter = {CategoryFilter::CategoryNameFilter, fileName};
     const QSet<QString> backendName = {name()};
@@ -253,35 +249,103 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
         }
     }
 
+    m_subCategories = categories;
+    const auto categoryNames = KNSEngineMultiplexer::instance()->categoryNames(name());
+    for (const auto &[categoryName, displayName] : categoryNames.asKeyValueRange()) {
+        for (const std::shared_ptr<Category> &cat : std::as_const(categories)) {
+            if (cat->matchesCategoryName(categoryName)) {
+                cat->setName(displayName);
+                break;
+            }
+        }
+    }
+
+    if (m_hasApplications) {
+        auto actualCategory = std::make_shared<Category>(m_displayName, QStringLiteral("applications-other"), filter, backendName, topCategories);
+        std::shared_ptr<Category> applicationCategory = std::make_shared<Category>(i18n("Applications"), //
+                                                                                   QStringLiteral("applications-internet"),
+                                                                                   filter,
+                                                                                   backendName,
+                                                                                   QList<std::shared_ptr<Category>>{actualCategory});
+        const QList<CategoryFilter> filters = {{CategoryFilter::CategoryNameFilter, QLatin1String("Application")}, filter};
+        applicationCategory->setFilter({CategoryFilter::AndFilter, filters});
+        m_categories.append(applicationCategory->name());
+        m_rootCategories = {applicationCategory};
+    } else {
+        const auto iconName = isPlasmaCategory ? QStringLiteral("plasma") : QStringLiteral("applications-other");
+        auto actualCategory = std::make_shared<Category>(m_displayName, iconName, filter, backendName, categories, Category::Type::Addon);
+
+        const auto topLevelName = isPlasmaCategory ? i18n("Plasma Addons") : i18n("Application Addons");
+        auto addonsCategory =
+            std::make_shared<Category>(topLevelName, iconName, filter, backendName, QList<std::shared_ptr<Category>>{actualCategory}, Category::Type::Addon);
+        m_rootCategories = {addonsCategory};
+    }
+
+    connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &KNSBackend::updatesCountChanged);
+
+    // The engine is only built once it's used. Installed entries need it to be checked for updates,
+    // without any there's nothing to wait for.
+    m_hasInstalledEntries = hasInstalledEntries();
+    if (m_hasInstalledEntries) {
+        KNSEngineMultiplexer::instance()->activate(this, KNSEngineMultiplexer::Background);
+    } else {
+        QTimer::singleShot(0, this, &KNSBackend::contentsChanged);
+    }
+}
+
+bool KNSBackend::hasInstalledEntries() const
+{
+    // Where KNSCore keeps track of what got installed through this knsrc file
+    QFile registry(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/knewstuff3/"_L1 + QFileInfo(m_name).completeBaseName()
+                   + ".knsregistry"_L1);
+    if (!registry.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return registry.readAll().contains("<stuff");
+}
+
+void KNSBackend::activate()
+{
+    if (!m_engine && m_isValid) {
+        KNSEngineMultiplexer::instance()->activate(this, KNSEngineMultiplexer::Immediate);
+    }
+}
+
+void KNSBackend::startEngine(const QString &providersFile)
+{
+    Q_ASSERT(!m_engine);
+    m_initialized = false;
+    setFetching(true);
+
     m_engine = new KNSCore::EngineBase(this);
+    // If we have not initialized in 60 seconds, give up on this engine until the next request
+    QTimer::singleShot(60000, m_engine, [this]() {
+        if (!m_initialized) {
+            dropEngine(i18n("Backend %1 took too long to initialize", m_displayName));
+        }
+    });
+
     connect(m_engine, &KNSCore::EngineBase::signalErrorCode, this, &KNSBackend::slotErrorCode);
     connect(m_engine, &KNSCore::EngineBase::providerAdded, this, [this] {
         setFetching(false);
     });
 
-    connect(m_engine, &KNSCore::EngineBase::signalCategoriesMetadataLoaded, this, [categories](const QList<KNSCore::CategoryMetadata> &categoryMetadatas) {
+    connect(m_engine, &KNSCore::EngineBase::signalCategoriesMetadataLoaded, this, [this](const QList<KNSCore::CategoryMetadata> &categoryMetadatas) {
+        QHash<QString, QString> names;
         for (const KNSCore::CategoryMetadata &category : categoryMetadatas) {
-            for (const std::shared_ptr<Category> &cat : std::as_const(categories)) {
+            for (const std::shared_ptr<Category> &cat : std::as_const(m_subCategories)) {
                 if (cat->matchesCategoryName(category.name())) {
                     cat->setName(category.displayName());
+                    names.insert(category.name(), category.displayName());
                     break;
                 }
             }
         }
+        KNSEngineMultiplexer::instance()->setCategoryNames(name(), names);
     });
-    m_engine->init(m_name);
+    m_engine->init(providersFile.isEmpty() ? m_name : knsrcWithProviders(providersFile));
 
     if (m_hasApplications) {
-        auto actualCategory = std::make_shared<Category>(m_displayName, QStringLiteral("applications-other"), filter, backendName, topCategories);
-        std::shared_ptr<Category> applicationCategory = std::make_shared<Category>(i18n("Applications"), //
-                                                                                   QStringLiteral("applications-internet"),
-                                                                                   filter,
-                                                                                   backendName,
-                                                                                   QList<std::shared_ptr<Category>>{actualCategory});
-        const QList<CategoryFilter> filters = {{CategoryFilter::CategoryNameFilter, QLatin1String("Application")}, filter};
-        applicationCategory->setFilter({CategoryFilter::AndFilter, filters});
-        m_categories.append(applicationCategory->name());
-        m_rootCategories = {applicationCategory};
         // Make sure we filter out any apps which won't run on the current system architecture
         QStringList tagFilter = m_engine->tagFilter();
         if (QSysInfo::currentCpuArchitecture() == QLatin1String("arm")) {
@@ -297,17 +361,48 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
             tagFilter << QLatin1String("application##architecture==x86-64");
         }
         m_engine->setTagFilter(tagFilter);
-    } else {
-        const auto iconName = isPlasmaCategory ? QStringLiteral("plasma") : QStringLiteral("applications-other");
-        auto actualCategory = std::make_shared<Category>(m_displayName, iconName, filter, backendName, categories, Category::Type::Addon);
+    }
+}
 
-        const auto topLevelName = isPlasmaCategory ? i18n("Plasma Addons") : i18n("Application Addons");
-        auto addonsCategory =
-            std::make_shared<Category>(topLevelName, iconName, filter, backendName, QList<std::shared_ptr<Category>>{actualCategory}, Category::Type::Addon);
-        m_rootCategories = {addonsCategory};
+QString KNSBackend::knsrcWithProviders(const QString &providersFile) const
+{
+    // Same file name, which is what KNSCore names the registry and the cache after
+    const QString dir = KNSEngineMultiplexer::providersCacheDir() + "/knsrc"_L1;
+    const QString path = dir + QLatin1Char('/') + QFileInfo(m_name).fileName();
+    QDir().mkpath(dir);
+    QFile::remove(path);
+    if (!QFile::copy(m_name, path)) {
+        qWarning() << "could not copy" << m_name << "to" << path;
+        return m_name;
     }
 
-    connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &KNSBackend::updatesCountChanged);
+    KConfig conf(path, KConfig::SimpleConfig);
+    KConfigGroup group = conf.hasGroup(u"KNewStuff"_s) ? conf.group(u"KNewStuff"_s) : conf.group(u"KNewStuff3"_s);
+    group.writeEntry("ProvidersUrl", QUrl::fromLocalFile(providersFile).toString());
+    conf.sync();
+    return path;
+}
+
+void KNSBackend::providersUnavailable()
+{
+    if (m_fetching) {
+        setFetching(false);
+    } else {
+        Q_EMIT initialized();
+    }
+}
+
+void KNSBackend::dropEngine(const QString &message)
+{
+    if (!m_engine) {
+        return;
+    }
+    qWarning() << "kns backend" << m_name << "has no engine for now:" << message;
+    disconnect(m_engine, nullptr, this, nullptr);
+    m_engine->deleteLater();
+    m_engine = nullptr;
+    Q_EMIT passiveMessage(message);
+    providersUnavailable();
 }
 
 KNSBackend::~KNSBackend()
@@ -339,6 +434,7 @@ void KNSBackend::setFetching(bool f)
             Q_EMIT initialized();
             Q_EMIT contentsChanged();
         }
+        Q_EMIT fetchingUpdatesProgressChanged();
     }
 }
 
@@ -390,7 +486,12 @@ void KNSBackend::slotErrorCode(const KNSCore::ErrorCode::ErrorCode &errorCode, c
     case KNSCore::ErrorCode::NetworkError:
         // If we have a network error, we need to tell the user about it. This is almost always fatal, so mark invalid and tell the user.
         error = i18n("Network error in backend %1: %2", m_displayName, metadata.toInt());
-        markInvalid(error);
+        if (!m_initialized) {
+            // The providers couldn't be reached, they're tried again on the next request
+            dropEngine(error);
+        } else {
+            markInvalid(error);
+        }
         invalidFile = true;
         break;
     case KNSCore::ErrorCode::OcsError:
@@ -502,16 +603,22 @@ static ResultsStream *voidStream()
 template<typename T>
 void KNSBackend::deferredResultStream(KNSResultsStream *stream, T start)
 {
-    if (m_fetching) {
-        auto startOnce = [stream, start] {
+    if (!m_engine || m_fetching) {
+        auto startOnce = [this, stream, start] {
             if (stream->hasStarted()) {
                 return;
             }
+            if (!m_engine) {
+                // Its providers couldn't be loaded this time
+                stream->finish();
+                return;
+            }
             start();
         };
 
         // If it's not ready to take queries, wait a bit longer
         connect(this, &KNSBackend::initialized, stream, startOnce, Qt::QueuedConnection);
+        activate();
     } else {
         QTimer::singleShot(0, stream, start);
     }
@@ -525,6 +632,9 @@ ResultsStream *KNSBackend::search(const AbstractResourcesBackend::Filters &filte
     if (filter.resourceUrl.scheme() == QLatin1String("kns")) {
         return findResourceByPackageName(filter.resourceUrl);
     } else if (filter.state >= AbstractResource::Installed) {
+        if (!m_engine && !m_hasInstalledEntries) {
+            return voidStream();
+        }
         auto stream = new KNSResultsStream(this, "KNS-installed-"_L1 + name());
         const auto start = [this, stream, filter]() {
             if (m_isValid) {
@@ -573,7 +683,11 @@ ResultsStream *KNSBackend::findResourceByPackageName(const QUrl &search)
     const auto entryid = pathParts.at(0);
 
     auto stream = new KNSResultsStream(this, QLatin1String("KNS-byname-") + entryid);
-    auto start = [entryid, stream]() {
+    auto start = [this, entryid, stream]() {
+        if (!m_isValid) {
+            stream->finish();
+            return;
+        }
         KNSCore::SearchRequest query(KNSCore::SortMode::Newest, KNSCore::Filter::ExactEntryId, entryid, {}, 0, ENGINE_PAGE_SIZE);
         stream->setRequest(query);
     };
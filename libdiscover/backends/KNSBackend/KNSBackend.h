@@ -61,11 +61,20 @@ public:
         return m_iconName;
     }
 
+    /// Null until the backend is activated
     KNSCore::EngineBase *engine() const
     {
         return m_engine;
     }
 
+    /// Builds the engine, unless it's there already
+    void activate();
+
+    QString providersUrl() const
+    {
+        return m_providersUrl;
+    }
+
     void checkForUpdates() override;
 
     QString displayName() const override;
@@ -86,6 +95,15 @@ public Q_SLOTS:
     void slotEntryEvent(const KNSCore::Entry &entry, KNSCore::Entry::EntryEvent event);
 
 private:
+    friend class KNSEngineMultiplexer;
+    /// Builds the engine, reading the providers from @p providersFile when it's not empty
+    void startEngine(const QString &providersFile);
+    /// There's no engine for now, what's waiting for one gets nothing
+    void providersUnavailable();
+    /// Gives up on the engine before it got its providers, the next request builds another one
+    void dropEngine(const QString &message);
+    QString knsrcWithProviders(const QString &providersFile) const;
+    bool hasInstalledEntries() const;
     void fetchInstalled();
     void setFetching(bool f);
     void markInvalid(const QString &message);
@@ -96,7 +114,7 @@ private:
 
     bool m_fetching;
     bool m_isValid;
-    KNSCore::EngineBase *m_engine;
+    KNSCore::EngineBase *m_engine = nullptr;
     QHash<QString, AbstractResource *> m_resourcesByName;
     KNSReviews *const m_reviews;
     QString m_name;
@@ -105,7 +123,11 @@ private:
     QStringList m_extends;
     QStringList m_categories;
     QList<std::shared_ptr<Category>> m_rootCategories;
+    // Named after the metadata of the providers
+    QList<std::shared_ptr<Category>> m_subCategories;
+    QString m_providersUrl;
     QString m_displayName;
     bool m_initialized = false;
     bool m_hasApplications = false;
+    bool m_hasInstalledEntries = false;
 };
@@ -0,0 +1,230 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "KNSEngineMultiplexer.h"
+#include "KNSBackend.h"
+
+#include <KConfigGroup>
+#include <KLocalizedString>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <chrono>
+
+using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
+
+// Endpoints whose providers are fetched at the same time for background activations
+static constexpr int s_maxFetching = 2;
+// How long a providers file on disk is used without fetching it again
+static constexpr std::chrono::seconds s_providersMaxAge = 24h;
+
+static QString cachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/knsproviders"_L1;
+}
+
+static QString providersFileOf(const QString &url)
+{
+    return KNSEngineMultiplexer::providersCacheDir() + QLatin1Char('/')
+        + QString::fromLatin1(QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".xml"_L1;
+}
+
+KNSEngineMultiplexer *KNSEngineMultiplexer::instance()
+{
+    // Owned by the application, so that it goes away before QCoreApplication does
+    static QPointer<KNSEngineMultiplexer> instance;
+    if (!instance) {
+        instance = new KNSEngineMultiplexer(QCoreApplication::instance());
+    }
+    return instance;
+}
+
+KNSEngineMultiplexer::KNSEngineMultiplexer(QObject *parent)
+    : QObject(parent)
+    , m_cache(cachePath(), KConfig::SimpleConfig)
+{
+    m_pump.setSingleShot(true);
+    m_pump.setInterval(0);
+    connect(&m_pump, &QTimer::timeout, this, &KNSEngineMultiplexer::pump);
+}
+
+QString KNSEngineMultiplexer::providersCacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/knsproviders-files"_L1;
+}
+
+void KNSEngineMultiplexer::activate(KNSBackend *backend, Priority priority)
+{
+    if (backend->engine() || !backend->isValid() || m_endpoints.value(backend->providersUrl()).waiting.contains(backend)) {
+        return;
+    }
+
+    if (priority == Background) {
+        if (!m_queued.contains(backend)) {
+            m_queued.append(backend);
+        }
+        m_pump.start();
+        return;
+    }
+    m_queued.removeAll(backend);
+    join(backend, Immediate);
+}
+
+void KNSEngineMultiplexer::join(KNSBackend *backend, Priority priority)
+{
+    const QString url = backend->providersUrl();
+    Endpoint &endpoint = m_endpoints[url];
+    if (endpoint.state == Endpoint::Failed && priority == Immediate) {
+        // Asked for again, it may be reachable by now
+        endpoint.state = Endpoint::Idle;
+    }
+
+    switch (endpoint.state) {
+    case Endpoint::Idle:
+        endpoint.waiting.append(backend);
+        fetch(url);
+        break;
+    case Endpoint::Fetching:
+        endpoint.waiting.append(backend);
+        break;
+    case Endpoint::Ready:
+        backend->startEngine(endpoint.providersFile);
+        break;
+    case Endpoint::Failed:
+        backend->providersUnavailable();
+        break;
+    }
+}
+
+void KNSEngineMultiplexer::fetch(const QString &url)
+{
+    const QUrl providersUrl(url);
+    if (providersUrl.scheme() != "http"_L1 && providersUrl.scheme() != "https"_L1) {
+        // Nothing to fetch, the engine reads them itself
+        ready(url, QString());
+        return;
+    }
+
+    const QString file = providersFileOf(url);
+    const QFileInfo cached(file);
+    if (cached.exists() && cached.lastModified().secsTo(QDateTime::currentDateTime()) < s_providersMaxAge.count()) {
+        ready(url, file);
+        return;
+    }
+
+    if (!m_nam) {
+        m_nam = new QNetworkAccessManager(this);
+    }
+    m_endpoints[url].state = Endpoint::Fetching;
+    ++m_fetching;
+    QNetworkReply *reply = m_nam->get(QNetworkRequest(providersUrl));
+    connect(reply, &QNetworkReply::finished, this, [this, url, reply] {
+        fetched(url, reply);
+    });
+}
+
+void KNSEngineMultiplexer::fetched(const QString &url, QNetworkReply *reply)
+{
+    reply->deleteLater();
+    --m_fetching;
+    m_pump.start();
+
+    const QString file = providersFileOf(url);
+    if (reply->error() == QNetworkReply::NoError) {
+        QDir().mkpath(providersCacheDir());
+        QSaveFile saved(file);
+        if (saved.open(QIODevice::WriteOnly) && saved.write(reply->readAll()) >= 0 && saved.commit()) {
+            ready(url, file);
+        } else {
+            // The engines can still fetch it, each of them
+            qWarning() << "could not keep the kns providers from" << url << "in" << file << saved.errorString();
+            ready(url, QString());
+        }
+        return;
+    }
+
+    if (QFileInfo::exists(file)) {
+        qWarning() << "kns providers could not be fetched from" << url << reply->errorString() << ", using the ones fetched before";
+        ready(url, file);
+        return;
+    }
+
+    qWarning() << "kns providers could not be fetched from" << url << reply->errorString();
+    Endpoint &endpoint = m_endpoints[url];
+    endpoint.state = Endpoint::Failed;
+    endpoint.error = i18n("Could not reach the add-ons provider %1: %2", QUrl(url).host(), reply->errorString());
+    const auto waiting = std::exchange(endpoint.waiting, {});
+    bool reported = false;
+    for (const auto &backend : waiting) {
+        if (backend && backend->isValid()) {
+            // Once for all the backends of the endpoint
+            if (!std::exchange(reported, true)) {
+                Q_EMIT backend->passiveMessage(endpoint.error);
+            }
+            backend->providersUnavailable();
+        }
+    }
+}
+
+void KNSEngineMultiplexer::ready(const QString &url, const QString &providersFile)
+{
+    Endpoint &endpoint = m_endpoints[url];
+    endpoint.state = Endpoint::Ready;
+    endpoint.providersFile = providersFile;
+    endpoint.error.clear();
+    const auto waiting = std::exchange(endpoint.waiting, {});
+    for (const auto &backend : waiting) {
+        if (backend && backend->isValid() && !backend->engine()) {
+            backend->startEngine(providersFile);
+        }
+    }
+}
+
+void KNSEngineMultiplexer::pump()
+{
+    while (m_fetching < s_maxFetching && !m_queued.isEmpty()) {
+        const QPointer<KNSBackend> backend = m_queued.takeFirst();
+        if (backend && !backend->engine() && backend->isValid()) {
+            join(backend, Background);
+        }
+    }
+}
+
+QHash<QString, QString> KNSEngineMultiplexer::categoryNames(const QString &knsrc) const
+{
+    QHash<QString, QString> ret;
+    const KConfigGroup group = m_cache.group(knsrc);
+    const auto keys = group.keyList();
+    for (const QString &key : keys) {
+        ret.insert(key, group.readEntry(key, QString()));
+    }
+    return ret;
+}
+
+void KNSEngineMultiplexer::setCategoryNames(const QString &knsrc, const QHash<QString, QString> &names)
+{
+    if (names == categoryNames(knsrc)) {
+        return;
+    }
+
+    KConfigGroup group = m_cache.group(knsrc);
+    group.deleteGroup();
+    for (const auto &[name, displayName] : names.asKeyValueRange()) {
+        group.writeEntry(name, displayName);
+    }
+    QDir().mkpath(QFileInfo(cachePath()).absolutePath());
+    m_cache.sync();
+}
+
+#include "moc_KNSEngineMultiplexer.cpp"
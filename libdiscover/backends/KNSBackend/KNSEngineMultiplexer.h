@@ -0,0 +1,89 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <KConfig>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class KNSBackend;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+ * \class KNSEngineMultiplexer  KNSEngineMultiplexer.h "KNSEngineMultiplexer.h"
+ *
+ * \brief Starts the engines of the KNS backends, fetching each providers endpoint once
+ *
+ * The backends are registered without an engine. When one is needed, the
+ * providers file of its endpoint is fetched here, once for all the backends
+ * that share it, and kept on disk. The engines are then built on that copy,
+ * which is reused without asking the network again for a day, and when the
+ * endpoint can't be reached.
+ *
+ * An endpoint that fails without a copy on disk leaves its backends without
+ * an engine for now, the next request on one of them tries again.
+ *
+ * Backends that only need to check their installed entries for updates are
+ * activated in the background, a few endpoints at a time.
+ *
+ * The category names the providers answer are kept on disk, so that the
+ * backends that weren't used yet show them too.
+ */
+class KNSEngineMultiplexer : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        Background,
+        Immediate,
+    };
+
+    static KNSEngineMultiplexer *instance();
+
+    void activate(KNSBackend *backend, Priority priority);
+
+    /// Category names to display names, as last answered to @p knsrc
+    QHash<QString, QString> categoryNames(const QString &knsrc) const;
+    void setCategoryNames(const QString &knsrc, const QHash<QString, QString> &names);
+
+    /// Where the copies of the providers files and of the knsrc files using them are kept
+    static QString providersCacheDir();
+
+private:
+    struct Endpoint {
+        enum State {
+            Idle,
+            Fetching,
+            Ready,
+            Failed,
+        };
+        State state = Idle;
+        // The copy on disk, empty when the engine fetches the providers itself
+        QString providersFile;
+        QString error;
+        QList<QPointer<KNSBackend>> waiting;
+    };
+
+    explicit KNSEngineMultiplexer(QObject *parent);
+
+    void join(KNSBackend *backend, Priority priority);
+    void fetch(const QString &url);
+    void fetched(const QString &url, QNetworkReply *reply);
+    void ready(const QString &url, const QString &providersFile);
+    void pump();
+
+    QHash<QString, Endpoint> m_endpoints;
+    QList<QPointer<KNSBackend>> m_queued;
+    int m_fetching = 0;
+    QTimer m_pump;
+    QNetworkAccessManager *m_nam = nullptr;
+    KConfig m_cache;
+};
@@ -0,0 +1,121 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "KNSBackendBenchmark.h"
+#include "KNSStandInProvider.h"
+#include "utils.h"
+#include <resources/AbstractResourcesBackend.h>
+#include <resources/ResourcesModel.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+
+QTEST_MAIN(KNSBackendBenchmark)
+
+using namespace Qt::StringLiterals;
+
+static const int s_knsrcCount = 24;
+// knsrc files that share their providers file
+static const int s_endpointCount = 3;
+// More than a page of the engine
+static const int s_entriesPerCategory = 150;
+
+static QString categoryName(int index)
+{
+    return u"standin-%1"_s.arg(index);
+}
+
+KNSBackendBenchmark::KNSBackendBenchmark(QObject *parent)
+    : QObject(parent)
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)).removeRecursively();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+}
+
+void KNSBackendBenchmark::initTestCase()
+{
+    QStringList categories;
+    for (int i = 0; i < s_knsrcCount; ++i) {
+        categories += categoryName(i);
+    }
+    m_provider = new KNSStandInProvider(categories, s_entriesPerCategory, this);
+    QVERIFY(m_provider->start());
+
+    const QString knsrcDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/knsrcfiles"_L1;
+    QVERIFY(QDir().mkpath(knsrcDir));
+    for (int i = 0; i < s_knsrcCount; ++i) {
+        QFile knsrc(knsrcDir + QLatin1Char('/') + categoryName(i) + ".knsrc"_L1);
+        QVERIFY(knsrc.open(QIODevice::WriteOnly));
+        knsrc.write("[KNewStuff]\nName=Stand-in " + QByteArray::number(i) + "\nProvidersUrl="
+                    + m_provider->providersUrl(QString::number(i % s_endpointCount)).toEncoded() + "\nCategories=" + categoryName(i).toUtf8()
+                    + "\nStandardResource=tmp\nUncompress=never\n");
+    }
+}
+
+QVector<AbstractResourcesBackend *> KNSBackendBenchmark::standInBackends() const
+{
+    return kFilter<QVector<AbstractResourcesBackend *>>(ResourcesModel::global()->backends(), [](AbstractResourcesBackend *backend) {
+        return backend->name().startsWith("standin-"_L1);
+    });
+}
+
+void KNSBackendBenchmark::benchmarkStartup()
+{
+    QElapsedTimer timer;
+    timer.start();
+    auto model = new ResourcesModel(u"kns-backend"_s, this);
+    QVERIFY(!model->backends().isEmpty());
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+
+    QCOMPARE(standInBackends().size(), s_knsrcCount);
+    // Nothing was installed through them, so none needs its engine yet
+    QTest::qWait(500);
+    QCOMPARE(m_provider->requestCount(), 0);
+}
+
+void KNSBackendBenchmark::benchmarkSearchFanOut()
+{
+    const auto backends = standInBackends();
+    QHash<AbstractResourcesBackend *, int> found;
+    int pending = backends.size();
+    // Disconnects the counters once they go out of scope
+    QObject context;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (auto backend : backends) {
+        AbstractResourcesBackend::Filters filter;
+        filter.category = backend->category().constFirst();
+        auto stream = ResourcesModel::global()->search(filter);
+        connect(stream, &ResultsStream::resourcesFound, &context, [&found, backend, stream](const QVector<StreamResult> &results) {
+            found[backend] += results.size();
+            if (found[backend] < s_entriesPerCategory) {
+                Q_EMIT stream->fetchMore();
+            }
+        });
+        connect(stream, &QObject::destroyed, &context, [&pending] {
+            --pending;
+        });
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(pending, 0, 60000);
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+
+    for (auto backend : backends) {
+        QCOMPARE(found.value(backend), s_entriesPerCategory);
+    }
+
+    const auto requests = m_provider->requests();
+    qDebug() << "providers file asked" << requests.value(u"/providers.xml"_s) << "times by" << backends.size() << "backends on" << s_endpointCount
+             << "endpoints," << requests.value(u"/ocs/v1/content/data"_s) << "content pages";
+    // Once per endpoint, however many backends share it
+    QCOMPARE(requests.value(u"/providers.xml"_s), s_endpointCount);
+}
+
+#include "moc_KNSBackendBenchmark.cpp"
@@ -0,0 +1,33 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+class AbstractResourcesBackend;
+class KNSStandInProvider;
+
+/**
+ * Measures how long the KNS backends take to be registered and to answer
+ * a search through all of them, against a stand-in provider on localhost.
+ */
+class KNSBackendBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit KNSBackendBenchmark(QObject *parent = nullptr);
+
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkStartup();
+    void benchmarkSearchFanOut();
+
+private:
+    QVector<AbstractResourcesBackend *> standInBackends() const;
+    KNSStandInProvider *m_provider = nullptr;
+};
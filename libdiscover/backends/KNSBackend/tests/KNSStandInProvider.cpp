@@ -0,0 +1,167 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "KNSStandInProvider.h"
+
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QUrlQuery>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+static constexpr int s_entryIdStride = 1000;
+
+static QByteArray ocsDocument(const QByteArray &data, int totalItems = 0, int itemsPerPage = 0)
+{
+    QByteArray meta = "<status>ok</status><statuscode>100</statuscode><message></message>";
+    if (itemsPerPage > 0) {
+        meta += "<totalitems>" + QByteArray::number(totalItems) + "</totalitems><itemsperpage>" + QByteArray::number(itemsPerPage) + "</itemsperpage>";
+    }
+    return "<?xml version=\"1.0\"?>\n<ocs><meta>" + meta + "</meta><data>" + data + "</data></ocs>\n";
+}
+
+KNSStandInProvider::KNSStandInProvider(const QStringList &categories, int entriesPerCategory, QObject *parent)
+    : QTcpServer(parent)
+    , m_categories(categories)
+    , m_entriesPerCategory(entriesPerCategory)
+{
+    connect(this, &QTcpServer::newConnection, this, [this] {
+        while (auto socket = nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, socket, [this, socket] {
+                readRequest(socket);
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+}
+
+bool KNSStandInProvider::start()
+{
+    return listen(QHostAddress::LocalHost);
+}
+
+QUrl KNSStandInProvider::providersUrl(const QString &variant) const
+{
+    QUrl url(u"http://127.0.0.1/providers.xml"_s);
+    url.setPort(serverPort());
+    if (!variant.isEmpty()) {
+        url.setQuery(u"variant="_s + variant);
+    }
+    return url;
+}
+
+int KNSStandInProvider::requestCount() const
+{
+    int ret = 0;
+    for (int count : m_requests) {
+        ret += count;
+    }
+    return ret;
+}
+
+void KNSStandInProvider::readRequest(QTcpSocket *socket)
+{
+    // Requests are tiny GETs, wait until the headers are complete
+    if (!socket->peek(socket->bytesAvailable()).contains("\r\n\r\n")) {
+        return;
+    }
+    const QList<QByteArray> requestLine = socket->readLine().trimmed().split(' ');
+    socket->readAll();
+    if (requestLine.size() < 2) {
+        socket->disconnectFromHost();
+        return;
+    }
+
+    const QUrl url(QString::fromLatin1(requestLine.at(1)));
+    m_requests[url.path()]++;
+    const QByteArray body = respond(url);
+    const QByteArray status = body.isEmpty() ? "404 Not Found" : "200 OK";
+    socket->write("HTTP/1.1 " + status + "\r\nContent-Type: text/xml; charset=utf-8\r\nCache-Control: max-age=3600\r\nContent-Length: "
+                  + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
+
+QByteArray KNSStandInProvider::respond(const QUrl &url) const
+{
+    const QString path = url.path();
+    if (path == "/providers.xml"_L1) {
+        return providers();
+    } else if (path == "/ocs/v1/content/categories"_L1) {
+        return categories();
+    } else if (path == "/ocs/v1/content/data"_L1) {
+        return contents(url);
+    } else if (path.startsWith("/ocs/v1/content/data/"_L1)) {
+        bool ok = false;
+        const int id = path.section(QLatin1Char('/'), -1).toInt(&ok);
+        return ok ? ocsDocument(content(id)) : QByteArray();
+    }
+    return {};
+}
+
+QByteArray KNSStandInProvider::providers() const
+{
+    const QByteArray location = "http://127.0.0.1:" + QByteArray::number(serverPort()) + "/ocs/v1/";
+    return "<?xml version=\"1.0\"?>\n<providers><provider><id>stand-in</id><location>" + location
+        + "</location><name>Stand-in</name><termsofuse></termsofuse><register></register>"
+          "<services><content ocsversion=\"1.6\"/></services></provider></providers>\n";
+}
+
+QByteArray KNSStandInProvider::categories() const
+{
+    QByteArray data;
+    for (int i = 0; i < m_categories.size(); ++i) {
+        data += "<category><id>" + QByteArray::number(i + 1) + "</id><name>" + m_categories.at(i).toUtf8() + "</name><display_name>"
+            + m_categories.at(i).toUtf8() + " (stand-in)</display_name></category>";
+    }
+    return ocsDocument(data);
+}
+
+QByteArray KNSStandInProvider::contents(const QUrl &url) const
+{
+    const QUrlQuery query(url);
+    const auto categoryIds = query.queryItemValue(u"categories"_s).split(QLatin1Char('x'), Qt::SkipEmptyParts);
+    const QString search = query.queryItemValue(u"search"_s);
+    const int page = query.queryItemValue(u"page"_s).toInt();
+    const int pageSize = std::max(1, query.queryItemValue(u"pagesize"_s).toInt());
+
+    QList<int> ids;
+    for (const QString &categoryId : categoryIds) {
+        const int category = categoryId.toInt();
+        if (category < 1 || category > m_categories.size()) {
+            continue;
+        }
+        for (int entry = 0; entry < m_entriesPerCategory; ++entry) {
+            const int id = category * s_entryIdStride + entry;
+            if (search.isEmpty() || QString::number(id).contains(search)) {
+                ids += id;
+            }
+        }
+    }
+
+    QByteArray data;
+    for (int id : ids.mid(page * pageSize, pageSize)) {
+        data += content(id);
+    }
+    return ocsDocument(data, ids.size(), pageSize);
+}
+
+QByteArray KNSStandInProvider::content(int id) const
+{
+    const int category = id / s_entryIdStride;
+    const QByteArray number = QByteArray::number(id);
+    const QByteArray base = "http://127.0.0.1:" + QByteArray::number(serverPort());
+    return "<content details=\"full\"><id>" + number + "</id><name>Entry " + number + "</name><version>1.0</version><typeid>"
+        + QByteArray::number(category) + "</typeid><typename>" + m_categories.value(category - 1).toUtf8()
+        + "</typename><personid>stand-in</personid><created>2026-01-01T00:00:00+00:00</created><changed>2026-01-01T00:00:00+00:00</changed>"
+          "<downloads>1</downloads><score>50</score><summary>Stand-in entry</summary><description>Stand-in entry</description>"
+          "<license>GPL</license><detailpage>"
+        + base + "/entries/" + number + "</detailpage><downloadlink1>" + base + "/downloads/" + number + ".tar.gz</downloadlink1><downloadname1>" + number
+        + ".tar.gz</downloadname1><previewpic1>" + base + "/previews/" + number + ".png</previewpic1></content>";
+}
+
+#include "moc_KNSStandInProvider.cpp"
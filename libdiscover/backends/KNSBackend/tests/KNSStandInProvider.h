@@ -0,0 +1,47 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QStringList>
+#include <QTcpServer>
+#include <QUrl>
+
+/**
+ * Serves a providers file and an OCS content service on localhost,
+ * so that the KNS backend can be exercised without the network.
+ *
+ * Every category it's given has @p entriesPerCategory entries.
+ */
+class KNSStandInProvider : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit KNSStandInProvider(const QStringList &categories, int entriesPerCategory, QObject *parent = nullptr);
+
+    bool start();
+    QUrl providersUrl(const QString &variant = {}) const;
+
+    /// How many times each path was asked for
+    QHash<QString, int> requests() const
+    {
+        return m_requests;
+    }
+    int requestCount() const;
+
+private:
+    void readRequest(QTcpSocket *socket);
+    QByteArray respond(const QUrl &url) const;
+    QByteArray providers() const;
+    QByteArray categories() const;
+    QByteArray contents(const QUrl &url) const;
+    QByteArray content(int id) const;
+
+    const QStringList m_categories;
+    const int m_entriesPerCategory;
+    QHash<QString, int> m_requests;
+};
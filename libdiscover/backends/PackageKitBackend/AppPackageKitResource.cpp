@@ -82,6 +82,11 @@ QStringList AppPackageKitResource::mimetypes() const
     return m_appdata.provided(AppStream::Provided::KindMimetype).items();
 }
 
+QStringList AppPackageKitResource::keywords() const
+{
+    return m_appdata.keywords();
+}
+
 static constexpr auto s_addonKinds = {AppStream::Component::KindAddon, AppStream::Component::KindCodec};
 
 bool AppPackageKitResource::hasCategory(const QString &category) const
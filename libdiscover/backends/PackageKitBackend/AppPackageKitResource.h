@@ -22,6 +22,7 @@ public:
     QString name() const override;
     QVariant icon() const override;
     QStringList mimetypes() const override;
+    QStringList keywords() const override;
     bool hasCategory(const QString &category) const override;
     QString longDescription() override;
     QUrl url() const override;
@@ -0,0 +1,329 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "PKRequestScheduler.h"
+#include "libdiscover_backend_packagekit_debug.h"
+
+#include <PackageKit/Daemon>
+
+#include <algorithm>
+#include <memory>
+
+using namespace std::chrono_literals;
+
+// Bounds what a single transaction asks for
+static constexpr qsizetype s_chunkSize = 500;
+// Chunks of a kind that run at the same time
+static constexpr int s_maxRunning = 4;
+
+PKRequestBatch::PKRequestBatch(PKRequestScheduler *scheduler)
+    : QObject(scheduler)
+    , m_pending(1) // Released when the batch is sent
+{
+    m_queued.start();
+}
+
+void PKRequestBatch::dependOn(PKRequestBatch *batch)
+{
+    if (batch == this || m_dependencies.contains(batch)) {
+        return;
+    }
+    m_dependencies.insert(batch);
+    ++m_pending;
+    connect(batch, &PKRequestBatch::allFinished, this, &PKRequestBatch::release);
+}
+
+void PKRequestBatch::release()
+{
+    Q_ASSERT(m_pending > 0);
+    if (--m_pending == 0) {
+        Q_EMIT allFinished();
+        deleteLater();
+    }
+}
+
+PKRequestScheduler::PKRequestScheduler(QObject *parent)
+    : QObject(parent)
+{
+    for (auto kind : {Resolve, Details, UpdateDetails}) {
+        auto &timer = m_queues[kind].timer;
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, this, [this, kind] {
+            flush(kind);
+        });
+    }
+}
+
+std::chrono::milliseconds PKRequestScheduler::window(const Queue &queue)
+{
+    // Waiting longer can't make it any better
+    if (queue.waiting || queue.items.size() >= s_chunkSize) {
+        return 0ms;
+    }
+    // Give the requests that usually follow, like those of the rest of a page, the time to join
+    return queue.items.size() < 50 ? 250ms : 100ms;
+}
+
+PKRequestBatch *PKRequestScheduler::request(Kind kind, const QStringList &items, bool waiting)
+{
+    if (items.isEmpty()) {
+        return nullptr;
+    }
+
+    auto &queue = m_queues[kind];
+    if (!queue.batch) {
+        queue.batch = new PKRequestBatch(this);
+        if (kind == Resolve) {
+            connect(queue.batch, &PKRequestBatch::allFinished, this, &PKRequestScheduler::resolveFinished);
+        }
+    }
+    for (const QString &item : items) {
+        if (!queue.queued.contains(item)) {
+            queue.queued.insert(item);
+            queue.items += item;
+        }
+    }
+    queue.waiting |= waiting;
+
+    // Only ever brought forward, so that a steady trickle of requests can't hold the others back
+    const auto window = PKRequestScheduler::window(queue);
+    if (!queue.timer.isActive() || queue.timer.remainingTimeAsDuration() > window) {
+        queue.timer.start(window);
+    }
+    return queue.batch;
+}
+
+void PKRequestScheduler::flush(Kind kind)
+{
+    auto &queue = m_queues[kind];
+    PKRequestBatch *batch = queue.batch;
+    queue.batch = nullptr;
+    queue.queued.clear();
+    queue.waiting = false;
+    batch->m_items = std::exchange(queue.items, {});
+
+    QStringList toSend;
+    for (const QString &item : std::as_const(batch->m_items)) {
+        if (replay(kind, item)) {
+            continue;
+        }
+        if (auto inFlight = queue.inFlight.value(item)) {
+            batch->dependOn(inFlight);
+            continue;
+        }
+        toSend += item;
+    }
+
+    for (qsizetype i = 0; i < toSend.size(); i += s_chunkSize) {
+        const auto chunk = toSend.mid(i, s_chunkSize);
+        for (const QString &item : chunk) {
+            queue.inFlight.insert(item, batch);
+        }
+        queue.chunks.append({batch, chunk, {}});
+        ++batch->m_pending;
+    }
+    qCDebug(LIBDISCOVER_BACKEND_PACKAGEKIT_LOG) << kind << "requests:" << batch->m_items.size() << "queued for" << batch->m_queued.elapsed() << "ms,"
+                                                << toSend.size() << "sent," << queue.chunks.size() << "chunks waiting";
+    startChunks(kind);
+    batch->release();
+}
+
+void PKRequestScheduler::startChunks(Kind kind)
+{
+    auto &queue = m_queues[kind];
+    while (queue.running.size() < s_maxRunning && !queue.chunks.isEmpty()) {
+        Chunk chunk = queue.chunks.takeFirst();
+        chunk.sent.start();
+        const QStringList items = chunk.items;
+        queue.running.append(std::move(chunk));
+        send(kind, items);
+    }
+}
+
+void PKRequestScheduler::answered(Kind kind, const QStringList &chunk, bool success)
+{
+    auto &queue = m_queues[kind];
+    const auto it = std::find_if(queue.running.begin(), queue.running.end(), [&chunk](const Chunk &running) {
+        return running.items == chunk;
+    });
+    if (it == queue.running.end()) {
+        return;
+    }
+    const Chunk running = *it;
+    queue.running.erase(it);
+
+    for (const QString &item : chunk) {
+        queue.inFlight.remove(item);
+    }
+    // Asking again won't find anything else
+    if (kind == Resolve && success) {
+        for (const QString &item : chunk) {
+            if (!m_resolved.contains(item)) {
+                m_resolved.insert(item, {});
+            }
+        }
+    }
+    qCDebug(LIBDISCOVER_BACKEND_PACKAGEKIT_LOG) << kind << "chunk of" << chunk.size() << "answered in" << running.sent.elapsed() << "ms,"
+                                                << queue.items.size() << "queued";
+
+    if (running.batch) {
+        running.batch->release();
+    }
+    startChunks(kind);
+}
+
+void PKRequestScheduler::resolved(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch)
+{
+    m_resolved[PackageKit::Daemon::packageName(packageId)].append(ResolvedPackage{info, packageId, summary, arch});
+    Q_EMIT packageResolved(info, packageId, summary, arch);
+}
+
+void PKRequestScheduler::detailsReceived(const PackageKit::Details &details)
+{
+    m_details.insert(details.packageId(), details);
+    Q_EMIT detailsFound(details);
+}
+
+void PKRequestScheduler::send(Kind kind, const QStringList &chunk)
+{
+    QList<PackageKit::Transaction *> transactions;
+    switch (kind) {
+    case Resolve: {
+        const auto resolve = [this, &chunk](PackageKit::Transaction::Filter filter, bool arch) {
+            auto transaction = PackageKit::Daemon::resolve(chunk, filter);
+            connect(transaction,
+                    &PackageKit::Transaction::package,
+                    this,
+                    [this, arch](PackageKit::Transaction::Info info, const QString &packageId, const QString &summary) {
+                        resolved(info, packageId, summary, arch);
+                    });
+            connect(transaction, &PackageKit::Transaction::errorCode, this, &PKRequestScheduler::transactionError);
+            return transaction;
+        };
+        transactions = {resolve(PackageKit::Transaction::FilterArch, true), resolve(PackageKit::Transaction::FilterNotArch, false)};
+        break;
+    }
+    case Details: {
+        auto transaction = PackageKit::Daemon::getDetails(chunk);
+        connect(transaction, &PackageKit::Transaction::details, this, &PKRequestScheduler::detailsReceived);
+        connect(transaction, &PackageKit::Transaction::errorCode, this, &PKRequestScheduler::transactionError);
+        transactions = {transaction};
+        break;
+    }
+    case UpdateDetails: {
+        auto transaction = PackageKit::Daemon::getUpdatesDetails(chunk);
+        connect(transaction,
+                &PackageKit::Transaction::updateDetail,
+                this,
+                [this](const QString &packageID,
+                       const QStringList &updates,
+                       const QStringList &obsoletes,
+                       const QStringList &vendorUrls,
+                       const QStringList &bugzillaUrls,
+                       const QStringList &cveUrls,
+                       PackageKit::Transaction::Restart restart,
+                       const QString &updateText,
+                       const QString &changelog,
+                       PackageKit::Transaction::UpdateState state,
+                       const QDateTime &issued,
+                       const QDateTime &updated) {
+                    const UpdateDetail detail{packageID, updates, obsoletes, vendorUrls, bugzillaUrls, cveUrls, restart, updateText, changelog, state, issued, updated};
+                    m_updateDetails.insert(packageID, detail);
+                    replay(UpdateDetails, packageID);
+                });
+        connect(transaction, &PackageKit::Transaction::errorCode, this, [this, chunk](PackageKit::Transaction::Error error, const QString &message) {
+            qWarning() << "PackageKitBackend: Error fetching updates:" << error << message;
+            Q_EMIT updateDetailsFailed(chunk);
+        });
+        transactions = {transaction};
+        break;
+    }
+    }
+
+    auto remaining = std::make_shared<qsizetype>(transactions.size());
+    auto success = std::make_shared<bool>(true);
+    for (auto transaction : std::as_const(transactions)) {
+        connect(transaction, &PackageKit::Transaction::finished, this, [this, kind, chunk, remaining, success](PackageKit::Transaction::Exit exit) {
+            if (exit != PackageKit::Transaction::ExitSuccess) {
+                qCWarning(LIBDISCOVER_BACKEND_PACKAGEKIT_LOG) << kind << "request failed" << exit;
+                *success = false;
+            }
+            if (--*remaining == 0) {
+                answered(kind, chunk, *success);
+            }
+        });
+    }
+}
+
+bool PKRequestScheduler::replay(Kind kind, const QString &item)
+{
+    switch (kind) {
+    case Resolve: {
+        const auto it = m_resolved.constFind(item);
+        if (it == m_resolved.cend()) {
+            return false;
+        }
+        for (const auto &package : *it) {
+            Q_EMIT packageResolved(package.info, package.packageId, package.summary, package.arch);
+        }
+        return true;
+    }
+    case Details: {
+        const auto it = m_details.constFind(item);
+        if (it == m_details.cend()) {
+            return false;
+        }
+        Q_EMIT detailsFound(*it);
+        return true;
+    }
+    case UpdateDetails: {
+        const auto it = m_updateDetails.constFind(item);
+        if (it == m_updateDetails.cend()) {
+            return false;
+        }
+        Q_EMIT updateDetailFound(it->packageId,
+                                 it->updates,
+                                 it->obsoletes,
+                                 it->vendorUrls,
+                                 it->bugzillaUrls,
+                                 it->cveUrls,
+                                 it->restart,
+                                 it->updateText,
+                                 it->changelog,
+                                 it->state,
+                                 it->issued,
+                                 it->updated);
+        return true;
+    }
+    }
+    Q_UNREACHABLE();
+}
+
+void PKRequestScheduler::forget(Kind kind, const QStringList &items)
+{
+    for (const QString &item : items) {
+        switch (kind) {
+        case Resolve:
+            m_resolved.remove(item);
+            break;
+        case Details:
+            m_details.remove(item);
+            break;
+        case UpdateDetails:
+            m_updateDetails.remove(item);
+            break;
+        }
+    }
+}
+
+void PKRequestScheduler::forgetAll()
+{
+    m_resolved.clear();
+    m_details.clear();
+    m_updateDetails.clear();
+}
+
+#include "moc_PKRequestScheduler.cpp"
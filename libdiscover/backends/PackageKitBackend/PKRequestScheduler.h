@@ -0,0 +1,182 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <PackageKit/Details>
+#include <PackageKit/Transaction>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include <chrono>
+
+class PKRequestScheduler;
+
+/**
+ * \class PKRequestBatch  PKRequestScheduler.h "PKRequestScheduler.h"
+ *
+ * \brief Requests of one kind sent to PackageKit together
+ *
+ * It's destroyed once all of them are answered.
+ */
+class PKRequestBatch : public QObject
+{
+    Q_OBJECT
+public:
+    const QStringList &items() const
+    {
+        return m_items;
+    }
+
+Q_SIGNALS:
+    void allFinished();
+
+private:
+    friend class PKRequestScheduler;
+    explicit PKRequestBatch(PKRequestScheduler *scheduler);
+
+    void dependOn(PKRequestBatch *batch);
+    void release();
+
+    QStringList m_items;
+    QSet<PKRequestBatch *> m_dependencies;
+    int m_pending = 0;
+    QElapsedTimer m_queued;
+};
+
+/**
+ * \class PKRequestScheduler  PKRequestScheduler.h "PKRequestScheduler.h"
+ *
+ * \brief Coalesces resolve, details and update details requests
+ *
+ * Requests are queued by kind for a short window, which is shorter the more
+ * requests there are and skipped when a view waits for them. Then they are
+ * sent in bounded chunks, a few transactions at a time.
+ *
+ * What's in flight isn't asked again, and answers are kept for the session:
+ * asking again replays them.
+ *
+ * Answers are delivered through the signals, replayed ones too.
+ */
+class PKRequestScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Kind {
+        Resolve,
+        Details,
+        UpdateDetails,
+    };
+    Q_ENUM(Kind)
+
+    explicit PKRequestScheduler(QObject *parent = nullptr);
+
+    /**
+     * Queues @p items: package names to resolve, package ids otherwise.
+     *
+     * @p waiting tells that a view is waiting for the answers.
+     * Returns the batch that answers them, null if @p items is empty.
+     */
+    PKRequestBatch *request(Kind kind, const QStringList &items, bool waiting = false);
+
+    /// Drops the answers about @p items, e.g. because a transaction changed their packages
+    void forget(Kind kind, const QStringList &items);
+    /// Drops every answer, e.g. because the repositories were refreshed
+    void forgetAll();
+
+    qsizetype queueDepth(Kind kind) const
+    {
+        return m_queues[kind].items.size();
+    }
+
+Q_SIGNALS:
+    void packageResolved(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch);
+    /// Every package name of a request batch was resolved
+    void resolveFinished();
+    void detailsFound(const PackageKit::Details &details);
+    void updateDetailFound(const QString &packageID,
+                           const QStringList &updates,
+                           const QStringList &obsoletes,
+                           const QStringList &vendorUrls,
+                           const QStringList &bugzillaUrls,
+                           const QStringList &cveUrls,
+                           PackageKit::Transaction::Restart restart,
+                           const QString &updateText,
+                           const QString &changelog,
+                           PackageKit::Transaction::UpdateState state,
+                           const QDateTime &issued,
+                           const QDateTime &updated);
+    void updateDetailsFailed(const QStringList &packageIds);
+    void transactionError(PackageKit::Transaction::Error error, const QString &message);
+
+protected:
+    /**
+     * Asks PackageKit about @p chunk. Packages and details are handed to
+     * resolved() and detailsReceived() as they come, then answered() is
+     * called once everything about @p chunk is there.
+     */
+    virtual void send(Kind kind, const QStringList &chunk);
+    void answered(Kind kind, const QStringList &chunk, bool success);
+
+    void resolved(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch);
+    void detailsReceived(const PackageKit::Details &details);
+
+private:
+    struct UpdateDetail {
+        QString packageId;
+        QStringList updates;
+        QStringList obsoletes;
+        QStringList vendorUrls;
+        QStringList bugzillaUrls;
+        QStringList cveUrls;
+        PackageKit::Transaction::Restart restart;
+        QString updateText;
+        QString changelog;
+        PackageKit::Transaction::UpdateState state;
+        QDateTime issued;
+        QDateTime updated;
+    };
+    struct ResolvedPackage {
+        PackageKit::Transaction::Info info;
+        QString packageId;
+        QString summary;
+        bool arch;
+    };
+    struct Chunk {
+        QPointer<PKRequestBatch> batch;
+        QStringList items;
+        QElapsedTimer sent;
+    };
+    struct Queue {
+        QStringList items;
+        QSet<QString> queued;
+        bool waiting = false;
+        QTimer timer;
+        QPointer<PKRequestBatch> batch;
+        // What's been sent, until answered
+        QHash<QString, QPointer<PKRequestBatch>> inFlight;
+        // Chunks waiting for a free transaction slot
+        QList<Chunk> chunks;
+        QList<Chunk> running;
+    };
+
+    void flush(Kind kind);
+    void startChunks(Kind kind);
+    bool replay(Kind kind, const QString &item);
+    static std::chrono::milliseconds window(const Queue &queue);
+
+    Queue m_queues[3];
+
+    QHash<QString, QList<ResolvedPackage>> m_resolved;
+    QHash<QString, PackageKit::Details> m_details;
+    QHash<QString, UpdateDetail> m_updateDetails;
+};
@@ -6,6 +6,7 @@
 
 #include "PKTransaction.h"
 #include "LocalFilePKResource.h"
+#include "PKRequestScheduler.h"
 #include "PackageKitBackend.h"
 #include "PackageKitMessages.h"
 #include "PackageKitResource.h"
@@ -275,9 +276,12 @@ void PKTransaction::submitResolve()
 {
     const auto backend = qobject_cast<PackageKitBackend *>(resource()->backend());
     QStringList needResolving;
+    // Every package the transaction touched, dependencies included, whether or not a resource shows it
+    QStringList changed;
     for (auto it = m_newPackageStates.constBegin(), itEnd = m_newPackageStates.constEnd(); it != itEnd; ++it) {
         const auto &itValue = it.value();
         for (const auto &pkgid : itValue) {
+            changed << PackageKit::Daemon::packageName(pkgid);
             const auto resources = backend->resourcesByPackageName(PackageKit::Daemon::packageName(pkgid));
             for (auto resource : resources) {
                 auto pkResource = qobject_cast<PackageKitResource *>(resource);
@@ -288,6 +292,10 @@ void PKTransaction::submitResolve()
         }
     }
     needResolving.removeDuplicates();
+    // What was resolved before the transaction is outdated now
+    changed += needResolving;
+    changed.removeDuplicates();
+    backend->requests()->forget(PKRequestScheduler::Resolve, changed);
     backend->resolvePackages(needResolving);
 }
 
@@ -9,10 +9,11 @@
 #include "PackageKitBackend.h"
 #include "AppPackageKitResource.h"
 #include "LocalFilePKResource.h"
-#include "PKResolveTransaction.h"
+#include "PKRequestScheduler.h"
 #include "PKTransaction.h"
 #include "PackageKitSourcesBackend.h"
 #include "PackageKitUpdater.h"
+#include "PackageToAppMap.h"
 #include <AppStreamQt/release.h>
 #include <AppStreamQt/systeminfo.h>
 #include <AppStreamQt/utils.h>
@@ -116,15 +117,9 @@ QString PackageKitBackend::locateService(const QString &filename)
     return QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1StringView("applications/") + filename);
 }
 
-Delay::Delay()
+static QString packageToAppPath()
 {
-    m_delay.setSingleShot(true);
-    m_delay.setInterval(100);
-
-    connect(&m_delay, &QTimer::timeout, this, [this] {
-        Q_EMIT perform(m_pkgids);
-        m_pkgids.clear();
-    });
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1StringView("/packagekit/package-to-app");
 }
 
 PackageKitBackend::PackageKitBackend(QObject *parent)
@@ -134,64 +129,21 @@ PackageKitBackend::PackageKitBackend(QObject *parent)
     , m_refresher(nullptr)
     , m_isFetching(0)
     , m_reviews(OdrsReviewsBackend::global())
+    , m_requests(new PKRequestScheduler(this))
 {
+    connect(m_requests, &PKRequestScheduler::packageResolved, this, &PackageKitBackend::addPackage);
+    connect(m_requests, &PKRequestScheduler::resolveFinished, this, &PackageKitBackend::getPackagesFinished);
+    connect(m_requests, &PKRequestScheduler::detailsFound, this, &PackageKitBackend::packageDetails);
+    connect(m_requests, &PKRequestScheduler::updateDetailFound, this, &PackageKitBackend::updateDetail);
+    connect(m_requests, &PKRequestScheduler::updateDetailsFailed, this, &PackageKitBackend::updateDetailsFailed);
+    connect(m_requests, &PKRequestScheduler::transactionError, this, &PackageKitBackend::transactionError);
+
     QTimer *t = new QTimer(this);
     connect(t, &QTimer::timeout, this, &PackageKitBackend::checkForUpdates);
     t->setInterval(60 * 60 * 1000);
     t->setSingleShot(false);
     t->start();
 
-    connect(&m_details, &Delay::perform, this, &PackageKitBackend::performDetailsFetch);
-    connect(&m_updateDetails, &Delay::perform, this, [this](const QSet<QString> &pkgids) {
-        PackageKit::Transaction *t = PackageKit::Daemon::getUpdatesDetails(kSetToList(pkgids));
-        connect(t,
-                &PackageKit::Transaction::updateDetail,
-                this,
-                [this](const QString &packageID,
-                       const QStringList &updates,
-                       const QStringList &obsoletes,
-                       const QStringList &vendorUrls,
-                       const QStringList &bugzillaUrls,
-                       const QStringList &cveUrls,
-                       PackageKit::Transaction::Restart restart,
-                       const QString &updateText,
-                       const QString &changelog,
-                       PackageKit::Transaction::UpdateState state,
-                       const QDateTime &issued,
-                       const QDateTime &updated) {
-                    const QSet<AbstractResource *> resources = resourcesByPackageName(PackageKit::Daemon::packageName(packageID));
-                    for (auto r : resources) {
-                        PackageKitResource *resource = qobject_cast<PackageKitResource *>(r);
-                        if (resource->containsPackageId(packageID)) {
-                            resource->updateDetail(packageID,
-                                                   updates,
-                                                   obsoletes,
-                                                   vendorUrls,
-                                                   bugzillaUrls,
-                                                   cveUrls,
-                                                   restart,
-                                                   updateText,
-                                                   changelog,
-                                                   state,
-                                                   issued,
-                                                   updated);
-                        }
-                    }
-                });
-        connect(t, &PackageKit::Transaction::errorCode, this, [this, pkgids](PackageKit::Transaction::Error err, const QString &error) {
-            qWarning() << "PackageKitBackend: Error fetching updates:" << err << error;
-            for (const QString &pkgid : pkgids) {
-                const QSet<AbstractResource *> resources = resourcesByPackageName(PackageKit::Daemon::packageName(pkgid));
-                for (auto r : resources) {
-                    PackageKitResource *resource = qobject_cast<PackageKitResource *>(r);
-                    if (resource->containsPackageId(pkgid)) {
-                        Q_EMIT resource->changelogFetched(QString());
-                    }
-                }
-            }
-        });
-    });
-
     connect(PackageKit::Daemon::global(), &PackageKit::Daemon::restartScheduled, this, [this] {
         m_updater->setNeedsReboot(true);
     });
@@ -210,6 +162,12 @@ PackageKitBackend::PackageKitBackend(QObject *parent)
 
     SourcesModel::global()->addSourcesBackend(new PackageKitSourcesBackend(this));
 
+    const auto catalogsTime = PackageToAppMap::catalogsTime();
+    m_packages.packageToApp = PackageToAppMap::load(packageToAppPath(), catalogsTime);
+    if (!m_packages.packageToApp.isEmpty()) {
+        m_packageToAppTime = catalogsTime;
+    }
+
     reloadPackageList();
 
     acquireFetching(true);
@@ -343,6 +301,23 @@ void PackageKitBackend::reloadPackageList()
             m_appstreamInitialized = true;
             Q_EMIT loadedAppStream();
         }
+
+        // Now that their components can be found
+        const auto pendingPackages = std::exchange(m_pendingPackages, {});
+        for (auto [packageName, pending] : KeyValueRange(pendingPackages)) {
+            const auto resources = resourcesByPackageName(packageName);
+            if (resources.isEmpty()) {
+                // Its application isn't in the catalogs anymore
+                m_packagesToAdd.insert(makePackageId(packageName), pending);
+                continue;
+            }
+            for (auto resource : resources) {
+                static_cast<PackageKitResource *>(resource)->addPackagesOf(pending);
+            }
+            pending->deleteLater();
+        }
+        includePackagesToAdd();
+        updatePackageToApp();
         acquireFetching(false);
 
         const auto distroComponents = m_appdata->componentsById(AppStream::SystemInfo::currentDistroComponentId());
@@ -404,27 +379,39 @@ AppPackageKitResource *PackageKitBackend::addComponent(const AppStream::Componen
     }
 
     for (const auto &pkg : pkgNames) {
-        m_packages.packageToApp[pkg] += component.id();
+        auto &appIds = m_packages.packageToApp[pkg];
+        if (!appIds.contains(component.id())) {
+            appIds += component.id();
+        }
     }
     return resource;
 }
 
-PKResolveTransaction *PackageKitBackend::resolvePackages(const QStringList &packageNames)
+void PackageKitBackend::updatePackageToApp()
 {
-    if (packageNames.isEmpty()) {
-        return nullptr;
+    const auto catalogsTime = PackageToAppMap::catalogsTime();
+    if (catalogsTime == m_packageToAppTime) {
+        return;
     }
 
-    if (!m_resolveTransaction) {
-        m_resolveTransaction = new PKResolveTransaction(this);
-        connect(m_resolveTransaction, &PKResolveTransaction::allFinished, this, &PackageKitBackend::getPackagesFinished);
-        connect(m_resolveTransaction, &PKResolveTransaction::started, this, [this] {
-            m_resolveTransaction = nullptr;
+    m_appdata->components()
+        .then(&m_threadPool,
+              [catalogsTime](const AppStream::ComponentBox &components) {
+                  const auto map = PackageToAppMap::fromComponents(components);
+                  if (!PackageToAppMap::save(packageToAppPath(), catalogsTime, map)) {
+                      qCWarning(LIBDISCOVER_BACKEND_PACKAGEKIT_LOG) << "Could not save the package map" << packageToAppPath();
+                  }
+                  return map;
+              })
+        .then(this, [this, catalogsTime](const PackageToAppMap::Map &map) {
+            m_packages.packageToApp.insert(map);
+            m_packageToAppTime = catalogsTime;
         });
-    }
+}
 
-    m_resolveTransaction->addPackageNames(packageNames);
-    return m_resolveTransaction;
+PKRequestBatch *PackageKitBackend::resolvePackages(const QStringList &packageNames, bool waiting)
+{
+    return m_requests->request(PKRequestScheduler::Resolve, packageNames, waiting);
 }
 
 void PackageKitBackend::setRefresher(PackageKit::Transaction *refresh)
@@ -454,6 +441,9 @@ void PackageKitBackend::fetchUpdates()
         return;
     }
 
+    // Whatever was installed, updated or refreshed since makes the answers we have stale
+    m_requests->forgetAll();
+
     PackageKit::Transaction *tUpdates = PackageKit::Daemon::getUpdates();
     connect(tUpdates, &PackageKit::Transaction::finished, this, &PackageKitBackend::getUpdatesFinished);
     connect(tUpdates, &PackageKit::Transaction::package, this, &PackageKitBackend::addPackageToUpdate);
@@ -463,16 +453,6 @@ void PackageKitBackend::fetchUpdates()
     setRefresher(tUpdates);
 }
 
-void PackageKitBackend::addPackageArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary)
-{
-    addPackage(info, packageId, summary, true);
-}
-
-void PackageKitBackend::addPackageNotArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary)
-{
-    addPackage(info, packageId, summary, false);
-}
-
 void PackageKitBackend::addPackage(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch)
 {
     if (PackageKit::Daemon::packageArch(packageId) == QLatin1String("source")) {
@@ -483,7 +463,12 @@ void PackageKitBackend::addPackage(PackageKit::Transaction::Info info, const QSt
     }
     const QString packageName = PackageKit::Daemon::packageName(packageId);
     QSet<AbstractResource *> r = resourcesByPackageName(packageName);
-    if (r.isEmpty()) {
+    if (r.isEmpty() && !m_appdataLoaded && m_packages.packageToApp.contains(packageName)) {
+        // It belongs to an application, its component will take over instead of listing it as a package
+        auto pk = new PackageKitResource(packageName, summary, this);
+        r = {pk};
+        m_pendingPackages.insert(packageName, pk);
+    } else if (r.isEmpty()) {
         auto pk = new PackageKitResource(packageName, summary, this);
         r = {pk};
         m_packagesToAdd.insert(makePackageId(packageName), pk);
@@ -507,6 +492,7 @@ void PackageKitBackend::includePackagesToAdd()
     acquireFetching(true);
     for (auto [id, resource] : KeyValueRange(std::as_const(m_packagesToAdd))) {
         m_packages.packages[id] = resource;
+        watchResource(resource);
     }
     m_packagesToAdd.clear();
     for (auto pkResource : std::as_const(m_packagesToDelete)) {
@@ -514,6 +500,7 @@ void PackageKitBackend::includePackagesToAdd()
         for (const auto &pkg : pkgs) {
             auto resource = m_packages.packages.take(makePackageId(pkg));
             if (resource) {
+                unindexResource(resource);
                 Q_EMIT resourceRemoved(resource);
                 resource->deleteLater();
             }
@@ -523,6 +510,53 @@ void PackageKitBackend::includePackagesToAdd()
     acquireFetching(false);
 }
 
+void PackageKitBackend::watchResource(AbstractResource *resource)
+{
+    connect(resource, &AbstractResource::stateChanged, this, &PackageKitBackend::resourceStateChanged, Qt::UniqueConnection);
+    indexResource(resource);
+}
+
+void PackageKitBackend::resourceStateChanged()
+{
+    // Only resources in m_packages are connected
+    indexResource(qobject_cast<AbstractResource *>(sender()));
+}
+
+void PackageKitBackend::indexResource(AbstractResource *resource)
+{
+    const auto state = resource->state();
+    if (state == AbstractResource::Broken) {
+        m_unresolved.insert(resource);
+    } else {
+        m_unresolved.remove(resource);
+    }
+
+    if (state < AbstractResource::Installed || qobject_cast<PackageKitResource *>(resource)->isCritical()) {
+        m_installed.remove(resource);
+    } else if (!m_installed.contains(resource)) {
+        m_installed.insert(resource, {resource->name().toCaseFolded(), resource->packageName().toCaseFolded()});
+    }
+}
+
+void PackageKitBackend::unindexResource(AbstractResource *resource)
+{
+    disconnect(resource, &AbstractResource::stateChanged, this, &PackageKitBackend::resourceStateChanged);
+    m_installed.remove(resource);
+    m_unresolved.remove(resource);
+}
+
+QVector<AbstractResource *> PackageKitBackend::installedMatching(const QString &search) const
+{
+    const QString folded = search.toCaseFolded();
+    QVector<AbstractResource *> ret;
+    for (const auto &[resource, entry] : m_installed.asKeyValueRange()) {
+        if (entry.matches(folded)) {
+            ret += resource;
+        }
+    }
+    return ret;
+}
+
 void PackageKitBackend::transactionError(PackageKit::Transaction::Error, const QString &message)
 {
     qWarning() << "Transaction error:" << message << sender();
@@ -578,6 +612,7 @@ T PackageKitBackend::resourcesByPackageNames(const W &pkgnames) const
                 ret += resource;
             }
         } else {
+            bool found = false;
             for (const QString &app_id : app_names) {
                 const auto appId = makeAppId(app_id);
                 auto resource = m_packages.packages.value(appId);
@@ -586,10 +621,16 @@ T PackageKitBackend::resourcesByPackageNames(const W &pkgnames) const
                 }
                 if (resource) {
                     ret += resource;
-                } else {
+                    found = true;
+                } else if (m_appdataLoaded) {
                     ret += resourcesByComponents<T>(m_appdata->componentsByBundleId(AppStream::Bundle::KindPackage, pkg_name, false).result());
                 }
             }
+            if (!found && !m_appdataLoaded) {
+                if (auto pending = m_pendingPackages.value(pkg_name)) {
+                    ret += pending;
+                }
+            }
         }
     }
     return ret;
@@ -668,28 +709,45 @@ public:
             return;
         }
 
-        Q_ASSERT(resources.size() == QSet(resources.constBegin(), resources.constEnd()).size());
-        Q_ASSERT(QThread::currentThread() == backend->thread());
-        const auto toResolve = kFilter<QVector<StreamResult>>(resources, needsResolveFilter);
-        if (!toResolve.isEmpty()) {
-            auto transaction = backend->resolvePackages(kTransform<QStringList>(toResolve, [](const StreamResult &result) {
-                return result.resource->packageName();
-            }));
-            if (waitForResolved) {
-                Q_ASSERT(transaction);
-                connect(transaction, &QObject::destroyed, this, [this, resources] {
-                    Q_EMIT resourcesFound(resources);
-                    finish();
-                });
-                return;
-            }
+        auto transaction = resolve(resources, waitForResolved);
+        if (transaction && waitForResolved) {
+            connect(transaction, &QObject::destroyed, this, [this, resources] {
+                Q_EMIT resourcesFound(resources);
+                finish();
+            });
+            return;
         }
 
         Q_EMIT resourcesFound(resources);
         finish();
     }
 
+    /// Sends @p resources without finishing the stream
+    void addResources(const QVector<StreamResult> &resources)
+    {
+        if (resources.isEmpty()) {
+            return;
+        }
+
+        resolve(resources);
+        Q_EMIT resourcesFound(resources);
+    }
+
 private:
+    PKRequestBatch *resolve(const QVector<StreamResult> &resources, bool waiting = false)
+    {
+        Q_ASSERT(resources.size() == QSet(resources.constBegin(), resources.constEnd()).size());
+        Q_ASSERT(QThread::currentThread() == backend->thread());
+        const auto toResolve = kFilter<QVector<StreamResult>>(resources, needsResolveFilter);
+        if (toResolve.isEmpty()) {
+            return nullptr;
+        }
+        return backend->resolvePackages(kTransform<QStringList>(toResolve, [](const StreamResult &result) {
+            return result.resource->packageName();
+        }),
+                                        waiting);
+    }
+
     PackageKitBackend *const backend;
 };
 
@@ -734,71 +792,83 @@ ResultsStream *PackageKitBackend::search(const AbstractResourcesBackend::Filters
                                  kTransform<QVector<StreamResult>>(upgradeablePackages())); // No need for it to be a PKResultsStream
     } else if (filter.state == AbstractResource::Installed) {
         return deferredResultStream(u"PackageKitStream-installed"_s, [this, filter = filter](PKResultsStream *stream) {
-            loadAllPackages();
+            [](PackageKitBackend *self, QPointer<PKResultsStream> stream, AbstractResourcesBackend::Filters filter) -> QCoro::Task<> {
+                co_await self->loadAllPackages();
+                if (stream.isNull()) {
+                    co_return;
+                }
 
-            const auto toResolve = kFilter<QVector<AbstractResource *>>(m_packages.packages, needsResolveFilter);
+                // Read from the index rather than going through every package, this runs for every keystroke
+                const auto resolved = self->installedMatching(filter.search);
+                if (!resolved.isEmpty()) {
+                    Q_EMIT stream->resourcesFound(kTransform<QVector<StreamResult>>(resolved, [](auto resource) {
+                        return StreamResult(resource, 0);
+                    }));
+                }
 
-            auto installedAndNameFilter = [filter](AbstractResource *resource) {
-                return resource->state() >= AbstractResource::Installed && !qobject_cast<PackageKitResource *>(resource)->isCritical()
-                    && (resource->name().contains(filter.search, Qt::CaseInsensitive)
-                        || resource->packageName().compare(filter.search, Qt::CaseInsensitive) == 0);
-            };
-            bool furtherSearch = false;
-            if (!toResolve.isEmpty()) {
-                resolvePackages(kTransform<QStringList>(toResolve, [](AbstractResource *resource) {
-                    return resource->packageName();
-                }));
-                connect(m_resolveTransaction, &PKResolveTransaction::allFinished, this, [stream, toResolve, installedAndNameFilter] {
-                    const auto resolved = kFilter<QVector<AbstractResource *>>(toResolve, installedAndNameFilter);
-                    if (!resolved.isEmpty()) {
-                        Q_EMIT stream->resourcesFound(kTransform<QVector<StreamResult>>(resolved, [](auto resource) {
-                            return StreamResult(resource, 0);
-                        }));
-                    }
+                const auto toResolve = kSetToList(self->m_unresolved);
+                if (toResolve.isEmpty()) {
                     stream->finish();
-                });
-                furtherSearch = true;
-            }
-
-            const auto resolved = kFilter<QVector<AbstractResource *>>(m_packages.packages, installedAndNameFilter);
-            if (!resolved.isEmpty()) {
-                QTimer::singleShot(0, stream, [resolved, toResolve, stream]() {
-                    if (!resolved.isEmpty()) {
-                        Q_EMIT stream->resourcesFound(kTransform<QVector<StreamResult>>(resolved, [](auto resource) {
-                            return StreamResult(resource, 0);
-                        }));
-                    }
+                    co_return;
+                }
 
-                    if (toResolve.isEmpty()) {
-                        stream->finish();
+                auto batch = self->resolvePackages(kTransform<QStringList>(toResolve, [](AbstractResource *resource) {
+                                                       return resource->packageName();
+                                                   }),
+                                                   true);
+                co_await qCoro(batch, &PKRequestBatch::allFinished);
+                if (stream.isNull()) {
+                    co_return;
+                }
+                const QString folded = filter.search.toCaseFolded();
+                QVector<StreamResult> found;
+                for (auto resource : toResolve) {
+                    const auto it = self->m_installed.constFind(resource);
+                    if (it != self->m_installed.cend() && it->matches(folded)) {
+                        found += StreamResult(resource, 0);
                     }
-                });
-                furtherSearch = true;
-            }
-
-            if (!furtherSearch) {
+                }
+                if (!found.isEmpty()) {
+                    Q_EMIT stream->resourcesFound(found);
+                }
                 stream->finish();
-            }
+            }(this, stream, filter);
         });
     } else if (filter.search.isEmpty() && !filter.category) {
         return deferredResultStream(u"PackageKitStream-all"_s, [this](PKResultsStream *stream) {
-            loadAllPackages();
+            [](PackageKitBackend *self, QPointer<PKResultsStream> stream) -> QCoro::Task<> {
+                QSet<AbstractResource *> sent;
+                const auto send = [&stream, &sent](const auto &resources) {
+                    QVector<StreamResult> results;
+                    for (auto resource : resources) {
+                        auto pkResource = qobject_cast<PackageKitResource *>(resource);
+                        // Neither PackageKitResource or its subclass AppPackageKitResource can have type == ApplicationSupport
+                        if (resource->type() != AbstractResource::System && pkResource && !pkResource->isCritical() && !pkResource->extendsItself()
+                            && !sent.contains(resource)) {
+                            sent.insert(resource);
+                            results += StreamResult(resource, 0);
+                        }
+                    }
+                    if (!stream.isNull()) {
+                        stream->addResources(results);
+                    }
+                };
 
-            auto resources = kFilter<QVector<AbstractResource *>>(m_packages.packages, [](AbstractResource *resource) {
-                auto pkResource = qobject_cast<PackageKitResource *>(resource);
-                // Neither PackageKitResource or its subclass AppPackageKitResource can have type == ApplicationSupport
-                return resource->type() != AbstractResource::System && pkResource && !pkResource->isCritical() && !pkResource->extendsItself();
-            });
-            stream->sendResources(kTransform<QVector<StreamResult>>(resources, [](auto resource) {
-                return StreamResult(resource, 0);
-            }));
+                co_await self->loadAllPackages(send);
+                if (stream.isNull()) {
+                    co_return;
+                }
+                // What was there already, or all of it if someone else loaded the packages
+                send(self->m_packages.packages);
+                stream->finish();
+            }(this, stream);
         });
     } else {
         return deferredResultStream(u"PackageKitStream-search"_s, [this, filter = filter](PKResultsStream *stream) {
-            auto loadComponents = [](const auto &filter, const auto &appdata) -> QFuture<AppStream::ComponentBox> {
+            auto loadComponents = [](const auto &filter, const auto &appdata, QObject *requester) -> QFuture<AppStream::ComponentBox> {
                 QFuture<AppStream::ComponentBox> components;
                 if (!filter.search.isEmpty()) {
-                    components = appdata->search(filter.search);
+                    components = appdata->search(filter.search, requester);
                 } else if (filter.category) {
                     components = AppStreamUtils::componentsByCategoriesTask(appdata.get(), filter.category, AppStream::Bundle::KindUnknown);
                 } else {
@@ -808,7 +878,7 @@ ResultsStream *PackageKitBackend::search(const AbstractResourcesBackend::Filters
             };
 
             auto watcher = new QFutureWatcher<AppStream::ComponentBox>();
-            auto futureComponents = loadComponents(filter, m_appdata);
+            auto futureComponents = loadComponents(filter, m_appdata, stream);
             watcher->setFuture(futureComponents);
             connect(watcher, &QFutureWatcher<AppStream::ComponentBox>::finished, watcher, &QObject::deleteLater);
             connect(watcher, &QFutureWatcher<AppStream::ComponentBox>::finished, stream, [this, stream, filter, futureComponents]() {
@@ -1119,22 +1189,52 @@ QSet<QString> PackageKitBackend::upgradeablePackageId(const PackageKitResource *
 
 void PackageKitBackend::fetchDetails(const QString &pkgid)
 {
-    m_details.add(pkgid);
+    m_requests->request(PKRequestScheduler::Details, {pkgid});
 }
 
 void PackageKitBackend::fetchDetails(const QSet<QString> &pkgid)
 {
-    m_details.add(pkgid);
+    m_requests->request(PKRequestScheduler::Details, kSetToList(pkgid));
+}
+
+void PackageKitBackend::fetchUpdateDetails(const QString &pkgid)
+{
+    m_requests->request(PKRequestScheduler::UpdateDetails, {pkgid});
 }
 
-void PackageKitBackend::performDetailsFetch(const QSet<QString> &pkgids)
+void PackageKitBackend::updateDetail(const QString &packageID,
+                                     const QStringList &updates,
+                                     const QStringList &obsoletes,
+                                     const QStringList &vendorUrls,
+                                     const QStringList &bugzillaUrls,
+                                     const QStringList &cveUrls,
+                                     PackageKit::Transaction::Restart restart,
+                                     const QString &updateText,
+                                     const QString &changelog,
+                                     PackageKit::Transaction::UpdateState state,
+                                     const QDateTime &issued,
+                                     const QDateTime &updated)
 {
-    Q_ASSERT(!pkgids.isEmpty());
-    const auto ids = pkgids.values();
+    const QSet<AbstractResource *> resources = resourcesByPackageName(PackageKit::Daemon::packageName(packageID));
+    for (auto r : resources) {
+        PackageKitResource *resource = qobject_cast<PackageKitResource *>(r);
+        if (resource->containsPackageId(packageID)) {
+            resource->updateDetail(packageID, updates, obsoletes, vendorUrls, bugzillaUrls, cveUrls, restart, updateText, changelog, state, issued, updated);
+        }
+    }
+}
 
-    PackageKit::Transaction *transaction = PackageKit::Daemon::getDetails(ids);
-    connect(transaction, &PackageKit::Transaction::details, this, &PackageKitBackend::packageDetails);
-    connect(transaction, &PackageKit::Transaction::errorCode, this, &PackageKitBackend::transactionError);
+void PackageKitBackend::updateDetailsFailed(const QStringList &pkgids)
+{
+    for (const QString &pkgid : pkgids) {
+        const QSet<AbstractResource *> resources = resourcesByPackageName(PackageKit::Daemon::packageName(pkgid));
+        for (auto r : resources) {
+            PackageKitResource *resource = qobject_cast<PackageKitResource *>(r);
+            if (resource->containsPackageId(pkgid)) {
+                Q_EMIT resource->changelogFetched(QString());
+            }
+        }
+    }
 }
 
 void PackageKitBackend::checkDaemonRunning()
@@ -1205,19 +1305,60 @@ InlineMessage *PackageKitBackend::explainDysfunction() const
     return AbstractResourcesBackend::explainDysfunction();
 }
 
-void PackageKitBackend::loadAllPackages()
+// How many resources are created before going back to the event loop
+static constexpr qsizetype s_loadChunkSize = 200;
+
+QCoro::Task<> PackageKitBackend::loadAllPackages(std::function<void(const QVector<AbstractResource *> &)> chunkLoaded)
 {
     if (m_allPackagesLoaded) {
-        return;
+        co_return;
+    }
+    if (m_allPackagesLoading) {
+        co_await qCoro(this, &PackageKitBackend::allPackagesLoaded);
+        co_return;
     }
-    const auto components = m_appdata->components().result();
+
+    QPointer<PackageKitBackend> guard(this);
+    m_allPackagesLoading = true;
+    const AppStream::ComponentBox components = co_await m_appdata->components();
+
+    QVector<AbstractResource *> chunk;
+    chunk.reserve(s_loadChunkSize);
     for (const auto &component : components) {
-        if (!component.packageNames().isEmpty()) {
-            addComponent(component);
+        if (guard.isNull()) {
+            co_return;
+        }
+        if (component.packageNames().isEmpty()) {
+            continue;
+        }
+
+        // Make it reachable right away instead of waiting for includePackagesToAdd()
+        chunk += addComponent(component);
+        const auto appId = makeAppId(component.id());
+        if (auto resource = m_packagesToAdd.take(appId)) {
+            m_packages.packages.insert(appId, resource);
+            watchResource(resource);
+        }
+
+        if (chunk.size() == s_loadChunkSize) {
+            if (chunkLoaded) {
+                chunkLoaded(chunk);
+            }
+            chunk.clear();
+            co_await QCoro::sleepFor(0ms);
         }
     }
+    if (guard.isNull()) {
+        co_return;
+    }
+    if (chunkLoaded && !chunk.isEmpty()) {
+        chunkLoaded(chunk);
+    }
+
     includePackagesToAdd();
     m_allPackagesLoaded = true;
+    m_allPackagesLoading = false;
+    Q_EMIT allPackagesLoaded();
 }
 
 void PackageKitBackend::aboutTo(AboutToAction action)
@@ -10,6 +10,7 @@
 
 #include <PackageKit/Offline>
 #include <PackageKit/Transaction>
+#include <QDateTime>
 #include <QPointer>
 #include <QSet>
 #include <QSharedPointer>
@@ -21,11 +22,16 @@
 #include <appstream/AppStreamConcurrentPool.h>
 #include <resources/AbstractResourcesBackend.h>
 
+#include <QCoroTask>
+
+#include <functional>
+
 class AppPackageKitResource;
 class PackageKitUpdater;
 class OdrsReviewsBackend;
 class PKResultsStream;
-class PKResolveTransaction;
+class PKRequestBatch;
+class PKRequestScheduler;
 
 /** This is either a package name or an appstream id */
 struct PackageOrAppId {
@@ -35,36 +41,6 @@ struct PackageOrAppId {
 PackageOrAppId makePackageId(const QString &id);
 PackageOrAppId makeAppId(const QString &id);
 
-class Delay : public QObject
-{
-    Q_OBJECT
-public:
-    Delay();
-    void add(const QString &pkgid)
-    {
-        if (!m_delay.isActive()) {
-            m_delay.start();
-        }
-
-        m_pkgids << pkgid;
-    }
-    void add(const QSet<QString> &pkgids)
-    {
-        if (!m_delay.isActive()) {
-            m_delay.start();
-        }
-
-        m_pkgids += pkgids;
-    }
-
-Q_SIGNALS:
-    void perform(const QSet<QString> &pkgids);
-
-private:
-    QTimer m_delay;
-    QSet<QString> m_pkgids;
-};
-
 class DISCOVERCOMMON_EXPORT PackageKitBackend : public AbstractResourcesBackend
 {
     Q_OBJECT
@@ -94,9 +70,15 @@ public:
     QSet<QString> upgradeablePackageId(const PackageKitResource *res) const;
     QVector<AbstractResource *> extendedBy(const QString &id) const;
 
-    PKResolveTransaction *resolvePackages(const QStringList &packageNames);
+    /// @p waiting tells that a view is waiting for the packages, see PKRequestScheduler::request
+    PKRequestBatch *resolvePackages(const QStringList &packageNames, bool waiting = false);
     void fetchDetails(const QString &pkgid);
     void fetchDetails(const QSet<QString> &pkgid);
+    void fetchUpdateDetails(const QString &pkgid);
+    PKRequestScheduler *requests() const
+    {
+        return m_requests;
+    }
 
     void checkForUpdates() override;
     QString displayName() const override;
@@ -114,16 +96,10 @@ public:
 
     InlineMessage *explainDysfunction() const override;
 
-    void addPackageArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary);
-    void addPackageNotArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary);
     void clear()
     {
         m_updatesPackageId.clear();
     }
-    Delay &updateDetails()
-    {
-        return m_updateDetails;
-    }
     template<typename T, typename W>
     T resourcesByPackageNames(const W &names) const;
 
@@ -151,11 +127,12 @@ private Q_SLOTS:
     void packageDetails(const PackageKit::Details &details);
     void addPackageToUpdate(PackageKit::Transaction::Info, const QString &pkgid, const QString &summary);
     void getUpdatesFinished(PackageKit::Transaction::Exit, uint);
-    void loadAllPackages();
+    void resourceStateChanged();
 
 Q_SIGNALS:
     void loadedAppStream();
     void available();
+    void allPackagesLoaded();
 
 private:
     friend class PackageKitResource;
@@ -173,11 +150,32 @@ private:
     void checkDaemonRunning();
     void acquireFetching(bool f);
     void includePackagesToAdd();
-    void performDetailsFetch(const QSet<QString> &pkgids);
+    void updateDetail(const QString &packageID,
+                      const QStringList &updates,
+                      const QStringList &obsoletes,
+                      const QStringList &vendorUrls,
+                      const QStringList &bugzillaUrls,
+                      const QStringList &cveUrls,
+                      PackageKit::Transaction::Restart restart,
+                      const QString &updateText,
+                      const QString &changelog,
+                      PackageKit::Transaction::UpdateState state,
+                      const QDateTime &issued,
+                      const QDateTime &updated);
+    void updateDetailsFailed(const QStringList &pkgids);
     AppPackageKitResource *addComponent(const AppStream::Component &component) const;
+    /// Creates a resource for every component, @p chunkLoaded gets them as they are created
+    QCoro::Task<> loadAllPackages(std::function<void(const QVector<AbstractResource *> &)> chunkLoaded = {});
     void updateProxy();
     void foundNewMajorVersion(const AppStream::Release &release);
     void setRefresher(PackageKit::Transaction *refresh);
+    void updatePackageToApp();
+    /// Starts following the state of @p resource once it's in m_packages
+    void watchResource(AbstractResource *resource);
+    void indexResource(AbstractResource *resource);
+    void unindexResource(AbstractResource *resource);
+    /// Installed resources whose name contains @p search or whose package is called that
+    QVector<AbstractResource *> installedMatching(const QString &search) const;
 
     QScopedPointer<AppStream::ConcurrentPool> m_appdata;
     bool m_appdataLoaded = false;
@@ -194,12 +192,30 @@ private:
         QHash<PackageOrAppId, AbstractResource *> packages;
         QHash<QString, QStringList> packageToApp;
     } m_packages;
+    // What packageToApp was last fully built from, see PackageToAppMap
+    QDateTime m_packageToAppTime;
+    // Stand-ins for the packages of applications whose component isn't available yet because
+    // the pool is loading. They aren't listed, PackageKit replies reach them as they come and
+    // they are handed to their applications once the pool is loaded.
+    QHash<QString, PackageKitResource *> m_pendingPackages;
+    // Installed resources of m_packages, with their names folded once for searching
+    struct InstalledEntry {
+        QString foldedName;
+        QString foldedPackageName;
+
+        bool matches(const QString &foldedSearch) const
+        {
+            return foldedName.contains(foldedSearch) || foldedPackageName == foldedSearch;
+        }
+    };
+    QHash<AbstractResource *, InstalledEntry> m_installed;
+    // Resources of m_packages that still need resolving
+    QSet<AbstractResource *> m_unresolved;
 
-    Delay m_details;
-    Delay m_updateDetails;
     QSharedPointer<OdrsReviewsBackend> m_reviews;
     QThreadPool m_threadPool;
-    QPointer<PKResolveTransaction> m_resolveTransaction;
+    PKRequestScheduler *const m_requests;
     QStringList m_globalHints;
     bool m_allPackagesLoaded = false;
+    bool m_allPackagesLoading = false;
 };
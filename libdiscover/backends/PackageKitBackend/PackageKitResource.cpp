@@ -237,6 +237,28 @@ void PackageKitResource::addPackageId(PackageKit::Transaction::Info info, const
     Q_EMIT versionsChanged();
 }
 
+void PackageKitResource::addPackagesOf(const PackageKitResource *other)
+{
+    for (auto it = other->m_packages.cbegin(), end = other->m_packages.cend(); it != end; ++it) {
+        for (const QString &packageId : it->archPkgIds) {
+            if (!containsPackageId(packageId)) {
+                addPackageId(it.key(), packageId, true);
+            }
+        }
+        for (const QString &packageId : it->nonarchPkgIds) {
+            if (!containsPackageId(packageId)) {
+                addPackageId(it.key(), packageId, false);
+            }
+        }
+    }
+    if (!other->m_details.packageId().isEmpty()) {
+        setDetails(other->m_details);
+    }
+    if (m_changelog.isEmpty()) {
+        m_changelog = other->m_changelog;
+    }
+}
+
 bool PackageKitResource::hasCategory(const QString & /*category*/) const
 {
     return false;
@@ -318,7 +340,7 @@ void PackageKitResource::fetchUpdateDetails()
         connect(this, &PackageKitResource::stateChanged, a, &OneTimeAction::trigger);
         return;
     }
-    backend()->updateDetails().add(pkgid);
+    backend()->fetchUpdateDetails(pkgid);
 }
 
 static void addIfNotEmpty(const QString &title, const QString &content, QString &where)
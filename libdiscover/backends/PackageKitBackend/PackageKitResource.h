@@ -99,6 +99,8 @@ public:
 
     void runService(KService::Ptr service) const;
     bool containsPackageId(const QString &pkgid) const;
+    /// Takes what PackageKit told @p other, that stood in for us, about our packages
+    void addPackagesOf(const PackageKitResource *other);
 
 Q_SIGNALS:
     void dependenciesChanged();
@@ -0,0 +1,146 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "PackageToAppMap.h"
+#include "libdiscover_backend_packagekit_debug.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+using namespace Qt::StringLiterals;
+
+// Every app id is only written once, packages refer to them by index
+static constexpr quint32 s_magic = 0x504b4150; // PKAP
+static constexpr quint32 s_version = 1;
+
+QDateTime PackageToAppMap::catalogsTime()
+{
+    // Where AppStream looks for catalogs of system packages, and where it caches them
+    static const QStringList roots = {
+        u"/usr/share/swcatalog"_s,
+        u"/var/lib/swcatalog"_s,
+        u"/var/cache/swcatalog"_s,
+        u"/usr/share/app-info"_s,
+        u"/var/lib/app-info"_s,
+        u"/var/cache/app-info"_s,
+    };
+    static const QStringList subdirs = {u"xml"_s, u"xmls"_s, u"yaml"_s, u"cache"_s};
+
+    QDateTime ret;
+    const auto consider = [&ret](const QFileInfo &info) {
+        if (info.exists() && (!ret.isValid() || info.lastModified() > ret)) {
+            ret = info.lastModified();
+        }
+    };
+    for (const QString &root : roots) {
+        for (const QString &subdir : subdirs) {
+            const QDir dir(root + QLatin1Char('/') + subdir);
+            // Replacing or removing a file changes the directory, rewriting it in place only the file
+            consider(QFileInfo(dir.path()));
+            const auto entries = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+            for (const auto &entry : entries) {
+                consider(entry);
+            }
+        }
+    }
+    return ret;
+}
+
+PackageToAppMap::Map PackageToAppMap::fromComponents(const AppStream::ComponentBox &components)
+{
+    Map ret;
+    for (const auto &component : components) {
+        const QString id = component.id();
+        const auto packageNames = component.packageNames();
+        for (const QString &packageName : packageNames) {
+            auto &ids = ret[packageName];
+            if (!ids.contains(id)) {
+                ids += id;
+            }
+        }
+    }
+    return ret;
+}
+
+PackageToAppMap::Map PackageToAppMap::load(const QString &path, const QDateTime &catalogsTime)
+{
+    QFile file(path);
+    if (!catalogsTime.isValid() || !file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 time = 0;
+    stream >> magic >> version >> time;
+    if (magic != s_magic || version != s_version || time != catalogsTime.toMSecsSinceEpoch()) {
+        return {};
+    }
+
+    QStringList appIds;
+    quint32 packages = 0;
+    stream >> appIds >> packages;
+    Map ret;
+    ret.reserve(packages);
+    for (quint32 i = 0; i < packages && stream.status() == QDataStream::Ok; ++i) {
+        QString packageName;
+        QList<quint32> indexes;
+        stream >> packageName >> indexes;
+        auto &ids = ret[packageName];
+        for (quint32 index : std::as_const(indexes)) {
+            if (index < quint32(appIds.size())) {
+                ids += appIds[index];
+            }
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(LIBDISCOVER_BACKEND_PACKAGEKIT_LOG) << "Ignoring broken package map" << path;
+        return {};
+    }
+    return ret;
+}
+
+bool PackageToAppMap::save(const QString &path, const QDateTime &catalogsTime, const Map &map)
+{
+    if (!catalogsTime.isValid() || !QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QStringList appIds;
+    QHash<QString, quint32> appIndexes;
+    for (const QStringList &ids : map) {
+        for (const QString &id : ids) {
+            if (!appIndexes.contains(id)) {
+                appIndexes.insert(id, appIds.size());
+                appIds += id;
+            }
+        }
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << s_magic << s_version << catalogsTime.toMSecsSinceEpoch() << appIds << quint32(map.size());
+    for (const auto &[packageName, ids] : map.asKeyValueRange()) {
+        QList<quint32> indexes;
+        indexes.reserve(ids.size());
+        for (const QString &id : ids) {
+            indexes += appIndexes.value(id);
+        }
+        stream << packageName << indexes;
+    }
+    return stream.status() == QDataStream::Ok && file.commit();
+}
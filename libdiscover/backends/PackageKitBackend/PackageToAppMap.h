@@ -0,0 +1,34 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QStringList>
+
+#include <AppStreamQt/componentbox.h>
+
+/**
+ * Which AppStream components every package provides, by package name.
+ *
+ * Knowing it takes going through the whole pool, so it's kept on disk for as
+ * long as the catalogs don't change. This way PackageKit replies can be matched
+ * with their applications from startup on, before the pool is loaded.
+ */
+namespace PackageToAppMap
+{
+using Map = QHash<QString, QStringList>;
+
+/// When the AppStream catalogs or their cache last changed
+QDateTime catalogsTime();
+
+Map fromComponents(const AppStream::ComponentBox &components);
+
+/// Reads the map at @p path, it's empty unless it was built from the catalogs as of @p catalogsTime
+Map load(const QString &path, const QDateTime &catalogsTime);
+bool save(const QString &path, const QDateTime &catalogsTime, const Map &map);
+}
@@ -0,0 +1,132 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "PKRequestScheduler.h"
+
+#include <QObject>
+#include <QPair>
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+// Records what would be asked to PackageKit instead of asking it
+class FakeScheduler : public PKRequestScheduler
+{
+public:
+    using PKRequestScheduler::answered;
+    using PKRequestScheduler::detailsReceived;
+    using PKRequestScheduler::resolved;
+
+    QList<QPair<Kind, QStringList>> sent;
+
+protected:
+    void send(Kind kind, const QStringList &chunk) override
+    {
+        sent.append({kind, chunk});
+    }
+};
+
+class PKRequestSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDedup()
+    {
+        FakeScheduler scheduler;
+        auto first = scheduler.request(PKRequestScheduler::Resolve, {u"a"_s, u"b"_s});
+        QCOMPARE(scheduler.request(PKRequestScheduler::Resolve, {u"b"_s, u"c"_s}, true), first);
+        QSignalSpy firstFinished(first, &PKRequestBatch::allFinished);
+
+        QTRY_COMPARE(scheduler.sent.size(), 1);
+        QCOMPARE(scheduler.sent.constFirst().second, QStringList({u"a"_s, u"b"_s, u"c"_s}));
+
+        // Already in flight, the new batch waits for the first one
+        auto second = scheduler.request(PKRequestScheduler::Resolve, {u"b"_s}, true);
+        QVERIFY(second != first);
+        QSignalSpy secondFinished(second, &PKRequestBatch::allFinished);
+        QTest::qWait(10);
+        QCOMPARE(scheduler.sent.size(), 1);
+        QCOMPARE(secondFinished.count(), 0);
+
+        scheduler.answered(PKRequestScheduler::Resolve, scheduler.sent.constFirst().second, true);
+        QCOMPARE(firstFinished.count(), 1);
+        QCOMPARE(secondFinished.count(), 1);
+    }
+
+    void testChunking()
+    {
+        FakeScheduler scheduler;
+        QStringList names;
+        for (int i = 0; i < 2600; ++i) {
+            names += u"pkg-%1"_s.arg(i);
+        }
+        auto batch = scheduler.request(PKRequestScheduler::Resolve, names, true);
+        QSignalSpy finished(batch, &PKRequestBatch::allFinished);
+
+        // Only a few transactions at a time, each of them bounded
+        QTRY_COMPARE(scheduler.sent.size(), 4);
+        for (const auto &[kind, chunk] : std::as_const(scheduler.sent)) {
+            QCOMPARE(kind, PKRequestScheduler::Resolve);
+            QVERIFY(chunk.size() <= 500);
+        }
+
+        scheduler.answered(PKRequestScheduler::Resolve, scheduler.sent.constFirst().second, true);
+        QCOMPARE(scheduler.sent.size(), 5);
+
+        for (qsizetype i = 1; i < scheduler.sent.size(); ++i) {
+            scheduler.answered(PKRequestScheduler::Resolve, scheduler.sent.at(i).second, true);
+        }
+        QCOMPARE(finished.count(), 1);
+
+        QStringList sentNames;
+        for (const auto &[kind, chunk] : std::as_const(scheduler.sent)) {
+            sentNames += chunk;
+        }
+        QCOMPARE(sentNames, names);
+    }
+
+    void testReplay()
+    {
+        FakeScheduler scheduler;
+        QSignalSpy resolvedSpy(&scheduler, &PKRequestScheduler::packageResolved);
+        const QString packageId = u"a;1.0;x86_64;main"_s;
+
+        scheduler.request(PKRequestScheduler::Resolve, {u"a"_s, u"b"_s}, true);
+        QTRY_COMPARE(scheduler.sent.size(), 1);
+        scheduler.resolved(PackageKit::Transaction::InfoInstalled, packageId, u"Summary"_s, false);
+        scheduler.answered(PKRequestScheduler::Resolve, scheduler.sent.constFirst().second, true);
+        QCOMPARE(resolvedSpy.count(), 1);
+
+        // Both are known now, b to not be a package
+        auto batch = scheduler.request(PKRequestScheduler::Resolve, {u"a"_s, u"b"_s}, true);
+        QSignalSpy finished(batch, &PKRequestBatch::allFinished);
+        QTRY_COMPARE(finished.count(), 1);
+        QCOMPARE(scheduler.sent.size(), 1);
+        QCOMPARE(resolvedSpy.count(), 2);
+        QCOMPARE(resolvedSpy.constLast().at(1).toString(), packageId);
+
+        scheduler.forget(PKRequestScheduler::Resolve, {u"a"_s});
+        scheduler.request(PKRequestScheduler::Resolve, {u"a"_s, u"b"_s}, true);
+        QTRY_COMPARE(scheduler.sent.size(), 2);
+        QCOMPARE(scheduler.sent.constLast().second, QStringList({u"a"_s}));
+
+        QSignalSpy detailsSpy(&scheduler, &PKRequestScheduler::detailsFound);
+        scheduler.request(PKRequestScheduler::Details, {packageId}, true);
+        QTRY_COMPARE(scheduler.sent.size(), 3);
+        scheduler.detailsReceived(PackageKit::Details({{u"package-id"_s, packageId}}));
+        scheduler.answered(PKRequestScheduler::Details, {packageId}, true);
+        QCOMPARE(detailsSpy.count(), 1);
+
+        scheduler.request(PKRequestScheduler::Details, {packageId}, true);
+        QTRY_COMPARE(detailsSpy.count(), 2);
+        QCOMPARE(scheduler.sent.size(), 3);
+    }
+};
+
+QTEST_GUILESS_MAIN(PKRequestSchedulerTest)
+
+#include "PKRequestSchedulerTest.moc"
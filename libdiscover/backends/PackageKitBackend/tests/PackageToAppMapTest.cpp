@@ -0,0 +1,79 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "PackageToAppMap.h"
+
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+class PackageToAppMapTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init()
+    {
+        QVERIFY(m_dir.isValid());
+        m_path = m_dir.filePath(u"cache/packagetoapp"_s);
+        QFile::remove(m_path);
+    }
+
+    void testRoundTrip()
+    {
+        const PackageToAppMap::Map map = {
+            {u"kate"_s, {u"org.kde.kate"_s, u"org.kde.plasma.katesessions"_s}},
+            {u"kwrite"_s, {u"org.kde.kwrite"_s}},
+            // Shares an app id with kate, which is only written once
+            {u"kate-data"_s, {u"org.kde.kate"_s}},
+        };
+        QVERIFY(PackageToAppMap::save(m_path, s_time, map));
+        QCOMPARE(PackageToAppMap::load(m_path, s_time), map);
+    }
+
+    void testEmpty()
+    {
+        QVERIFY(PackageToAppMap::save(m_path, s_time, {}));
+        QVERIFY(QFile::exists(m_path));
+        QVERIFY(PackageToAppMap::load(m_path, s_time).isEmpty());
+    }
+
+    void testCatalogsChanged()
+    {
+        QVERIFY(PackageToAppMap::save(m_path, s_time, {{u"kate"_s, {u"org.kde.kate"_s}}}));
+        QVERIFY(PackageToAppMap::load(m_path, s_time.addSecs(1)).isEmpty());
+        QVERIFY(PackageToAppMap::load(m_path, {}).isEmpty());
+        QVERIFY(!PackageToAppMap::save(m_path, {}, {{u"kate"_s, {u"org.kde.kate"_s}}}));
+    }
+
+    void testBroken()
+    {
+        QVERIFY(PackageToAppMap::save(m_path, s_time, {{u"kate"_s, {u"org.kde.kate"_s}}}));
+
+        QFile file(m_path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 1));
+        file.close();
+        QVERIFY(PackageToAppMap::load(m_path, s_time).isEmpty());
+
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("not a package map");
+        file.close();
+        QVERIFY(PackageToAppMap::load(m_path, s_time).isEmpty());
+    }
+
+private:
+    static inline const QDateTime s_time = QDateTime::fromMSecsSinceEpoch(1700000000000);
+
+    QTemporaryDir m_dir;
+    QString m_path;
+};
+
+QTEST_GUILESS_MAIN(PackageToAppMapTest)
+
+#include "PackageToAppMapTest.moc"
@@ -158,6 +158,10 @@ void RpmOstreeBackend::refreshDeployments()
 
     // Reset the list of deployments
     m_currentlyBootedDeployment = nullptr;
+    // They're kept around, the transaction that's updating them may still use them
+    for (RpmOstreeResource *deployment : std::as_const(m_resources)) {
+        Q_EMIT resourceRemoved(deployment);
+    }
     m_resources.clear();
 
     // Get the list of currently available deployments. This is a DBus property
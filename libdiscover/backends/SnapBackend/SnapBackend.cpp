@@ -5,6 +5,7 @@
  */
 
 #include "SnapBackend.h"
+#include "SnapCatalog.h"
 #include "SnapResource.h"
 #include "SnapTransaction.h"
 #include <Category/Category.h>
@@ -33,6 +34,9 @@
 
 DISCOVER_BACKEND_PLUGIN(SnapBackend)
 
+using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
+
 class SnapSourcesBackend : public AbstractSourcesBackend
 {
 public:
@@ -83,7 +87,16 @@ SnapBackend::SnapBackend(QObject *parent)
     : AbstractResourcesBackend(parent)
     , m_updater(new StandardBackendUpdater(this))
     , m_reviews(OdrsReviewsBackend::global())
+    , m_catalog(new SnapCatalog(this))
 {
+    // Lets tests talk to a stand-in snapd
+    m_socketPath = qEnvironmentVariable("DISCOVER_SNAPD_SOCKET");
+    if (!m_socketPath.isEmpty()) {
+        m_client.setSocketPath(m_socketPath);
+    }
+    // Requests are answered by snapd, the threads only wait for them
+    m_threadPool.setMaxThreadCount(4);
+
     connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &SnapBackend::updatesCountChanged);
 
     connect(m_reviews.data(), &OdrsReviewsBackend::ratingsReady, this, [this] {
@@ -92,12 +105,20 @@ SnapBackend::SnapBackend(QObject *parent)
                                      }));
     });
 
+    connect(m_catalog, &SnapCatalog::refreshed, this, [this] {
+        for (SnapResource *res : std::as_const(m_resources)) {
+            res->setCategories(m_catalog->categoriesOf(res->packageName()));
+        }
+    });
+
+    m_searchTimer.setSingleShot(true);
+    m_searchTimer.setInterval(250ms);
+    connect(&m_searchTimer, &QTimer::timeout, this, &SnapBackend::findPendingSearch);
+
     // make sure we populate the installed resources first
     refreshStates();
 
     SourcesModel::global()->addSourcesBackend(new SnapSourcesBackend(this));
-
-    m_threadPool.setMaxThreadCount(1);
 }
 
 SnapBackend::~SnapBackend()
@@ -130,23 +151,131 @@ ResultsStream *SnapBackend::search(const AbstractResourcesBackend::Filters &filt
             return filters.search.isEmpty() || s->name().contains(filters.search, Qt::CaseInsensitive)
                 || s->description().contains(filters.search, Qt::CaseInsensitive);
         };
-        return populateWithFilter(m_client.getSnaps(), f);
+        return populateWithFilter(newRequest([](QSnapdClient *client) {
+                                      return client->getSnaps();
+                                  }),
+                                  f);
+    } else if (filters.category) {
+        const QStringList sections = m_catalog->sectionsFor(filters.category);
+        if (sections.isEmpty()) {
+            return voidStream();
+        }
+        return catalogStream(u"Snap-category"_s, [this, sections, search = filters.search] {
+            return m_catalog->inSections(sections, search);
+        });
     } else if (!filters.search.isEmpty()) {
-        return populate(m_client.find(QSnapdClient::FindFlag::None, filters.search));
+        return searchStream(filters.search);
     }
     return voidStream();
 }
 
+ResultsStream *SnapBackend::catalogStream(const QString &name, const std::function<QVector<QSharedPointer<QSnapdSnap>>()> &lookup)
+{
+    auto stream = new ResultsStream(name);
+    const auto answer = [this, stream, lookup] {
+        const auto results = kTransform<QVector<StreamResult>>(lookup(), [this](const QSharedPointer<QSnapdSnap> &snap) {
+            return StreamResult(resourceForSnap(snap));
+        });
+        if (!results.isEmpty()) {
+            Q_EMIT stream->resourcesFound(results);
+        }
+        stream->finish();
+    };
+
+    if (m_catalog->isReady()) {
+        QTimer::singleShot(0, stream, answer);
+    } else {
+        connect(m_catalog, &SnapCatalog::refreshed, stream, answer, Qt::SingleShotConnection);
+        m_catalog->refresh();
+    }
+    return stream;
+}
+
+ResultsStream *SnapBackend::searchStream(const QString &search)
+{
+    // Only the last search is sent to snapd once the typing settles, the ones it replaces make do with the catalog
+    if (m_pendingSearch.stream) {
+        m_pendingSearch.stream->finish();
+    }
+    auto stream = new ResultsStream(u"Snap-search"_s);
+    m_pendingSearch = {stream, search, {}};
+    m_searchTimer.start();
+
+    QTimer::singleShot(0, stream, [this, stream, search] {
+        QVector<StreamResult> results;
+        const auto snaps = m_catalog->search(search);
+        for (const auto &snap : snaps) {
+            auto res = resourceForSnap(snap);
+            results += res;
+            if (m_pendingSearch.stream == stream) {
+                m_pendingSearch.sent.insert(res);
+            }
+        }
+        if (!results.isEmpty()) {
+            Q_EMIT stream->resourcesFound(results);
+        }
+    });
+    return stream;
+}
+
+void SnapBackend::findPendingSearch()
+{
+    const PendingSearch pending = std::exchange(m_pendingSearch, {});
+    if (!pending.stream) {
+        return;
+    }
+
+    QPointer<ResultsStream> stream = pending.stream;
+    const auto notSent = [sent = pending.sent](const StreamResult &result) {
+        return !sent.contains(result.resource);
+    };
+    const auto answer = m_searchAnswers.constFind(pending.search);
+    if (answer != m_searchAnswers.cend()) {
+        QVector<StreamResult> results;
+        for (const QString &name : *answer) {
+            if (SnapResource *res = m_resources.value(name); res && notSent(res)) {
+                results += res;
+            }
+        }
+        if (!results.isEmpty()) {
+            Q_EMIT stream->resourcesFound(results);
+        }
+        stream->finish();
+        return;
+    }
+
+    auto find = populate(newRequest([&pending](QSnapdClient *client) {
+        return client->find(QSnapdClient::FindFlag::None, pending.search);
+    }));
+    connect(find, &ResultsStream::resourcesFound, this, [this, stream, notSent, search = pending.search](const QVector<StreamResult> &results) {
+        auto &answer = m_searchAnswers[search];
+        for (const auto &result : results) {
+            answer += result.resource->packageName();
+        }
+        const auto newResults = kFilter<QVector<StreamResult>>(results, notSent);
+        if (stream && !newResults.isEmpty()) {
+            Q_EMIT stream->resourcesFound(newResults);
+        }
+    });
+    connect(find, &QObject::destroyed, stream, &ResultsStream::finish);
+}
+
 ResultsStream *SnapBackend::findResourceByPackageName(const QUrl &search)
 {
     Q_ASSERT(!search.host().isEmpty() || !AppStreamUtils::appstreamIds(search).isEmpty());
-    return search.scheme() == QLatin1String("snap") ? populate(m_client.find(QSnapdClient::MatchName, search.host()))
-        : search.scheme() == QLatin1String("appstream")
-        ? populate(kTransform<QVector<QSnapdFindRequest *>>(AppStreamUtils::appstreamIds(search),
-                                                            [this](const QString &id) {
-                                                                return m_client.find(QSnapdClient::MatchCommonId, id);
-                                                            }))
-        : voidStream();
+    if (search.scheme() == QLatin1String("snap")) {
+        return populate(newRequest([&search](QSnapdClient *client) {
+            return client->find(QSnapdClient::MatchName, search.host());
+        }));
+    } else if (search.scheme() == QLatin1String("appstream")) {
+        // Looked up all at once, with a client each
+        return populate(kTransform<QVector<QSnapdFindRequest *>>(AppStreamUtils::appstreamIds(search), [this](const QString &id) {
+            return newRequest([&id](QSnapdClient *client) {
+                return client->find(QSnapdClient::MatchCommonId, id);
+            });
+        }));
+    }
+    return voidStream();
 }
 
 template<class T>
@@ -174,40 +303,43 @@ template<class T>
 ResultsStream *SnapBackend::populateJobsWithFilter(const QVector<T *> &jobs, std::function<bool(const QSharedPointer<QSnapdSnap> &s)> &filter)
 {
     auto stream = new ResultsStream(QStringLiteral("Snap-populate"));
-    auto future = QtConcurrent::run(&m_threadPool, [this, jobs]() {
-        for (auto job : jobs) {
-            connect(this, &SnapBackend::shuttingDown, job, &T::cancel);
-            job->runSync();
+    for (auto job : jobs) {
+        connect(this, &SnapBackend::shuttingDown, job, &T::cancel);
+    }
+
+    // Every job is a request of its own: they're sent together, and filtered where they're answered
+    QThread *const mainThread = thread();
+    auto future = QtConcurrent::mapped(&m_threadPool, jobs, [filter, mainThread](T *job) {
+        QVector<QSharedPointer<QSnapdSnap>> ret;
+        job->runSync();
+        if (job->error()) {
+            qDebug() << "error:" << job->error() << job->errorString();
+            return ret;
+        }
+
+        for (int i = 0, c = job->snapCount(); i < c; ++i) {
+            QSharedPointer<QSnapdSnap> snap(job->snap(i));
+            if (filter(snap)) {
+                snap->moveToThread(mainThread);
+                ret += snap;
+            }
         }
+        return ret;
     });
 
-    auto watcher = new QFutureWatcher<void>(this);
-    watcher->setFuture(future);
-    connect(watcher, &QFutureWatcher<void>::finished, watcher, &QObject::deleteLater);
-    connect(watcher, &QFutureWatcher<void>::finished, stream, [this, jobs, filter, stream] {
-        QVector<StreamResult> ret;
+    using Watcher = QFutureWatcher<QVector<QSharedPointer<QSnapdSnap>>>;
+    auto watcher = new Watcher(this);
+    connect(watcher, &Watcher::finished, watcher, &QObject::deleteLater);
+    connect(watcher, &Watcher::finished, stream, [this, jobs, watcher, stream] {
         for (auto job : jobs) {
             job->deleteLater();
-            if (job->error()) {
-                qDebug() << "error:" << job->error() << job->errorString();
-                continue;
-            }
+        }
 
-            for (int i = 0, c = job->snapCount(); i < c; ++i) {
-                QSharedPointer<QSnapdSnap> snap(job->snap(i));
-
-                if (!filter(snap))
-                    continue;
-
-                const auto snapname = snap->name();
-                SnapResource *&res = m_resources[snapname];
-                if (!res) {
-                    res = new SnapResource(snap, AbstractResource::None, this);
-                    Q_ASSERT(res->packageName() == snapname);
-                } else {
-                    res->setSnap(snap);
-                }
-                ret += res;
+        QVector<StreamResult> ret;
+        const auto answers = watcher->future().results();
+        for (const auto &snaps : answers) {
+            for (const auto &snap : snaps) {
+                ret += resourceForSnap(snap);
             }
         }
 
@@ -215,9 +347,24 @@ ResultsStream *SnapBackend::populateJobsWithFilter(const QVector<T *> &jobs, std
             Q_EMIT stream->resourcesFound(ret);
         stream->finish();
     });
+    watcher->setFuture(future);
     return stream;
 }
 
+SnapResource *SnapBackend::resourceForSnap(const QSharedPointer<QSnapdSnap> &snap)
+{
+    const auto snapname = snap->name();
+    SnapResource *&res = m_resources[snapname];
+    if (!res) {
+        res = new SnapResource(snap, AbstractResource::None, this);
+        res->setCategories(m_catalog->categoriesOf(snapname));
+        Q_ASSERT(res->packageName() == snapname);
+    } else {
+        res->setSnap(snap);
+    }
+    return res;
+}
+
 AbstractBackendUpdater *SnapBackend::backendUpdater() const
 {
     return m_updater;
@@ -248,12 +395,18 @@ Transaction *SnapBackend::removeApplication(AbstractResource *_app)
 
 void SnapBackend::checkForUpdates()
 {
+    // What the store offers may have changed as well
+    m_searchAnswers.clear();
+    m_catalog->refresh();
+
     if (m_updatesFetcher) {
         qWarning() << "Already fetching updates";
         return;
     }
 
-    m_updatesFetcher = new StoredResultsStream({populate(m_client.findRefreshable())});
+    m_updatesFetcher = new StoredResultsStream({populate(newRequest([](QSnapdClient *client) {
+        return client->findRefreshable();
+    }))});
     connect(m_updatesFetcher, &StoredResultsStream::finishedResources, this, [this](const QVector<StreamResult> &resources) {
         for (SnapResource *res : std::as_const(m_resources)) {
             bool contained = kContains(resources, [res](const StreamResult &in) {
@@ -274,7 +427,9 @@ QString SnapBackend::displayName() const
 
 void SnapBackend::refreshStates()
 {
-    auto ret = new StoredResultsStream({populate(m_client.getSnaps())});
+    auto ret = new StoredResultsStream({populate(newRequest([](QSnapdClient *client) {
+        return client->getSnaps();
+    }))});
     connect(ret, &StoredResultsStream::finishedResources, this, [this](const QVector<StreamResult> &resources) {
         for (auto res : std::as_const(m_resources)) {
             bool contained = kContains(resources, [res](const StreamResult &in) {
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <QPointer>
+#include <QSet>
 #include <QThreadPool>
+#include <QTimer>
 #include <QVariantList>
 #include <QVector>
 #include <Snapd/Client>
@@ -18,6 +20,7 @@
 
 class OdrsReviewsBackend;
 class StandardBackendUpdater;
+class SnapCatalog;
 class SnapResource;
 class SnapBackend : public AbstractResourcesBackend
 {
@@ -50,6 +53,33 @@ public:
     {
         return &m_client;
     }
+    QThreadPool *threadPool()
+    {
+        return &m_threadPool;
+    }
+
+    /**
+     * @returns the request @p makeRequest makes, with a client of its own that
+     * is deleted along with it.
+     *
+     * Requests run on the thread pool several at a time. QSnapdClient doesn't
+     * say it can be used from several threads at once, so they don't share one.
+     */
+    template<typename Func>
+    auto newRequest(Func makeRequest)
+    {
+        auto client = new QSnapdClient;
+        if (!m_socketPath.isEmpty()) {
+            client->setSocketPath(m_socketPath);
+        }
+        auto request = makeRequest(client);
+        client->setParent(request);
+        return request;
+    }
+    SnapCatalog *catalog() const
+    {
+        return m_catalog;
+    }
     void refreshStates();
     int fetchingUpdatesProgress() const override
     {
@@ -72,12 +102,30 @@ private:
     template<class T>
     ResultsStream *populate(const QVector<T *> &snaps);
 
+    SnapResource *resourceForSnap(const QSharedPointer<QSnapdSnap> &snap);
+    ResultsStream *catalogStream(const QString &name, const std::function<QVector<QSharedPointer<QSnapdSnap>>()> &lookup);
+    ResultsStream *searchStream(const QString &search);
+    void findPendingSearch();
+
     QHash<QString, SnapResource *> m_resources;
     StandardBackendUpdater *m_updater;
     QSharedPointer<OdrsReviewsBackend> m_reviews;
 
     bool m_valid = true;
     QSnapdClient m_client;
+    QString m_socketPath;
     QThreadPool m_threadPool;
     QPointer<StoredResultsStream> m_updatesFetcher;
+    SnapCatalog *const m_catalog;
+
+    // The search that's sent to snapd once the typing settles
+    struct PendingSearch {
+        QPointer<ResultsStream> stream;
+        QString search;
+        QSet<AbstractResource *> sent;
+    };
+    PendingSearch m_pendingSearch;
+    QTimer m_searchTimer;
+    // What snapd answered to each search, by snap name
+    QHash<QString, QStringList> m_searchAnswers;
 };
@@ -0,0 +1,268 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "SnapCatalog.h"
+#include "SnapBackend.h"
+#include "libdiscover_snap_debug.h"
+#include <Category/Category.h>
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <Snapd/Client>
+
+#include "utils.h"
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+// The desktop categories Discover browses, for the sections of the store
+static const QHash<QString, QStringList> &sectionCategories()
+{
+    static const QHash<QString, QStringList> ret = {
+        {u"art-and-design"_s, {u"Graphics"_s}},
+        {u"books-and-reference"_s, {u"Education"_s}},
+        {u"development"_s, {u"Development"_s}},
+        {u"devices-and-iot"_s, {u"System"_s}},
+        {u"education"_s, {u"Education"_s}},
+        {u"entertainment"_s, {u"AudioVideo"_s}},
+        {u"finance"_s, {u"Office"_s, u"Finance"_s}},
+        {u"games"_s, {u"Game"_s}},
+        {u"health-and-fitness"_s, {u"Utility"_s}},
+        {u"music-and-audio"_s, {u"AudioVideo"_s, u"Audio"_s}},
+        {u"news-and-weather"_s, {u"Network"_s, u"News"_s}},
+        {u"personalisation"_s, {u"Settings"_s}},
+        {u"photo-and-video"_s, {u"Graphics"_s, u"Photography"_s, u"AudioVideo"_s, u"Video"_s}},
+        {u"productivity"_s, {u"Office"_s}},
+        {u"science"_s, {u"Science"_s, u"Education"_s}},
+        {u"security"_s, {u"System"_s, u"Security"_s}},
+        {u"server-and-cloud"_s, {u"System"_s, u"Network"_s}},
+        {u"social"_s, {u"Network"_s, u"Chat"_s, u"InstantMessaging"_s}},
+        {u"utilities"_s, {u"Utility"_s}},
+    };
+    return ret;
+}
+
+SnapCatalog::SnapCatalog(SnapBackend *backend)
+    : QObject(backend)
+    , m_backend(backend)
+{
+}
+
+void SnapCatalog::refresh()
+{
+    if (m_refreshing) {
+        return;
+    }
+    m_refreshing = true;
+
+    auto request = m_backend->newRequest([](QSnapdClient *client) {
+        return client->getSections();
+    });
+    connect(m_backend, &SnapBackend::shuttingDown, request, &QSnapdGetSectionsRequest::cancel);
+    auto watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, request] {
+        watcher->deleteLater();
+        request->deleteLater();
+        if (request->error()) {
+            qCWarning(LIBDISCOVER_SNAP_LOG) << "Could not list the sections of the store:" << request->error() << request->errorString();
+            m_refreshing = false;
+            Q_EMIT refreshed();
+            return;
+        }
+        findInSections(request->sections());
+    });
+    watcher->setFuture(QtConcurrent::run(m_backend->threadPool(), [request] {
+        request->runSync();
+    }));
+}
+
+void SnapCatalog::findInSections(const QStringList &sections)
+{
+    QVector<std::pair<QString, QSnapdFindRequest *>> requests;
+    requests.reserve(sections.size());
+    for (const QString &section : sections) {
+        auto request = m_backend->newRequest([&section](QSnapdClient *client) {
+            return client->findSection(QSnapdClient::FindFlag::None, section, QString());
+        });
+        connect(m_backend, &SnapBackend::shuttingDown, request, &QSnapdFindRequest::cancel);
+        requests.append({section, request});
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QThread *const mainThread = thread();
+    // Each section is a request of its own, they're sent together and indexed as they come
+    auto future = QtConcurrent::mappedReduced<std::shared_ptr<Index>>(
+        m_backend->threadPool(),
+        requests,
+        [mainThread](const std::pair<QString, QSnapdFindRequest *> &request) {
+            SectionSnaps ret{request.first, {}};
+            request.second->runSync();
+            if (request.second->error()) {
+                qCWarning(LIBDISCOVER_SNAP_LOG) << "Could not list section" << request.first << request.second->errorString();
+                return ret;
+            }
+            for (int i = 0, c = request.second->snapCount(); i < c; ++i) {
+                QSharedPointer<QSnapdSnap> snap(request.second->snap(i));
+                snap->moveToThread(mainThread);
+                ret.snaps += snap;
+            }
+            return ret;
+        },
+        &SnapCatalog::addSection,
+        QtConcurrent::UnorderedReduce);
+
+    auto watcher = new QFutureWatcher<std::shared_ptr<Index>>(this);
+    connect(watcher, &QFutureWatcher<std::shared_ptr<Index>>::finished, this, [this, watcher, requests, timer] {
+        watcher->deleteLater();
+        for (const auto &request : requests) {
+            request.second->deleteLater();
+        }
+
+        // Keep what we had if the store didn't answer
+        if (auto index = watcher->result()) {
+            m_index = index;
+            m_lastSearch.clear();
+            m_lastMatches.clear();
+        }
+        qCDebug(LIBDISCOVER_SNAP_LOG) << "catalog of" << size() << "snaps in" << requests.size() << "sections refreshed in" << timer.elapsed() << "ms";
+        m_refreshing = false;
+        Q_EMIT refreshed();
+    });
+    watcher->setFuture(future);
+}
+
+void SnapCatalog::addSection(std::shared_ptr<Index> &index, const SectionSnaps &section)
+{
+    if (section.snaps.isEmpty()) {
+        return;
+    }
+    if (!index) {
+        index = std::make_shared<Index>();
+    }
+
+    auto &positions = index->bySection[section.section];
+    for (const auto &snap : section.snaps) {
+        const QString name = snap->name();
+        qsizetype position = index->byName.value(name, -1);
+        if (position < 0) {
+            position = index->entries.size();
+            index->byName.insert(name, position);
+            index->entries.append({snap, name.toCaseFolded(), snap->summary().toCaseFolded(), {}});
+        }
+        index->entries[position].sections += section.section;
+        positions += position;
+    }
+}
+
+QList<QStringView> SnapCatalog::terms(const QString &foldedText)
+{
+    return QStringView(foldedText).split(QLatin1Char(' '), Qt::SkipEmptyParts);
+}
+
+bool SnapCatalog::entryMatches(const Entry &entry, const QList<QStringView> &terms)
+{
+    return std::all_of(terms.begin(), terms.end(), [&entry](QStringView term) {
+        return entry.name.contains(term) || entry.summary.contains(term);
+    });
+}
+
+QVector<QSharedPointer<QSnapdSnap>> SnapCatalog::search(const QString &text)
+{
+    if (!m_index) {
+        return {};
+    }
+
+    const QString folded = text.toCaseFolded();
+    const auto searchTerms = terms(folded);
+    QVector<qsizetype> matches;
+    const auto consider = [this, &searchTerms, &matches](qsizetype position) {
+        if (entryMatches(m_index->entries[position], searchTerms)) {
+            matches += position;
+        }
+    };
+    // Whatever matches now matched the text it extends
+    if (!m_lastSearch.isEmpty() && folded.startsWith(m_lastSearch)) {
+        for (qsizetype position : std::as_const(m_lastMatches)) {
+            consider(position);
+        }
+    } else {
+        for (qsizetype position = 0, count = m_index->entries.size(); position < count; ++position) {
+            consider(position);
+        }
+    }
+    m_lastSearch = folded;
+    m_lastMatches = matches;
+
+    return kTransform<QVector<QSharedPointer<QSnapdSnap>>>(matches, [this](qsizetype position) {
+        return m_index->entries[position].snap;
+    });
+}
+
+QVector<QSharedPointer<QSnapdSnap>> SnapCatalog::inSections(const QStringList &sections, const QString &text) const
+{
+    if (!m_index) {
+        return {};
+    }
+
+    const QString folded = text.toCaseFolded();
+    const auto searchTerms = terms(folded);
+    QVector<QSharedPointer<QSnapdSnap>> ret;
+    QSet<qsizetype> seen;
+    for (const QString &section : sections) {
+        const auto positions = m_index->bySection.value(section);
+        for (qsizetype position : positions) {
+            const Entry &entry = m_index->entries[position];
+            if (!seen.contains(position) && entryMatches(entry, searchTerms)) {
+                seen.insert(position);
+                ret += entry.snap;
+            }
+        }
+    }
+    return ret;
+}
+
+QStringList SnapCatalog::sectionsFor(const std::shared_ptr<Category> &category) const
+{
+    QStringList ret;
+    for (const auto &[section, categories] : sectionCategories().asKeyValueRange()) {
+        const bool matches = kContains(categories, [&category](const QString &name) {
+            return category->matchesCategoryName(name);
+        });
+        if (matches) {
+            ret += section;
+        }
+    }
+    return ret;
+}
+
+QStringList SnapCatalog::categoriesOf(const QString &snapName) const
+{
+    if (!m_index) {
+        return {};
+    }
+    const qsizetype position = m_index->byName.value(snapName, -1);
+    if (position < 0) {
+        return {};
+    }
+
+    QStringList ret;
+    for (const QString &section : m_index->entries[position].sections) {
+        for (const QString &category : sectionCategories().value(section)) {
+            if (!ret.contains(category)) {
+                ret += category;
+            }
+        }
+    }
+    return ret;
+}
+
+#include "moc_SnapCatalog.cpp"
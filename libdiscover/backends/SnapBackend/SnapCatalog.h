@@ -0,0 +1,93 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <Snapd/Snap>
+
+#include <memory>
+
+class Category;
+class SnapBackend;
+
+/**
+ * \class SnapCatalog  SnapCatalog.h "SnapCatalog.h"
+ *
+ * \brief What the store lists in its sections, indexed by name, summary and section
+ *
+ * It's refreshed in the background: snapd is asked for the sections and then
+ * for the snaps in all of them at once. Category browsing and the searches
+ * typed in the meantime are answered from here.
+ */
+class SnapCatalog : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SnapCatalog(SnapBackend *backend);
+
+    bool isReady() const
+    {
+        return m_index != nullptr;
+    }
+    bool isRefreshing() const
+    {
+        return m_refreshing;
+    }
+    void refresh();
+
+    /// Snaps whose name or summary contain every word in @p text
+    QVector<QSharedPointer<QSnapdSnap>> search(const QString &text);
+    /// Snaps listed in any of @p sections, matching @p text unless it's empty
+    QVector<QSharedPointer<QSnapdSnap>> inSections(const QStringList &sections, const QString &text = {}) const;
+
+    /// The sections whose snaps belong in @p category
+    QStringList sectionsFor(const std::shared_ptr<Category> &category) const;
+    /// The desktop categories of the sections @p snapName is listed in
+    QStringList categoriesOf(const QString &snapName) const;
+
+    qsizetype size() const
+    {
+        return m_index ? m_index->entries.size() : 0;
+    }
+
+Q_SIGNALS:
+    /// A refresh is over, successful or not
+    void refreshed();
+
+private:
+    struct Entry {
+        QSharedPointer<QSnapdSnap> snap;
+        QString name;
+        QString summary;
+        QStringList sections;
+    };
+    struct Index {
+        QVector<Entry> entries;
+        QHash<QString, qsizetype> byName;
+        QHash<QString, QVector<qsizetype>> bySection;
+    };
+    struct SectionSnaps {
+        QString section;
+        QVector<QSharedPointer<QSnapdSnap>> snaps;
+    };
+
+    static void addSection(std::shared_ptr<Index> &index, const SectionSnaps &section);
+    static QList<QStringView> terms(const QString &foldedText);
+    static bool entryMatches(const Entry &entry, const QList<QStringView> &terms);
+    void findInSections(const QStringList &sections);
+
+    SnapBackend *const m_backend;
+    std::shared_ptr<const Index> m_index;
+    bool m_refreshing = false;
+    // The previous search, typing further only narrows its matches down
+    QString m_lastSearch;
+    QVector<qsizetype> m_lastMatches;
+};
@@ -104,7 +104,12 @@ QString SnapResource::availableVersion() const
 
 bool SnapResource::hasCategory(const QString &category) const
 {
-    return category == QLatin1StringView("Application");
+    return category == QLatin1StringView("Application") || m_categories.contains(category);
+}
+
+void SnapResource::setCategories(const QStringList &categories)
+{
+    m_categories = categories;
 }
 
 QString SnapResource::comment()
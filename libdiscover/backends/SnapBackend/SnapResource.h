@@ -52,6 +52,7 @@ public:
         return {};
     }
     void setSnap(const QSharedPointer<QSnapdSnap> &snap);
+    void setCategories(const QStringList &categories);
 
     void setState(AbstractResource::State state);
     QString sourceIcon() const override
@@ -99,6 +100,8 @@ public:
     QSharedPointer<QSnapdSnap> m_snap;
     QString m_executableDesktop;
     QString m_channel;
+    // From the store sections the snap is listed in
+    QStringList m_categories;
     mutable QVariant m_icon;
     static const QStringList s_topObjects;
 };
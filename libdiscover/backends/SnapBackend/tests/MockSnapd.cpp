@@ -0,0 +1,157 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "MockSnapd.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QUrl>
+#include <QUrlQuery>
+
+using namespace Qt::StringLiterals;
+
+MockSnapd::MockSnapd(const QList<Snap> &snaps, QObject *parent)
+    : QLocalServer(parent)
+    , m_snaps(snaps)
+{
+    connect(this, &QLocalServer::newConnection, this, [this] {
+        while (auto socket = nextPendingConnection()) {
+            connect(socket, &QLocalSocket::readyRead, socket, [this, socket] {
+                readRequests(socket);
+            });
+            connect(socket, &QLocalSocket::disconnected, socket, [this, socket] {
+                m_buffers.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    });
+}
+
+bool MockSnapd::start()
+{
+    return m_dir.isValid() && listen(socketPath());
+}
+
+QString MockSnapd::socketPath() const
+{
+    return m_dir.filePath(u"snapd.socket"_s);
+}
+
+void MockSnapd::readRequests(QLocalSocket *socket)
+{
+    QByteArray &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // The client keeps the connection open and may send several requests at once
+    for (qsizetype headersEnd = buffer.indexOf("\r\n\r\n"); headersEnd >= 0; headersEnd = buffer.indexOf("\r\n\r\n")) {
+        const QList<QByteArray> lines = buffer.left(headersEnd).split('\n');
+        qsizetype contentLength = 0;
+        for (const QByteArray &line : lines) {
+            if (line.toLower().startsWith("content-length:")) {
+                contentLength = line.mid(line.indexOf(':') + 1).trimmed().toLongLong();
+            }
+        }
+        const qsizetype requestSize = headersEnd + 4 + contentLength;
+        if (buffer.size() < requestSize) {
+            return;
+        }
+        buffer.remove(0, requestSize);
+
+        const QList<QByteArray> requestLine = lines.constFirst().trimmed().split(' ');
+        const QUrl url(QString::fromLatin1(requestLine.value(1)));
+        QString key = url.path();
+        const auto items = QUrlQuery(url).queryItems();
+        for (const auto &[name, value] : items) {
+            key += (key.contains(QLatin1Char('?')) ? u"&"_s : u"?"_s) + name;
+        }
+        m_requests[key]++;
+
+        int status = 200;
+        const QJsonValue result = respond(url, &status);
+        const QJsonObject envelope = status == 200 ? QJsonObject{{u"type"_s, u"sync"_s}, {u"status-code"_s, 200}, {u"status"_s, u"OK"_s}, {u"result"_s, result}}
+                                                   : QJsonObject{{u"type"_s, u"error"_s}, {u"status-code"_s, status}, {u"status"_s, u"Not Found"_s}, {u"result"_s, result}};
+        const QByteArray body = QJsonDocument(envelope).toJson(QJsonDocument::Compact);
+        socket->write("HTTP/1.1 " + QByteArray::number(status) + (status == 200 ? " OK" : " Not Found")
+                      + "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+    }
+}
+
+QJsonValue MockSnapd::respond(const QUrl &url, int *status) const
+{
+    const QString path = url.path();
+    if (path == "/v2/sections"_L1) {
+        QStringList sections;
+        for (const Snap &snap : m_snaps) {
+            for (const QString &section : snap.sections) {
+                if (!sections.contains(section)) {
+                    sections += section;
+                }
+            }
+        }
+        return QJsonArray::fromStringList(sections);
+    } else if (path == "/v2/find"_L1) {
+        return find(url);
+    } else if (path == "/v2/snaps"_L1) {
+        QJsonArray ret;
+        for (const Snap &snap : m_snaps) {
+            if (snap.installed) {
+                ret += snapObject(snap);
+            }
+        }
+        return ret;
+    }
+
+    *status = 404;
+    return QJsonObject{{u"message"_s, u"not found"_s}, {u"kind"_s, u"not-found"_s}};
+}
+
+QJsonArray MockSnapd::find(const QUrl &url) const
+{
+    const QUrlQuery query(url);
+    const QString section = query.queryItemValue(u"section"_s, QUrl::FullyDecoded);
+    const QString text = query.queryItemValue(u"q"_s, QUrl::FullyDecoded);
+    const QString name = query.queryItemValue(u"name"_s, QUrl::FullyDecoded);
+    const bool refreshable = query.queryItemValue(u"select"_s) == "refresh"_L1;
+
+    QJsonArray ret;
+    if (refreshable || query.hasQueryItem(u"common-id"_s)) {
+        return ret;
+    }
+    for (const Snap &snap : m_snaps) {
+        const bool matches = (section.isEmpty() || snap.sections.contains(section)) && (name.isEmpty() || snap.name == name)
+            && (text.isEmpty() || snap.name.contains(text, Qt::CaseInsensitive) || snap.summary.contains(text, Qt::CaseInsensitive));
+        if (matches) {
+            ret += snapObject(snap);
+        }
+    }
+    return ret;
+}
+
+QJsonObject MockSnapd::snapObject(const Snap &snap)
+{
+    return {
+        {u"id"_s, u"mock-"_s + snap.name},
+        {u"name"_s, snap.name},
+        {u"title"_s, snap.name},
+        {u"summary"_s, snap.summary},
+        {u"description"_s, snap.summary},
+        {u"version"_s, u"1.0"_s},
+        {u"revision"_s, u"1"_s},
+        {u"type"_s, u"app"_s},
+        {u"status"_s, snap.installed ? u"active"_s : u"available"_s},
+        {u"confinement"_s, u"strict"_s},
+        {u"channel"_s, u"stable"_s},
+        {u"license"_s, u"GPL-3.0"_s},
+        {u"download-size"_s, 1024},
+        {u"installed-size"_s, snap.installed ? 1024 : 0},
+        {u"publisher"_s, QJsonObject{{u"id"_s, u"mock"_s}, {u"username"_s, u"mock"_s}, {u"display-name"_s, u"Mock"_s}, {u"validation"_s, u"unproven"_s}}},
+        {u"apps"_s, QJsonArray()},
+        {u"media"_s, QJsonArray()},
+    };
+}
+
+#include "moc_MockSnapd.cpp"
@@ -0,0 +1,62 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QLocalServer>
+#include <QStringList>
+#include <QTemporaryDir>
+
+class QLocalSocket;
+class QUrl;
+
+/**
+ * Answers the snapd REST API on a local socket, as far as the snap backend
+ * browses and searches the store.
+ *
+ * Requests are counted by path and the names of their query items,
+ * e.g. "/v2/find?q" or "/v2/find?section".
+ */
+class MockSnapd : public QLocalServer
+{
+    Q_OBJECT
+public:
+    struct Snap {
+        QString name;
+        QString summary;
+        QStringList sections;
+        bool installed = false;
+    };
+
+    explicit MockSnapd(const QList<Snap> &snaps, QObject *parent = nullptr);
+
+    bool start();
+    QString socketPath() const;
+
+    QHash<QString, int> requests() const
+    {
+        return m_requests;
+    }
+    void resetRequests()
+    {
+        m_requests.clear();
+    }
+
+private:
+    void readRequests(QLocalSocket *socket);
+    QJsonValue respond(const QUrl &url, int *status) const;
+    QJsonArray find(const QUrl &url) const;
+    static QJsonObject snapObject(const Snap &snap);
+
+    const QList<Snap> m_snaps;
+    QTemporaryDir m_dir;
+    QHash<QLocalSocket *, QByteArray> m_buffers;
+    QHash<QString, int> m_requests;
+};
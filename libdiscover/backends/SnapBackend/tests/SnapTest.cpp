@@ -0,0 +1,160 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "MockSnapd.h"
+
+#include <Category/Category.h>
+#include <resources/AbstractResource.h>
+#include <resources/ResourcesModel.h>
+
+#include <QPointer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+static const QStringList s_sections = {u"games"_s, u"productivity"_s, u"utilities"_s, u"development"_s};
+static constexpr int s_snapsPerSection = 250;
+
+static QList<MockSnapd::Snap> mockSnaps()
+{
+    QList<MockSnapd::Snap> ret;
+    for (const QString &section : s_sections) {
+        for (int i = 0; i < s_snapsPerSection; ++i) {
+            ret.append({section + u"-app-"_s + QString::number(i), u"A snap about "_s + section, {section}});
+        }
+    }
+    // Only found by asking the store
+    ret.append({u"gamepad-tool"_s, u"Not listed in any section"_s, {}});
+    ret.append({u"installed-app"_s, u"Already there"_s, {u"utilities"_s}, true});
+    return ret;
+}
+
+class SnapTest : public QObject
+{
+    Q_OBJECT
+public:
+    AbstractResourcesBackend *backendByName(ResourcesModel *m, const QString &name)
+    {
+        const QVector<AbstractResourcesBackend *> backends = m->backends();
+        for (AbstractResourcesBackend *backend : backends) {
+            if (QLatin1String(backend->metaObject()->className()) == name) {
+                return backend;
+            }
+        }
+        return nullptr;
+    }
+
+    explicit SnapTest(QObject *parent = nullptr)
+        : QObject(parent)
+        , m_snapd(mockSnaps())
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        m_games = std::make_shared<Category>(u"Games"_s,
+                                             u"applications-games"_s,
+                                             CategoryFilter{CategoryFilter::CategoryNameFilter, u"Game"_s},
+                                             QSet<QString>{u"snap-backend"_s},
+                                             QList<std::shared_ptr<Category>>{});
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_snapd.start());
+        qputenv("DISCOVER_SNAPD_SOCKET", m_snapd.socketPath().toUtf8());
+        m_model = new ResourcesModel(u"snap-backend"_s, this);
+        m_backend = backendByName(m_model, u"SnapBackend"_s);
+        QVERIFY(m_backend);
+        QVERIFY(!m_backend->hasCheapEnumeration());
+    }
+
+    void testCategoryFromCatalog()
+    {
+        AbstractResourcesBackend::Filters filters;
+        filters.category = m_games;
+        const auto games = getResources(m_backend->search(filters));
+        QCOMPARE(games.count(), s_snapsPerSection);
+        QVERIFY(games.constFirst()->hasCategory(u"Game"_s));
+        QCOMPARE(m_snapd.requests().value(u"/v2/find?section"_s), s_sections.count());
+
+        // Browsing again is answered locally
+        m_snapd.resetRequests();
+        QCOMPARE(getResources(m_backend->search(filters)).count(), s_snapsPerSection);
+        filters.search = u"app-1"_s;
+        QCOMPARE(getResources(m_backend->search(filters)).count(), 111);
+        QVERIFY(m_snapd.requests().isEmpty());
+    }
+
+    void testSearchWhileTyping()
+    {
+        m_snapd.resetRequests();
+        QList<QPointer<ResultsStream>> replaced;
+        ResultsStream *last = nullptr;
+        for (const QString &text : {u"g"_s, u"ga"_s, u"gam"_s, u"game"_s}) {
+            if (last) {
+                replaced += last;
+            }
+            AbstractResourcesBackend::Filters filters;
+            filters.search = text;
+            last = m_backend->search(filters);
+        }
+
+        const auto found = getResources(last);
+        QVERIFY(std::all_of(replaced.cbegin(), replaced.cend(), [](const QPointer<ResultsStream> &stream) {
+            return stream.isNull();
+        }));
+        // The catalog answers every keystroke, the store only the last one
+        QCOMPARE(m_snapd.requests().value(u"/v2/find?q"_s), 1);
+        QCOMPARE(found.count(), s_snapsPerSection + 1);
+        QCOMPARE(QSet<AbstractResource *>(found.cbegin(), found.cend()).count(), found.count());
+        QVERIFY(std::any_of(found.cbegin(), found.cend(), [](AbstractResource *res) {
+            return res->packageName() == "gamepad-tool"_L1;
+        }));
+
+        // Searching the same again doesn't bother the store
+        AbstractResourcesBackend::Filters filters;
+        filters.search = u"game"_s;
+        QCOMPARE(getResources(m_backend->search(filters)).count(), s_snapsPerSection + 1);
+        QCOMPARE(m_snapd.requests().value(u"/v2/find?q"_s), 1);
+    }
+
+    void benchmarkCategorySearch()
+    {
+        AbstractResourcesBackend::Filters filters;
+        filters.category = m_games;
+        filters.search = u"app-2"_s;
+        QBENCHMARK {
+            getResources(m_backend->search(filters));
+        }
+    }
+
+private:
+    QVector<AbstractResource *> getResources(ResultsStream *stream)
+    {
+        Q_ASSERT(stream);
+        QSignalSpy spyResources(stream, &ResultsStream::destroyed);
+        QVector<AbstractResource *> resources;
+        connect(stream, &ResultsStream::resourcesFound, this, [&resources](const QVector<StreamResult> &res) {
+            for (auto result : res) {
+                resources += result.resource;
+            }
+        });
+        Q_ASSERT(spyResources.wait(10000));
+        return resources;
+    }
+
+    MockSnapd m_snapd;
+    std::shared_ptr<Category> m_games;
+    ResourcesModel *m_model = nullptr;
+    AbstractResourcesBackend *m_backend = nullptr;
+};
+
+QTEST_GUILESS_MAIN(SnapTest)
+
+#include "SnapTest.moc"
@@ -101,6 +101,11 @@ QStringList AbstractResource::mimetypes() const
     return QStringList();
 }
 
+QStringList AbstractResource::keywords() const
+{
+    return {};
+}
+
 AbstractResourcesBackend *AbstractResource::backend() const
 {
     return static_cast<AbstractResourcesBackend *>(parent());
@@ -134,12 +139,26 @@ QCollatorSortKey AbstractResource::nameSortKey()
     return m_collatorKey.value();
 }
 
+QString AbstractResource::foldedName()
+{
+    if (!m_foldedName.has_value()) {
+        m_foldedName = name().toCaseFolded();
+    }
+    return m_foldedName.value();
+}
+
 Rating AbstractResource::rating() const
 {
-    if (auto reviewsBackend = backend()->reviewsBackend()) {
-        return reviewsBackend->ratingForApplication(const_cast<AbstractResource *>(this));
+    auto reviewsBackend = backend()->reviewsBackend();
+    if (!reviewsBackend) {
+        return {};
     }
-    return {};
+
+    if (m_ratingGeneration != reviewsBackend->ratingsGeneration()) {
+        m_ratingIndex = reviewsBackend->ratingIndex(const_cast<AbstractResource *>(this));
+        m_ratingGeneration = reviewsBackend->ratingsGeneration();
+    }
+    return m_ratingIndex < 0 ? Rating() : reviewsBackend->ratingAt(m_ratingIndex);
 }
 
 QStringList AbstractResource::extends() const
@@ -214,6 +214,9 @@ public:
     ///@returns what kind of mime types the resource can consume
     virtual QStringList mimetypes() const;
 
+    ///@returns the words the resource can be found by, besides its name and comment
+    virtual QStringList keywords() const;
+
     virtual QList<PackageState> addonsInformation() = 0;
 
     virtual QStringList extends() const;
@@ -237,6 +240,11 @@ public:
      */
     QCollatorSortKey nameSortKey();
 
+    /**
+     * @returns the case-folded name, for case-insensitive matching
+     */
+    QString foldedName();
+
     /**
      * Convenience method to fetch the resource's rating
      *
@@ -341,6 +349,10 @@ private:
     void reportNewState();
 
     std::optional<QCollatorSortKey> m_collatorKey;
+    std::optional<QString> m_foldedName;
+    // Slot in the reviews backend's ratings table, bound on first use, see AbstractReviewsBackend::ratingIndex()
+    mutable qsizetype m_ratingIndex = -1;
+    mutable quint64 m_ratingGeneration = 0;
     QJsonObject m_metadata;
 };
 
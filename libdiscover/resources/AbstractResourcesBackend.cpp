@@ -6,6 +6,7 @@
 
 #include "AbstractResourcesBackend.h"
 #include "Category/Category.h"
+#include "ReviewsBackend/AbstractReviewsBackend.h"
 #include "libdiscover_debug.h"
 #include "utils.h"
 #include <KLocalizedString>
@@ -97,6 +98,9 @@ QString AbstractResourcesBackend::name() const
 
 void AbstractResourcesBackend::emitRatingsReady()
 {
+    if (auto reviews = reviewsBackend()) {
+        reviews->invalidateRatings();
+    }
     Q_EMIT allDataChanged({"rating", "ratingPoints", "ratingCount", "sortableRating"});
 }
 
@@ -145,6 +149,19 @@ void AbstractResourcesBackend::Filters::filterJustInCase(QVector<StreamResult> &
     }
 }
 
+QStringList AbstractResourcesBackend::searchTexts(AbstractResource *resource) const
+{
+    return {resource->name(), resource->comment()};
+}
+
+bool AbstractResourcesBackend::matchesSearch(AbstractResource *resource, const QString &search) const
+{
+    const QStringList texts = searchTexts(resource);
+    return std::any_of(texts.cbegin(), texts.cend(), [&search](const QString &text) {
+        return text.contains(search, Qt::CaseInsensitive);
+    });
+}
+
 bool AbstractResourcesBackend::extends(const QString & /*id*/) const
 {
     return false;
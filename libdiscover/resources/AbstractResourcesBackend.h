@@ -210,7 +210,7 @@ public:
     virtual QString displayName() const = 0;
 
     /**
-     * emits a change for all rating properties
+     * emits a change for all rating properties, after rebinding the ratings of all resources
      */
     void emitRatingsReady();
 
@@ -227,6 +227,43 @@ public:
         return false;
     }
 
+    /**
+     * @returns whether a text search only ever finds resources whose
+     * searchTexts() contain the searched text.
+     *
+     * When that's the case, a search that refines the previous one can be
+     * answered by filtering the previous results.
+     */
+    virtual bool hasTextualSearch() const
+    {
+        return false;
+    }
+
+    /**
+     * @returns whether an unfiltered search lists every resource the backend
+     * offers, cheaply enough to do it in the background.
+     *
+     * Text searches on backends with applications that do are answered from
+     * the SearchIndex, the others are searched every time. Backends that
+     * opt in have to look into searchTexts() in search().
+     */
+    virtual bool hasCheapEnumeration() const
+    {
+        return false;
+    }
+
+    /**
+     * @returns the texts a text search looks into for @p resource, the name
+     * and comment unless overridden.
+     *
+     * Used to look resources up in the SearchIndex and to refine searches, so
+     * it has to match what search() does.
+     */
+    virtual QStringList searchTexts(AbstractResource *resource) const;
+
+    /// @returns whether one of the searchTexts() of @p resource contains @p search
+    bool matchesSearch(AbstractResource *resource, const QString &search) const;
+
     virtual int fetchingUpdatesProgress() const = 0;
 
     /**
@@ -309,6 +346,11 @@ Q_SIGNALS:
      * Allows to notify some @p properties in @p resource have changed
      */
     void resourcesChanged(AbstractResource *resource, const QVector<QByteArray> &properties);
+
+    /**
+     * Needs to be emitted before deleting a resource that might have been
+     * offered in a ResultsStream, so that models and streams drop it.
+     */
     void resourceRemoved(AbstractResource *resource);
 
     void passiveMessage(const QString &message);
@@ -8,6 +8,7 @@
 
 #include "AbstractResource.h"
 #include "Category/CategoryModel.h"
+#include "SearchIndex.h"
 #include "Transaction/TransactionModel.h"
 #include "libdiscover_debug.h"
 #include "resources/AbstractBackendUpdater.h"
@@ -89,6 +90,10 @@ ResourcesModel::ResourcesModel(QObject *parent)
           })
 {
     connect(this, &ResourcesModel::backendsChanged, this, &ResourcesModel::initApplicationsBackend);
+
+    if (!qEnvironmentVariableIsSet("DISCOVER_NO_SEARCH_INDEX")) {
+        m_searchIndex = new SearchIndex(this);
+    }
 }
 
 void ResourcesModel::init(bool load)
@@ -115,6 +120,7 @@ ResourcesModel::ResourcesModel(const QString &backendName, QObject *parent)
 {
     s_self = this;
     registerBackendByName(backendName);
+    m_isInitializing = false;
     init(false);
 }
 
@@ -150,6 +156,9 @@ bool ResourcesModel::addResourcesBackend(AbstractResourcesBackend *backend)
     connect(backend, &AbstractResourcesBackend::invalidated, this, [backend, this]() {
         CategoryModel::global()->blacklistPlugin(backend->name());
         m_backends.removeAll(backend);
+        if (m_searchIndex && backend->hasApplications() && backend->hasCheapEnumeration()) {
+            m_searchIndex->removeBackend(backend);
+        }
         backend->deleteLater();
         m_updatesCount.reevaluate();
         qCWarning(LIBDISCOVER_LOG) << "Discarding invalid backend" << backend->name();
@@ -158,6 +167,9 @@ bool ResourcesModel::addResourcesBackend(AbstractResourcesBackend *backend)
 
     m_backends += backend;
     m_updatesCount.reevaluate();
+    if (m_searchIndex && backend->hasApplications() && backend->hasCheapEnumeration()) {
+        m_searchIndex->addBackend(backend);
+    }
 
     connect(backend, &AbstractResourcesBackend::allDataChanged, this, &ResourcesModel::updateCaller);
     connect(backend, &AbstractResourcesBackend::resourcesChanged, this, &ResourcesModel::resourceDataChanged);
@@ -209,8 +221,16 @@ void ResourcesModel::removeApplication(AbstractResource *app)
 void ResourcesModel::registerAllBackends()
 {
     DiscoverBackendsFactory f;
-    addResourcesBackends(f.allBackends());
-    m_isInitializing = false;
+    // Every plugin's backends are added as soon as they are created, instead of once all plugins are loaded
+    f.loadAllBackends(
+        this,
+        [this](const QVector<AbstractResourcesBackend *> &backends) {
+            addResourcesBackends(backends);
+        },
+        [this] {
+            m_isInitializing = false;
+            Q_EMIT isInitializingChanged();
+        });
 }
 
 void ResourcesModel::registerBackendByName(const QString &name)
@@ -232,9 +252,15 @@ bool ResourcesModel::isExtended(const QString &id)
     });
 }
 
+// About one frame at 60Hz
+static const std::chrono::milliseconds s_defaultFrameBudget(16);
+
 AggregatedResultsStream::AggregatedResultsStream(const QSet<ResultsStream *> &streams)
     : ResultsStream(QStringLiteral("AggregatedResultsStream"))
+    , m_frameBudget(s_defaultFrameBudget)
 {
+    m_lifetime.start();
+
     Q_ASSERT(!streams.contains(nullptr));
     if (streams.isEmpty()) {
         qCWarning(LIBDISCOVER_LOG) << "AggregatedResultsStream: No streams to aggregate!";
@@ -244,44 +270,154 @@ AggregatedResultsStream::AggregatedResultsStream(const QSet<ResultsStream *> &st
     for (const auto &stream : streams) {
         connect(stream, &ResultsStream::resourcesFound, this, &AggregatedResultsStream::addResults);
         connect(stream, &QObject::destroyed, this, &AggregatedResultsStream::streamDestruction);
-        connect(this, &ResultsStream::fetchMore, stream, &ResultsStream::fetchMore);
         m_streams << stream;
     }
+    connect(this, &ResultsStream::fetchMore, this, &AggregatedResultsStream::requestMore);
 
-    m_delayedEmission.setInterval(0);
+    m_delayedEmission.setSingleShot(true);
     connect(&m_delayedEmission, &QTimer::timeout, this, &AggregatedResultsStream::emitResults);
 }
 
 AggregatedResultsStream::~AggregatedResultsStream() = default;
 
-void AggregatedResultsStream::addResults(const QVector<StreamResult> &streams)
+// How many batches can be waiting before we stop asking for more
+static const int s_backPressureBatches = 4;
+
+void AggregatedResultsStream::setMaxBatchSize(int size)
 {
-    for (const auto &stream : streams) {
-        connect(stream.resource, &QObject::destroyed, this, &AggregatedResultsStream::resourceDestruction);
+    m_maxBatchSize = size;
+}
+
+void AggregatedResultsStream::setFrameBudget(std::chrono::milliseconds budget)
+{
+    m_frameBudget = budget;
+}
+
+void AggregatedResultsStream::addResults(const QVector<StreamResult> &results)
+{
+    AbstractResourcesBackend *lastBackend = nullptr;
+    m_results.reserve(m_results.size() + results.size());
+    for (const auto &result : results) {
+        // Resources are removed through their backend, rather than a connection per resource
+        AbstractResourcesBackend *backend = result.resource->backend();
+        if (backend != lastBackend && !m_backends.contains(backend)) {
+            m_backends.insert(backend);
+            connect(backend, &AbstractResourcesBackend::resourceRemoved, this, &AggregatedResultsStream::resourceRemoved);
+            // Backends don't remove their resources one by one when they go away
+            connect(backend, &AbstractResourcesBackend::invalidated, this, [this, backend] {
+                backendRemoved(backend);
+            });
+            connect(backend, &QObject::destroyed, this, [this, backend] {
+                backendRemoved(backend);
+            });
+        }
+        lastBackend = backend;
+
+        if (m_positions.tryEmplace(result.resource, m_offset + m_results.size()).inserted) {
+            m_results += PendingResult{result, backend};
+        }
     }
 
-    m_results += streams;
+    scheduleEmission();
+}
+
+void AggregatedResultsStream::scheduleEmission()
+{
+    if (m_delayedEmission.isActive()) {
+        return;
+    }
+
+    if (m_metrics.batches == 0) {
+        m_delayedEmission.start(0);
+        return;
+    }
 
-    m_delayedEmission.start();
+    // Give the consumer at least as much time for everything else as it needed for the last batch
+    const qint64 wait = std::max<qint64>(m_frameBudget.count(), m_lastConsumerTime) - m_sinceLastEmission.elapsed();
+    m_delayedEmission.start(std::max<qint64>(wait, 0));
 }
 
 void AggregatedResultsStream::emitResults()
 {
-    if (!m_results.isEmpty()) {
-        Q_EMIT resourcesFound(m_results);
-        m_results.clear();
+    QVector<StreamResult> batch;
+    const qsizetype pending = pendingCount();
+    batch.reserve(m_maxBatchSize > 0 ? std::min<qsizetype>(pending, m_maxBatchSize) : pending);
+    while (m_first < m_results.size() && (m_maxBatchSize <= 0 || batch.size() < m_maxBatchSize)) {
+        const StreamResult &result = m_results[m_first++].result;
+        if (result.resource) {
+            m_positions.remove(result.resource);
+            batch += result;
+        }
+    }
+
+    if (m_first == m_results.size() || m_first > m_results.size() / 2) {
+        m_results.remove(0, m_first);
+        m_offset += m_first;
+        m_first = 0;
     }
-    m_delayedEmission.setInterval(m_delayedEmission.interval() + 100);
-    m_delayedEmission.stop();
+
+    if (!batch.isEmpty()) {
+        if (m_metrics.batches == 0) {
+            m_metrics.timeToFirstBatch = m_lifetime.elapsed();
+        }
+        ++m_metrics.batches;
+        m_metrics.results += batch.size();
+        m_metrics.largestBatch = std::max(m_metrics.largestBatch, batch.size());
+
+        QElapsedTimer consumer;
+        consumer.start();
+        Q_EMIT resourcesFound(batch);
+        m_lastConsumerTime = consumer.elapsed();
+        m_metrics.consumerTime += m_lastConsumerTime;
+        m_metrics.longestConsumerTime = std::max(m_metrics.longestConsumerTime, m_lastConsumerTime);
+        m_sinceLastEmission.start();
+    }
+
+    if (pendingCount() > 0) {
+        scheduleEmission();
+    }
+
+    if (m_fetchMoreDeferred && pendingCount() < s_backPressureBatches * m_maxBatchSize) {
+        m_fetchMoreDeferred = false;
+        requestMore();
+    }
+    clear();
 }
 
-void AggregatedResultsStream::resourceDestruction(QObject *obj)
+void AggregatedResultsStream::requestMore()
 {
-    for (auto it = m_results.begin(); it != m_results.end(); ++it) {
-        if (obj == it->resource) {
-            it = m_results.erase(it);
-        } else {
-            ++it;
+    if (m_maxBatchSize > 0 && pendingCount() >= s_backPressureBatches * m_maxBatchSize) {
+        m_fetchMoreDeferred = true;
+        return;
+    }
+
+    for (QObject *stream : std::as_const(m_streams)) {
+        Q_EMIT static_cast<ResultsStream *>(stream)->fetchMore();
+    }
+}
+
+void AggregatedResultsStream::resourceRemoved(AbstractResource *resource)
+{
+    const auto it = m_positions.constFind(resource);
+    if (it != m_positions.constEnd()) {
+        m_results[*it - m_offset].result.resource = nullptr;
+        m_positions.erase(it);
+    }
+}
+
+void AggregatedResultsStream::backendRemoved(AbstractResourcesBackend *backend)
+{
+    if (!m_backends.remove(backend)) {
+        return;
+    }
+    disconnect(backend, nullptr, this, nullptr);
+
+    // The resources may be gone already, they're only used as keys
+    for (qsizetype i = m_first, size = m_results.size(); i < size; ++i) {
+        PendingResult &pending = m_results[i];
+        if (pending.backend == backend && pending.result.resource) {
+            m_positions.remove(pending.result.resource);
+            pending.result.resource = nullptr;
         }
     }
 }
@@ -294,11 +430,24 @@ void AggregatedResultsStream::streamDestruction(QObject *obj)
 
 void AggregatedResultsStream::clear()
 {
-    if (m_streams.isEmpty()) {
-        emitResults();
-        Q_EMIT finished();
-        deleteLater();
+    if (!m_streams.isEmpty() || m_finished) {
+        return;
+    }
+
+    // Offer what's left first, emitResults() comes back here once it's done
+    if (pendingCount() > 0) {
+        scheduleEmission();
+        return;
     }
+
+    m_finished = true;
+    m_metrics.totalTime = m_lifetime.elapsed();
+    qCDebug(LIBDISCOVER_LOG).nospace() << "AggregatedResultsStream: " << objectName() << " first batch after " << m_metrics.timeToFirstBatch << "ms, "
+                                       << m_metrics.results << " results in " << m_metrics.batches << " batches (largest " << m_metrics.largestBatch
+                                       << "), consumers took " << m_metrics.consumerTime << "ms (longest " << m_metrics.longestConsumerTime
+                                       << "ms), finished after " << m_metrics.totalTime << "ms";
+    Q_EMIT finished();
+    deleteLater();
 }
 
 AggregatedResultsStream *ResourcesModel::search(const AbstractResourcesBackend::Filters &search)
@@ -307,12 +456,40 @@ AggregatedResultsStream *ResourcesModel::search(const AbstractResourcesBackend::
         return new AggregatedResultsStream({new ResultsStream(QStringLiteral("emptysearch"), {})});
     }
 
-    auto streams = kTransform<QSet<ResultsStream *>>(m_backends, [search](AbstractResourcesBackend *backend) {
+    const bool indexable = m_searchIndex && SearchIndex::canAnswer(search);
+    auto streams = kTransform<QSet<ResultsStream *>>(m_backends, [this, search, indexable](AbstractResourcesBackend *backend) {
+        if (indexable) {
+            if (m_searchIndex->isIndexed(backend)) {
+                return new ResultsStream(u"SearchIndexStream"_s, m_searchIndex->search(backend, search.search));
+            }
+            // Until it's ready, the backend answers text searches itself
+            m_searchIndex->startIndexing(backend);
+        }
+        return backend->search(search);
+    });
+    return new AggregatedResultsStream(streams);
+}
+
+AggregatedResultsStream *ResourcesModel::search(const AbstractResourcesBackend::Filters &search, const QVector<AbstractResourcesBackend *> &backends)
+{
+    auto streams = kTransform<QSet<ResultsStream *>>(backends, [search](AbstractResourcesBackend *backend) {
         return backend->search(search);
     });
     return new AggregatedResultsStream(streams);
 }
 
+bool ResourcesModel::isSearchRefinable(AbstractResourcesBackend *backend, const AbstractResourcesBackend::Filters &search) const
+{
+    // The index only does textual matching as well
+    return backend->hasTextualSearch() || (m_searchIndex && SearchIndex::canAnswer(search) && m_searchIndex->isIndexed(backend));
+}
+
+bool ResourcesModel::resourceMatchesSearch(AbstractResource *resource, const AbstractResourcesBackend::Filters &search) const
+{
+    // The index finds what the backend would
+    return resource->backend()->matchesSearch(resource, search.search);
+}
+
 void ResourcesModel::checkForUpdates()
 {
     for (const auto backend : std::as_const(m_backends)) {
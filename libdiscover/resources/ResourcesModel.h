@@ -7,6 +7,7 @@
 #pragma once
 
 #include "EmitWhenChanged.h"
+#include <QElapsedTimer>
 #include <QSet>
 #include <QTimer>
 #include <QVector>
@@ -15,6 +16,7 @@
 #include "discovercommon_export.h"
 
 class DiscoverAction;
+class SearchIndex;
 
 class DISCOVERCOMMON_EXPORT AggregatedResultsStream : public ResultsStream
 {
@@ -28,19 +30,88 @@ public:
         return m_streams;
     }
 
+    /**
+     * Sets the most results to be offered in one resourcesFound(), 0 for no limit.
+     *
+     * The rest are offered in following event loop iterations, and fetchMore()
+     * isn't passed on to the streams while there's a few batches waiting.
+     */
+    void setMaxBatchSize(int size);
+    int maxBatchSize() const
+    {
+        return m_maxBatchSize;
+    }
+
+    /**
+     * Sets how often batches are offered at most.
+     *
+     * The first batch is offered as soon as there are results, the next ones
+     * gather what arrives in a frame, or as long as the consumer took to
+     * process the previous batch if that's longer.
+     */
+    void setFrameBudget(std::chrono::milliseconds budget);
+    std::chrono::milliseconds frameBudget() const
+    {
+        return m_frameBudget;
+    }
+
+    /// How results flowed through the stream, to tune the emission
+    struct Metrics {
+        qint64 timeToFirstBatch = -1;
+        qsizetype batches = 0;
+        qsizetype results = 0;
+        qsizetype largestBatch = 0;
+        // Time spent by the consumers in resourcesFound()
+        qint64 consumerTime = 0;
+        qint64 longestConsumerTime = 0;
+        qint64 totalTime = 0;
+    };
+    Metrics metrics() const
+    {
+        return m_metrics;
+    }
+
 Q_SIGNALS:
     void finished();
 
+protected:
+    virtual void resourceRemoved(AbstractResource *resource);
+
 private:
     void addResults(const QVector<StreamResult> &res);
+    void backendRemoved(AbstractResourcesBackend *backend);
     void emitResults();
     void streamDestruction(QObject *obj);
-    void resourceDestruction(QObject *obj);
+    void requestMore();
+    void scheduleEmission();
     void clear();
+    qsizetype pendingCount() const
+    {
+        return m_positions.size();
+    }
 
     QSet<QObject *> m_streams;
-    QVector<StreamResult> m_results;
+    // Backends whose resourceRemoved we listen to
+    QSet<AbstractResourcesBackend *> m_backends;
+    struct PendingResult {
+        StreamResult result;
+        AbstractResourcesBackend *backend;
+    };
+    // Results yet to be emitted from m_first on, removed ones are left as null
+    QVector<PendingResult> m_results;
+    qsizetype m_first = 0;
+    // Position of each pending resource, m_offset is how many results were dropped from the front
+    QHash<AbstractResource *, qsizetype> m_positions;
+    qsizetype m_offset = 0;
+    int m_maxBatchSize = 500;
+    std::chrono::milliseconds m_frameBudget;
+    bool m_fetchMoreDeferred = false;
+    bool m_finished = false;
     QTimer m_delayedEmission;
+    QElapsedTimer m_lifetime;
+    QElapsedTimer m_sinceLastEmission;
+    qint64 m_lastConsumerTime = 0;
+    Metrics m_metrics;
 };
 
 class DISCOVERCOMMON_EXPORT ResourcesModel : public QObject
@@ -56,6 +127,7 @@ class DISCOVERCOMMON_EXPORT ResourcesModel : public QObject
     Q_PROPERTY(QString applicationSourceName READ applicationSourceName NOTIFY currentApplicationBackendChanged)
     Q_PROPERTY(InlineMessage *inlineMessage READ inlineMessage NOTIFY inlineMessageChanged)
     Q_PROPERTY(QString distroName READ distroName CONSTANT)
+    Q_PROPERTY(bool isInitializing READ isInitializing NOTIFY isInitializingChanged)
 public:
     /** This constructor should be only used by unit tests.
      *  @p backendName defines what backend will be loaded when the backend is constructed.
@@ -71,11 +143,30 @@ public:
     }
     bool hasSecurityUpdates() const;
 
+    /// @returns whether backends are still being loaded, backendsChanged() is emitted as each plugin's are added
     bool isInitializing() const;
 
     Q_SCRIPTABLE bool isExtended(const QString &id);
 
     AggregatedResultsStream *search(const AbstractResourcesBackend::Filters &search);
+
+    /// Searches only in @p backends
+    AggregatedResultsStream *search(const AbstractResourcesBackend::Filters &search, const QVector<AbstractResourcesBackend *> &backends);
+
+    /**
+     * @returns whether the results of @p backend for @p search can be obtained
+     * by filtering its results for a search of a prefix of the same text
+     */
+    bool isSearchRefinable(AbstractResourcesBackend *backend, const AbstractResourcesBackend::Filters &search) const;
+
+    /// @returns whether @p resource is a result of @p search, for resources in refinable backends
+    bool resourceMatchesSearch(AbstractResource *resource, const AbstractResourcesBackend::Filters &search) const;
+
+    /// @returns the index text searches are answered from, if any
+    SearchIndex *searchIndex() const
+    {
+        return m_searchIndex;
+    }
     void checkForUpdates();
 
     QString applicationSourceName() const;
@@ -110,6 +201,7 @@ public Q_SLOTS:
 Q_SIGNALS:
     void fetchingChanged(bool isFetching);
     void backendsChanged();
+    void isInitializingChanged();
     void updatesCountChanged(int updatesCount);
     void backendDataChanged(AbstractResourcesBackend *backend, const QVector<QByteArray> &properties);
     void resourceDataChanged(AbstractResource *resource, const QVector<QByteArray> &properties);
@@ -143,6 +235,7 @@ private:
     EmitWhenChanged<int> m_updatesCount;
     EmitWhenChanged<int> m_fetchingUpdatesProgress;
     QSharedPointer<InlineMessage> m_inlineMessage;
+    SearchIndex *m_searchIndex = nullptr;
 
     static ResourcesModel *s_self;
     static bool s_quitting;
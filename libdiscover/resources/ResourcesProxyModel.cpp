@@ -9,7 +9,9 @@
 
 #include "libdiscover_debug.h"
 #include <QMetaProperty>
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <qnamespace.h>
 #include <utils.h>
 
@@ -43,43 +45,6 @@ const QHash<int, QByteArray> ResourcesProxyModel::s_roles = {{NameRole, "name"},
                                                              {SizeRole, "size"},
                                                              {ReleaseDateRole, "releaseDate"}};
 
-int levenshteinDistance(QStringView source, QStringView target)
-{
-    if (source.compare(target, Qt::CaseInsensitive) == 0) {
-        return 0;
-    }
-
-    const int sourceCount = source.size();
-    const int targetCount = target.size();
-
-    if (source.isEmpty()) {
-        return targetCount;
-    }
-
-    if (target.isEmpty()) {
-        return sourceCount;
-    }
-
-    QVector<int> column;
-    column.fill(0, targetCount + 1);
-    QVector<int> previousColumn;
-    previousColumn.reserve(targetCount + 1);
-    for (int i = 0; i < targetCount + 1; i++) {
-        previousColumn.append(i);
-    }
-
-    for (int i = 0; i < sourceCount; i++) {
-        column[0] = i + 1;
-        for (int j = 0; j < targetCount; j++) {
-            column[j + 1] =
-                std::min({1 + column.at(j), 1 + previousColumn.at(1 + j), previousColumn.at(j) + ((source.at(i).toUpper() == target.at(j).toUpper()) ? 0 : 1)});
-        }
-        column.swap(previousColumn);
-    }
-
-    return previousColumn.at(targetCount);
-}
-
 ResourcesProxyModel::ResourcesProxyModel(QObject *parent)
     : QAbstractListModel(parent)
     , m_sortRole(NameRole)
@@ -141,35 +106,93 @@ void ResourcesProxyModel::setSearch(const QString &_searchText)
     const QString searchText = _searchText.size() <= 1 ? QString() : _searchText;
 
     if (m_filters.search != searchText) {
+        const QString previousSearch = m_filters.search;
         m_filters.search = searchText;
-        invalidateFilter();
+        m_relevance = SearchRelevance(searchText);
+        if (!refineSearch(previousSearch)) {
+            invalidateFilter();
+        }
         Q_EMIT searchChanged(m_filters.search);
     }
 }
 
-void ResourcesProxyModel::removeDuplicates(QVector<StreamResult> &resources)
+QSet<AbstractResourcesBackend *> ResourcesProxyModel::refinableBackends(const QVector<AbstractResourcesBackend *> &backends) const
 {
-    const auto currentApplicationBackend = ResourcesModel::global()->currentApplicationBackend();
-    QHash<QString, QString> aliases;
-    QHash<QString, QVector<StreamResult>::iterator> storedIds;
-    for (auto it = m_displayedResources.begin(); it != m_displayedResources.end(); ++it) {
-        const auto appstreamid = it->resource->appstreamId();
-        if (appstreamid.isEmpty()) {
+    QSet<AbstractResourcesBackend *> ret;
+    for (auto backend : backends) {
+        if (ResourcesModel::global()->isSearchRefinable(backend, m_filters)) {
+            ret.insert(backend);
+        }
+    }
+    return ret;
+}
+
+// When the search is extended (e.g. "fire" to "firef"), the new results are
+// a subset of what we have for the backends whose results came from a textual
+// search, so these don't need to be queried again.
+bool ResourcesProxyModel::refineSearch(const QString &previousSearch)
+{
+    // We need to have all the results of the previous search
+    if (!m_setup || m_currentStream || m_filters.backend || previousSearch.isEmpty() || !m_filters.search.startsWith(previousSearch, Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    // Only what was answered textually last time can be filtered with the same predicate,
+    // the other backends are queried again and their resources come back if they still match
+    const auto backends = ResourcesModel::global()->backends();
+    const auto requery = kFilter<QVector<AbstractResourcesBackend *>>(backends, [this](AbstractResourcesBackend *backend) {
+        return !m_refinableBackends.contains(backend);
+    });
+    const auto keep = [this](AbstractResource *resource) {
+        return m_refinableBackends.contains(resource->backend()) && ResourcesModel::global()->resourceMatchesSearch(resource, m_filters);
+    };
+
+    // Remove from the end so the rows don't shift under us
+    for (int row = m_displayedResources.count() - 1; row >= 0;) {
+        if (keep(m_displayedResources[row].resource)) {
+            --row;
             continue;
         }
-        auto at = storedIds.find(appstreamid);
-        if (at == storedIds.end()) {
-            storedIds[appstreamid] = it;
-        } else {
-            qCWarning(LIBDISCOVER_LOG) << "We should have sanitized the displayed resources. There is a bug";
-            Q_UNREACHABLE();
+
+        int first = row;
+        while (first > 0 && !keep(m_displayedResources[first - 1].resource)) {
+            --first;
         }
+        beginRemoveRows({}, first, row);
+        m_displayedResources.remove(first, row - first + 1);
+        m_sortKeys.erase(m_sortKeys.begin() + first, m_sortKeys.begin() + row + 1);
+        m_displayedIdsValid = false;
+        endRemoveRows();
+        row = first - 1;
+    }
 
-        const auto alts = it->resource->alternativeAppstreamIds();
-        for (const auto &alias : alts) {
-            aliases[alias] = appstreamid;
+    // The relevance depends on the search text, sorting extracts the keys again
+    if (m_sortRole == SearchRelevanceRole) {
+        sortInPlace();
+    }
+
+    if (!requery.isEmpty()) {
+        m_refinableBackends += refinableBackends(requery);
+        setCurrentStream(ResourcesModel::global()->search(m_filters, requery));
+    }
+    fetchSubcategories();
+    return true;
+}
+
+void ResourcesProxyModel::removeDuplicates(QVector<StreamResult> &resources)
+{
+    const auto currentApplicationBackend = ResourcesModel::global()->currentApplicationBackend();
+    // Rebuilding this for every batch would make listing everything quadratic
+    if (!m_displayedIdsValid) {
+        m_displayedIds.clear();
+        m_displayedAliases.clear();
+        for (const auto &result : std::as_const(m_displayedResources)) {
+            addDisplayedId(result);
         }
+        m_displayedIdsValid = true;
     }
+    auto &aliases = m_displayedAliases;
+    auto &storedIds = m_displayedIds;
 
     QHash<QString, QVector<StreamResult>::iterator> ids;
     for (auto it = resources.begin(); it != resources.end();) {
@@ -243,13 +266,54 @@ void ResourcesProxyModel::removeDuplicates(QVector<StreamResult> &resources)
             }
         } else {
             if (it->resource->backend() == currentApplicationBackend) {
-                **at = *it;
-                auto pos = index(*at - m_displayedResources.begin(), 0);
+                const int row = displayedRow(*at);
+                m_displayedResources[row] = *it;
+                m_sortKeys[row] = sortKey(*it);
+                *at = *it;
+                auto pos = index(row, 0);
                 Q_EMIT dataChanged(pos, pos);
             }
             it = resources.erase(it);
         }
     }
+
+    // What's left is going to be displayed
+    for (const auto &result : std::as_const(resources)) {
+        addDisplayedId(result);
+    }
+}
+
+void ResourcesProxyModel::addDisplayedId(const StreamResult &result)
+{
+    const auto appstreamid = result.resource->appstreamId();
+    if (appstreamid.isEmpty()) {
+        return;
+    }
+    if (m_displayedIds.contains(appstreamid)) {
+        qCWarning(LIBDISCOVER_LOG) << "We should have sanitized the displayed resources. There is a bug";
+        Q_UNREACHABLE();
+    }
+    m_displayedIds.insert(appstreamid, result);
+
+    const auto alts = result.resource->alternativeAppstreamIds();
+    for (const auto &alias : alts) {
+        m_displayedAliases[alias] = appstreamid;
+    }
+}
+
+int ResourcesProxyModel::displayedRow(const StreamResult &result)
+{
+    // The rows are sorted, so the resource is among those with the same key unless its data changed since
+    const auto [first, last] = std::equal_range(m_sortKeys.cbegin(), m_sortKeys.cend(), sortKey(result), [this](const SortKey &left, const SortKey &right) {
+        return sortKeyLessThan(left, right);
+    });
+    for (auto key = first; key != last; ++key) {
+        const int row = int(key - m_sortKeys.cbegin());
+        if (m_displayedResources[row].resource == result.resource) {
+            return row;
+        }
+    }
+    return indexOf(result.resource);
 }
 
 void ResourcesProxyModel::addResources(const QVector<StreamResult> &results)
@@ -261,10 +325,6 @@ void ResourcesProxyModel::addResources(const QVector<StreamResult> &results)
         return;
     }
 
-    std::sort(resultsCopy.begin(), resultsCopy.end(), [this](const auto &left, const auto &right) {
-        return orderedLessThan(left, right);
-    });
-
     sortedInsertion(resultsCopy);
     fetchSubcategories();
 }
@@ -276,12 +336,34 @@ void ResourcesProxyModel::invalidateSorting()
     }
 
     beginResetModel();
-    std::sort(m_displayedResources.begin(), m_displayedResources.end(), [this](const auto &left, const auto &right) {
-        return orderedLessThan(left, right);
-    });
+    sortWithKeys(m_displayedResources, m_sortKeys);
     endResetModel();
 }
 
+// Like invalidateSorting, but keeps the views' state by reporting a layout change
+void ResourcesProxyModel::sortInPlace()
+{
+    if (m_displayedResources.isEmpty()) {
+        return;
+    }
+
+    Q_EMIT layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    const auto persistent = persistentIndexList();
+    const auto persistentResources = kTransform<QVector<AbstractResource *>>(persistent, [this](const QModelIndex &index) {
+        return m_displayedResources[index.row()].resource;
+    });
+
+    sortWithKeys(m_displayedResources, m_sortKeys);
+
+    QModelIndexList updated;
+    updated.reserve(persistent.size());
+    for (AbstractResource *resource : persistentResources) {
+        updated += index(indexOf(resource), 0);
+    }
+    changePersistentIndexList(persistent, updated);
+    Q_EMIT layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
 QString ResourcesProxyModel::lastSearch() const
 {
     return m_filters.search;
@@ -377,14 +459,27 @@ void ResourcesProxyModel::invalidateFilter()
         delete m_currentStream;
     }
 
-    m_currentStream = m_filters.backend ? m_filters.backend->search(m_filters) : ResourcesModel::global()->search(m_filters);
-    Q_EMIT busyChanged();
+    if (m_filters.backend) {
+        m_refinableBackends.clear();
+        setCurrentStream(m_filters.backend->search(m_filters));
+    } else {
+        m_refinableBackends = refinableBackends(ResourcesModel::global()->backends());
+        setCurrentStream(ResourcesModel::global()->search(m_filters));
+    }
 
     if (!m_displayedResources.isEmpty()) {
         beginResetModel();
         m_displayedResources.clear();
+        m_sortKeys.clear();
+        m_displayedIdsValid = false;
         endResetModel();
     }
+}
+
+void ResourcesProxyModel::setCurrentStream(ResultsStream *stream)
+{
+    m_currentStream = stream;
+    Q_EMIT busyChanged();
 
     connect(m_currentStream, &ResultsStream::resourcesFound, this, &ResourcesProxyModel::addResources);
     connect(m_currentStream, &ResultsStream::destroyed, this, [this]() {
@@ -402,38 +497,153 @@ int ResourcesProxyModel::rowCount(const QModelIndex &parent) const
 // fallback mechanism to use secondary sort role and order.
 bool ResourcesProxyModel::orderedLessThan(const StreamResult &left, const StreamResult &right) const
 {
-    // (role, order) pair
-    using SortCombination = std::pair<Roles, Qt::SortOrder>;
-    std::vector<SortCombination> sortFallbackChain = {{
-        {m_sortRole, m_sortOrder},
-        {NameRole, Qt::AscendingOrder},
-    }};
+    return sortKeyLessThan(sortKey(left), sortKey(right));
+}
 
-    if (m_categorize) {
-        sortFallbackChain.insert(sortFallbackChain.begin(), {CategoryRole, Qt::AscendingOrder});
+ResourcesProxyModel::SortKeyKind ResourcesProxyModel::sortKeyKind(Roles role)
+{
+    switch (role) {
+    case NameRole:
+        return SortKeyKind::Name;
+    case CategoryRole:
+    case StateRole:
+    case InstalledRole:
+    case CanUpgrade:
+    case RatingRole:
+    case RatingPointsRole:
+    case RatingCountRole:
+    case SortableRatingRole:
+    case SearchRelevanceRole:
+        return SortKeyKind::Number;
+    case SizeRole:
+        return SortKeyKind::Size;
+    case ReleaseDateRole:
+        return SortKeyKind::Date;
+    default:
+        return SortKeyKind::Other;
     }
+}
 
-    for (const auto &[role, order] : sortFallbackChain) {
-        QVariant leftValue = roleToOrderedValue(left, role);
-        QVariant rightValue = roleToOrderedValue(right, role);
-
-        if (leftValue == rightValue) {
-            continue;
+ResourcesProxyModel::SortKey ResourcesProxyModel::sortKey(const StreamResult &result) const
+{
+    AbstractResource *resource = result.resource;
+    SortKey key{.category = resource->type(), .name = resource->nameSortKey()};
+    switch (sortKeyKind(m_sortRole)) {
+    case SortKeyKind::Name:
+        break;
+    case SortKeyKind::Number:
+        switch (m_sortRole) {
+        case CategoryRole:
+            key.number = key.category;
+            break;
+        case StateRole:
+            key.number = resource->state();
+            break;
+        case InstalledRole:
+            key.number = resource->isInstalled();
+            break;
+        case CanUpgrade:
+            key.number = resource->canUpgrade();
+            break;
+        case RatingRole:
+            key.number = resource->rating().rating();
+            break;
+        case RatingPointsRole:
+            key.number = resource->rating().ratingPoints();
+            break;
+        case RatingCountRole:
+            key.number = resource->rating().ratingCount();
+            break;
+        case SortableRatingRole:
+            key.number = resource->rating().sortableRating();
+            break;
+        default:
+            key.number = roleToValue(result, m_sortRole).toReal();
+            break;
         }
+        break;
+    case SortKeyKind::Size:
+        key.size = resource->size();
+        break;
+    case SortKeyKind::Date:
+        key.date = resource->releaseDate();
+        break;
+    case SortKeyKind::Other:
+        key.other = roleToValue(result, m_sortRole);
+        break;
+    }
+    return key;
+}
 
-        const auto result = QVariant::compare(leftValue, rightValue);
+template<typename T>
+static int threeWayCompare(const T &left, const T &right)
+{
+    return left < right ? -1 : (right < left ? 1 : 0);
+}
 
-        // Should not happen, but it's better to skip than assert
-        if (!(result == QPartialOrdering::Less || result == QPartialOrdering::Greater)) {
-            continue;
+int ResourcesProxyModel::compareSortKeys(const SortKey &left, const SortKey &right) const
+{
+    switch (sortKeyKind(m_sortRole)) {
+    case SortKeyKind::Name:
+        return left.name.compare(right.name);
+    case SortKeyKind::Number:
+        return threeWayCompare(left.number, right.number);
+    case SortKeyKind::Size:
+        return threeWayCompare(left.size, right.size);
+    case SortKeyKind::Date:
+        return threeWayCompare(left.date, right.date);
+    case SortKeyKind::Other: {
+        if (left.other == right.other) {
+            return 0;
         }
+        // Should not be unordered, but it's better to skip than assert
+        const auto result = QVariant::compare(left.other, right.other);
+        return result == QPartialOrdering::Less ? -1 : (result == QPartialOrdering::Greater ? 1 : 0);
+    }
+    }
+    Q_UNREACHABLE();
+    return 0;
+}
+
+bool ResourcesProxyModel::sortKeyLessThan(const SortKey &left, const SortKey &right) const
+{
+    if (m_categorize && left.category != right.category) {
+        return left.category < right.category;
+    }
 
-        // Yes, there is a shorter but incomprehensible way of rewriting this
-        return (order == Qt::AscendingOrder) ? (result == QPartialOrdering::Less) : (result == QPartialOrdering::Greater);
+    const int result = compareSortKeys(left, right);
+    if (result != 0) {
+        return m_sortOrder == Qt::AscendingOrder ? result < 0 : result > 0;
     }
 
-    // They compared equal, so it is definitely not a "less than" relation
-    return false;
+    return left.name.compare(right.name) < 0;
+}
+
+// Extracts the sort key of every result once and sorts both lists accordingly
+void ResourcesProxyModel::sortWithKeys(QVector<StreamResult> &results, std::vector<SortKey> &keys) const
+{
+    keys.clear();
+    keys.reserve(results.size());
+    for (const auto &result : std::as_const(results)) {
+        keys.push_back(sortKey(result));
+    }
+
+    std::vector<qsizetype> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this, &keys](qsizetype left, qsizetype right) {
+        return sortKeyLessThan(keys[left], keys[right]);
+    });
+
+    QVector<StreamResult> sortedResults;
+    sortedResults.reserve(results.size());
+    std::vector<SortKey> sortedKeys;
+    sortedKeys.reserve(keys.size());
+    for (const qsizetype idx : order) {
+        sortedResults.append(results[idx]);
+        sortedKeys.push_back(std::move(keys[idx]));
+    }
+    results = std::move(sortedResults);
+    keys = std::move(sortedKeys);
 }
 
 std::shared_ptr<Category> ResourcesProxyModel::filteredCategory() const
@@ -534,6 +744,9 @@ QVariant ResourcesProxyModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
     const auto result = m_displayedResources[index.row()];
+    if (role == SearchRelevanceRole && m_sortRole == SearchRelevanceRole) {
+        return m_sortKeys[index.row()].number;
+    }
     return roleToValue(result, role);
 }
 
@@ -588,24 +801,8 @@ QVariant ResourcesProxyModel::roleToValue(const StreamResult &result, int role)
         return rating.sortableRating();
     }
     case SearchRelevanceRole: {
-        qreal rating = roleToValue(result, SortableRatingRole).value<qreal>();
-
-        qreal reverseDistance = 0;
-        const QString name = resource->name();
-        const auto words = QStringView(name).split(QLatin1Char(' '));
-        for (QStringView word : words) {
-            const qreal maxLength = std::max(word.length(), m_filters.search.length());
-            reverseDistance =
-                std::max(reverseDistance, (maxLength - std::min(reverseDistance, qreal(levenshteinDistance(word, m_filters.search)))) / maxLength * 10.0);
-        }
-
-        qreal exactMatch = 0.0;
-        if (resource->name().toUpper() == m_filters.search.toUpper()) {
-            exactMatch = 10.0;
-        } else if (resource->name().contains(m_filters.search, Qt::CaseInsensitive)) {
-            exactMatch = 5.0;
-        }
-        return qreal(result.sortScore) / 100 + rating + reverseDistance + exactMatch;
+        const qreal rating = resource->rating().sortableRating();
+        return qreal(result.sortScore) / 100 + rating + m_relevance.nameScore(resource->foldedName());
     }
     case Qt::DecorationRole:
     case Qt::DisplayRole:
@@ -625,18 +822,6 @@ QVariant ResourcesProxyModel::roleToValue(const StreamResult &result, int role)
     }
 }
 
-// Wraps roleToValue with additional features for sorting/comparison.
-QVariant ResourcesProxyModel::roleToOrderedValue(const StreamResult &result, int role) const
-{
-    AbstractResource *resource = result.resource;
-    switch (role) {
-    case NameRole:
-        return QVariant::fromValue(resource->nameSortKey());
-    default:
-        return roleToValue(result, role);
-    }
-}
-
 bool ResourcesProxyModel::isSorted(const QVector<StreamResult> &results)
 {
     auto last = results.constFirst();
@@ -664,32 +849,109 @@ void ResourcesProxyModel::sortedInsertion(const QVector<StreamResult> &results)
         if (resultsCopy.isEmpty()) {
             return;
         }
+    } else {
+        m_displayedIdsValid = false;
     }
 
+    std::vector<SortKey> keys;
+    sortWithKeys(resultsCopy, keys);
+
     if (m_displayedResources.isEmpty()) {
         int rows = rowCount();
         beginInsertRows({}, rows, rows + resultsCopy.count() - 1);
         m_displayedResources += resultsCopy;
+        m_sortKeys = std::move(keys);
         endInsertRows();
         return;
     }
 
-    for (const auto &result : std::as_const(resultsCopy)) {
-        const auto finder = [this](const StreamResult &left, const StreamResult &right) {
-            return orderedLessThan(left, right);
-        };
-        const auto it = std::upper_bound(m_displayedResources.constBegin(), m_displayedResources.constEnd(), result, finder);
-        const auto prev = it - 1;
-        const auto newIdx = it == m_displayedResources.constEnd() ? m_displayedResources.count() : (it - m_displayedResources.constBegin());
+    mergeInsertion(resultsCopy, keys);
+}
+
+// Above this many separate insertion points it's cheaper for the views to
+// just reload the model than to process every rowsInserted.
+static constexpr qsizetype s_maxInsertionRanges = 64;
 
-        if (prev != m_displayedResources.constEnd() && prev->resource == result.resource) {
+// Merges the sorted @p results into the displayed resources in a single pass.
+void ResourcesProxyModel::mergeInsertion(const QVector<StreamResult> &results, std::vector<SortKey> &keys)
+{
+    struct InsertionRange {
+        qsizetype position; // row before which the range goes, in the current rows
+        qsizetype first; // first index in accepted
+        qsizetype count;
+    };
+
+    QVector<StreamResult> accepted;
+    accepted.reserve(results.size());
+    std::vector<SortKey> acceptedKeys;
+    acceptedKeys.reserve(keys.size());
+    QVector<InsertionRange> ranges;
+
+    const qsizetype displayedCount = m_displayedResources.count();
+    qsizetype position = 0;
+    for (qsizetype i = 0, count = results.count(); i < count; ++i) {
+        // equivalent to upper_bound, the incoming results are sorted so we never need to go back
+        while (position < displayedCount && !sortKeyLessThan(keys[i], m_sortKeys[position])) {
+            ++position;
+        }
+
+        const bool extendsLastRange = !ranges.isEmpty() && ranges.constLast().position == position;
+        const auto previous = extendsLastRange ? accepted.constLast().resource : (position > 0 ? m_displayedResources[position - 1].resource : nullptr);
+        if (previous == results[i].resource) {
             continue;
         }
 
-        beginInsertRows({}, newIdx, newIdx);
-        m_displayedResources.insert(newIdx, result);
+        if (extendsLastRange) {
+            ranges.last().count++;
+        } else {
+            ranges.append({position, accepted.count(), 1});
+        }
+        accepted.append(results[i]);
+        acceptedKeys.push_back(std::move(keys[i]));
+    }
+
+    if (ranges.isEmpty()) {
+        return;
+    }
+
+    if (ranges.count() > s_maxInsertionRanges) {
+        QVector<StreamResult> merged;
+        merged.reserve(displayedCount + accepted.count());
+        std::vector<SortKey> mergedKeys;
+        mergedKeys.reserve(displayedCount + accepted.count());
+
+        qsizetype displayed = 0;
+        for (const auto &range : std::as_const(ranges)) {
+            for (; displayed < range.position; ++displayed) {
+                merged.append(m_displayedResources[displayed]);
+                mergedKeys.push_back(std::move(m_sortKeys[displayed]));
+            }
+            for (qsizetype i = range.first; i < range.first + range.count; ++i) {
+                merged.append(accepted[i]);
+                mergedKeys.push_back(std::move(acceptedKeys[i]));
+            }
+        }
+        for (; displayed < displayedCount; ++displayed) {
+            merged.append(m_displayedResources[displayed]);
+            mergedKeys.push_back(std::move(m_sortKeys[displayed]));
+        }
+
+        beginResetModel();
+        m_displayedResources = std::move(merged);
+        m_sortKeys = std::move(mergedKeys);
+        endResetModel();
+        return;
+    }
+
+    // Insert from the end so the positions we computed stay valid
+    for (auto it = ranges.crbegin(); it != ranges.crend(); ++it) {
+        beginInsertRows({}, it->position, it->position + it->count - 1);
+        m_displayedResources.insert(it->position, it->count, StreamResult());
+        std::copy(accepted.cbegin() + it->first, accepted.cbegin() + it->first + it->count, m_displayedResources.begin() + it->position);
+        m_sortKeys.insert(m_sortKeys.begin() + it->position,
+                          std::make_move_iterator(acceptedKeys.begin() + it->first),
+                          std::make_move_iterator(acceptedKeys.begin() + it->first + it->count));
         endInsertRows();
-        // Q_ASSERT(isSorted(resultsCopy));
     }
 }
 
@@ -701,9 +963,7 @@ void ResourcesProxyModel::refreshResource(AbstractResource *resource, const QVec
     }
 
     if (!m_filters.shouldFilter(resource)) {
-        beginRemoveRows({}, row, row);
-        m_displayedResources.removeAt(row);
-        endRemoveRows();
+        removeDisplayedRow(row);
         return;
     }
 
@@ -711,9 +971,7 @@ void ResourcesProxyModel::refreshResource(AbstractResource *resource, const QVec
     Q_ASSERT(idx.isValid());
     const auto roles = propertiesToRoles(properties);
     if (roles.contains(m_sortRole)) {
-        beginRemoveRows({}, row, row);
-        m_displayedResources.removeAt(row);
-        endRemoveRows();
+        removeDisplayedRow(row);
 
         sortedInsertion({{resource, 0}});
     } else {
@@ -727,8 +985,15 @@ void ResourcesProxyModel::removeResource(AbstractResource *resource)
     if (residx < 0) {
         return;
     }
-    beginRemoveRows({}, residx, residx);
-    m_displayedResources.removeAt(residx);
+    removeDisplayedRow(residx);
+}
+
+void ResourcesProxyModel::removeDisplayedRow(int row)
+{
+    beginRemoveRows({}, row, row);
+    m_displayedResources.removeAt(row);
+    m_sortKeys.erase(m_sortKeys.begin() + row);
+    m_displayedIdsValid = false;
     endRemoveRows();
 }
 
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <QDate>
 #include <QQmlParserStatus>
+#include <QSet>
 #include <QSortFilterProxyModel>
 #include <QString>
 #include <QStringList>
@@ -17,6 +19,7 @@
 
 #include "AbstractResource.h"
 #include "AbstractResourcesBackend.h"
+#include "SearchRelevance.h"
 #include "discovercommon_export.h"
 
 class AggregatedResultsStream;
@@ -173,14 +176,48 @@ private Q_SLOTS:
     void removeResource(AbstractResource *resource);
 
 private:
+    /**
+     * Sort information extracted from a resource once per sort role, so that
+     * comparisons don't need to go through QVariant and the meta-object.
+     * Only the field matching the current sort role is meaningful.
+     */
+    struct SortKey {
+        AbstractResource::Type category;
+        QCollatorSortKey name;
+        qreal number = 0;
+        quint64 size = 0;
+        QDate date;
+        QVariant other;
+    };
+    enum class SortKeyKind {
+        Name,
+        Number,
+        Size,
+        Date,
+        Other,
+    };
+    static SortKeyKind sortKeyKind(Roles role);
+
+    SortKey sortKey(const StreamResult &result) const;
+    int compareSortKeys(const SortKey &left, const SortKey &right) const;
+    bool sortKeyLessThan(const SortKey &left, const SortKey &right) const;
+    void sortWithKeys(QVector<StreamResult> &results, std::vector<SortKey> &keys) const;
+
     void sortedInsertion(const QVector<StreamResult> &results);
+    void mergeInsertion(const QVector<StreamResult> &results, std::vector<SortKey> &keys);
     QVariant roleToValue(const StreamResult &result, int role) const;
-    QVariant roleToOrderedValue(const StreamResult &result, int role) const;
+    void removeDisplayedRow(int row);
+    void sortInPlace();
+    bool refineSearch(const QString &previousSearch);
+    QSet<AbstractResourcesBackend *> refinableBackends(const QVector<AbstractResourcesBackend *> &backends) const;
+    void setCurrentStream(ResultsStream *stream);
 
     QVector<int> propertiesToRoles(const QVector<QByteArray> &properties) const;
     void addResources(const QVector<StreamResult> &results);
     void fetchSubcategories();
     void removeDuplicates(QVector<StreamResult> &newResources);
+    void addDisplayedId(const StreamResult &result);
+    int displayedRow(const StreamResult &result);
     bool isSorted(const QVector<StreamResult> &results);
 
     Roles m_sortRole;
@@ -190,9 +227,19 @@ private:
     QString m_categoryName;
 
     AbstractResourcesBackend::Filters m_filters;
+    // The backends whose current results came from a textual search, see refineSearch()
+    QSet<AbstractResourcesBackend *> m_refinableBackends;
+    SearchRelevance m_relevance;
     QVariantList m_subcategories;
 
     QVector<StreamResult> m_displayedResources;
+    // Parallel to m_displayedResources, computed for m_sortRole
+    std::vector<SortKey> m_sortKeys;
+    // The displayed resources by AppStream id and the ids they are also known as,
+    // kept as batches come in and rebuilt after resources are removed
+    QHash<QString, StreamResult> m_displayedIds;
+    QHash<QString, QString> m_displayedAliases;
+    bool m_displayedIdsValid = false;
     static const QHash<int, QByteArray> s_roles;
     static QHash<int, int> createRoleToProperty();
     ResultsStream *m_currentStream;
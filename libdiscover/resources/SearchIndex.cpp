@@ -0,0 +1,273 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "SearchIndex.h"
+#include "libdiscover_debug.h"
+
+#include <QElapsedTimer>
+
+template<typename Func>
+static void forEachWord(QStringView text, Func func)
+{
+    qsizetype wordStart = -1;
+    for (qsizetype i = 0, size = text.size(); i <= size; ++i) {
+        const bool inWord = i < size && text[i].isLetterOrNumber();
+        if (inWord && wordStart < 0) {
+            wordStart = i;
+        } else if (!inWord && wordStart >= 0) {
+            func(text.mid(wordStart, i - wordStart));
+            wordStart = -1;
+        }
+    }
+}
+
+SearchIndex::SearchIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SearchIndex::~SearchIndex() = default;
+
+bool SearchIndex::canAnswer(const AbstractResourcesBackend::Filters &filters)
+{
+    return !filters.search.isEmpty() && !filters.category && filters.state == AbstractResource::Broken && filters.mimetype.isEmpty()
+        && filters.extends.isEmpty() && filters.resourceUrl.isEmpty() && filters.origin.isEmpty();
+}
+
+void SearchIndex::addBackend(AbstractResourcesBackend *backend)
+{
+    Q_ASSERT(!m_backends.contains(backend));
+    Q_ASSERT(backend->hasCheapEnumeration());
+    m_backends.insert(backend, {});
+
+    connect(backend, &AbstractResourcesBackend::contentsChanged, this, [this, backend] {
+        auto it = m_backends.find(backend);
+        if (it == m_backends.end()) {
+            return;
+        }
+        if (it->listing) {
+            it->stale = true;
+        } else if (it->complete) {
+            // Keep answering from what we have while the new contents are listed
+            list(backend, *it);
+        }
+    });
+    connect(backend, &AbstractResourcesBackend::resourcesChanged, this, [this, backend](AbstractResource *resource) {
+        auto it = m_backends.find(backend);
+        if (it != m_backends.end() && it->positions.contains(resource)) {
+            setEntry(backend, *it, resource);
+        }
+    });
+    connect(backend, &AbstractResourcesBackend::resourceRemoved, this, [this, backend](AbstractResource *resource) {
+        auto it = m_backends.find(backend);
+        if (it != m_backends.end()) {
+            removeEntry(*it, resource);
+            it->listed.remove(resource);
+        }
+    });
+    connect(backend, &QObject::destroyed, this, [this, backend] {
+        m_backends.remove(backend);
+    });
+}
+
+void SearchIndex::removeBackend(AbstractResourcesBackend *backend)
+{
+    const auto it = m_backends.constFind(backend);
+    if (it == m_backends.constEnd()) {
+        return;
+    }
+
+    // The stream belongs to the backend, it's left to finish on its own
+    if (it->listing) {
+        disconnect(it->listing, nullptr, this, nullptr);
+    }
+    m_backends.erase(it);
+    disconnect(backend, nullptr, this, nullptr);
+}
+
+bool SearchIndex::isIndexed(AbstractResourcesBackend *backend) const
+{
+    const auto it = m_backends.constFind(backend);
+    return it != m_backends.constEnd() && it->complete;
+}
+
+void SearchIndex::startIndexing(AbstractResourcesBackend *backend)
+{
+    auto it = m_backends.find(backend);
+    if (it == m_backends.end() || it->complete || it->listing) {
+        return;
+    }
+    list(backend, *it);
+}
+
+void SearchIndex::list(AbstractResourcesBackend *backend, BackendIndex &index)
+{
+    // An unfiltered search lists everything the backend offers
+    auto stream = backend->search({});
+    index.listing = stream;
+    index.listed.clear();
+    index.stale = false;
+
+    auto timer = std::make_shared<QElapsedTimer>();
+    timer->start();
+    connect(stream, &ResultsStream::resourcesFound, this, [this, backend](const QVector<StreamResult> &results) {
+        auto it = m_backends.find(backend);
+        if (it == m_backends.end()) {
+            return;
+        }
+        for (const auto &result : results) {
+            setEntry(backend, *it, result.resource);
+            it->listed.insert(result.resource);
+        }
+    });
+    connect(stream, &QObject::destroyed, this, [this, backend, timer] {
+        listingFinished(backend);
+        qCDebug(LIBDISCOVER_LOG) << "indexed" << backend->name() << "in" << timer->elapsed() << "ms";
+    });
+}
+
+void SearchIndex::listingFinished(AbstractResourcesBackend *backend)
+{
+    auto it = m_backends.find(backend);
+    if (it == m_backends.end()) {
+        return;
+    }
+
+    // What wasn't listed this time isn't offered anymore
+    const auto indexedResources = it->positions.keys();
+    for (AbstractResource *resource : indexedResources) {
+        if (!it->listed.contains(resource)) {
+            removeEntry(*it, resource);
+        }
+    }
+    it->listed.clear();
+
+    if (it->stale) {
+        list(backend, *it);
+    }
+    if (!it->complete) {
+        it->complete = true;
+        Q_EMIT indexed(backend);
+    }
+}
+
+void SearchIndex::setEntry(AbstractResourcesBackend *backend, BackendIndex &index, AbstractResource *resource)
+{
+    QString text = backend->searchTexts(resource).join(QLatin1Char('\n')).toCaseFolded();
+
+    auto position = index.positions.constFind(resource);
+    if (position != index.positions.constEnd()) {
+        Entry &entry = index.entries[*position];
+        if (entry.text == text) {
+            return;
+        }
+        removeWords(index, *position);
+        entry.text = std::move(text);
+        addWords(index, *position);
+        return;
+    }
+
+    qsizetype newPosition;
+    if (index.freePositions.isEmpty()) {
+        newPosition = index.entries.size();
+        index.entries.append({resource, std::move(text)});
+    } else {
+        newPosition = index.freePositions.takeLast();
+        index.entries[newPosition] = {resource, std::move(text)};
+    }
+    index.positions.insert(resource, newPosition);
+    addWords(index, newPosition);
+}
+
+void SearchIndex::removeEntry(BackendIndex &index, AbstractResource *resource)
+{
+    const auto position = index.positions.constFind(resource);
+    if (position == index.positions.constEnd()) {
+        return;
+    }
+
+    removeWords(index, *position);
+    index.entries[*position] = {};
+    index.freePositions.append(*position);
+    index.positions.erase(position);
+}
+
+void SearchIndex::addWords(BackendIndex &index, qsizetype position)
+{
+    forEachWord(index.entries[position].text, [&index, position](QStringView word) {
+        auto &positions = index.words[word.toString()];
+        if (positions.isEmpty() || positions.constLast() != position) {
+            positions.append(position);
+        }
+    });
+}
+
+void SearchIndex::removeWords(BackendIndex &index, qsizetype position)
+{
+    forEachWord(index.entries[position].text, [&index, position](QStringView word) {
+        auto it = index.words.find(word.toString());
+        if (it == index.words.end()) {
+            return;
+        }
+        it->removeOne(position);
+        if (it->isEmpty()) {
+            index.words.erase(it);
+        }
+    });
+}
+
+QVector<StreamResult> SearchIndex::search(AbstractResourcesBackend *backend, const QString &term) const
+{
+    const auto it = m_backends.constFind(backend);
+    if (it == m_backends.constEnd() || !it->complete || term.isEmpty()) {
+        return {};
+    }
+
+    const QString foldedTerm = term.toCaseFolded();
+
+    // Wherever the term is found, each of its words is within a word of the
+    // text, so the entries containing its longest word are the candidates.
+    // Going through the distinct words is far cheaper than through the texts.
+    QStringView longest;
+    forEachWord(foldedTerm, [&longest](QStringView word) {
+        if (word.size() > longest.size()) {
+            longest = word;
+        }
+    });
+
+    QVector<StreamResult> ret;
+    const auto addIfMatches = [&ret, &it, &foldedTerm](qsizetype position) {
+        const Entry &entry = it->entries[position];
+        // Same as AbstractResourcesBackend::matchesSearch(), the results are
+        // left unscored as well so that they're sorted by relevance alone
+        if (entry.resource && entry.text.contains(foldedTerm)) {
+            ret += StreamResult(entry.resource);
+        }
+    };
+
+    if (longest.isEmpty()) {
+        for (qsizetype position = 0, size = it->entries.size(); position < size; ++position) {
+            addIfMatches(position);
+        }
+        return ret;
+    }
+
+    QSet<qsizetype> candidates;
+    for (auto word = it->words.constBegin(), end = it->words.constEnd(); word != end; ++word) {
+        if (word.key().contains(longest)) {
+            for (const qsizetype position : *word) {
+                candidates.insert(position);
+            }
+        }
+    }
+    ret.reserve(candidates.size());
+    for (const qsizetype position : std::as_const(candidates)) {
+        addIfMatches(position);
+    }
+    return ret;
+}
+
+#include "moc_SearchIndex.cpp"
@@ -0,0 +1,93 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+
+#include "AbstractResourcesBackend.h"
+#include "discovercommon_export.h"
+
+/**
+ * \class SearchIndex  SearchIndex.h "SearchIndex.h"
+ *
+ * \brief Inverted index over the words in the searchTexts() of every resource
+ *
+ * Only backends that list their resources cheaply are indexed, see
+ * AbstractResourcesBackend::hasCheapEnumeration(). Once a backend has been
+ * listed with startIndexing(), text searches on it are answered with a lookup
+ * here instead of going through all of its resources again. They find what
+ * the backend's own search() would.
+ *
+ * The index follows the backend: changed resources are indexed again, removed
+ * ones dropped, and the backend is listed again in the background when its
+ * contents change, while the index keeps answering.
+ */
+class DISCOVERCOMMON_EXPORT SearchIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SearchIndex(QObject *parent = nullptr);
+    ~SearchIndex() override;
+
+    /// @returns whether searching with @p filters only depends on the resources' text
+    static bool canAnswer(const AbstractResourcesBackend::Filters &filters);
+
+    void addBackend(AbstractResourcesBackend *backend);
+    void removeBackend(AbstractResourcesBackend *backend);
+
+    /// @returns whether all the resources in @p backend are indexed
+    bool isIndexed(AbstractResourcesBackend *backend) const;
+
+    /**
+     * Lists all the resources in @p backend in the background, indexed() is
+     * emitted once they are all there. Does nothing if @p backend is already
+     * indexed or being indexed.
+     */
+    void startIndexing(AbstractResourcesBackend *backend);
+
+    /// @returns the resources in @p backend with one of their searchTexts() containing @p term
+    QVector<StreamResult> search(AbstractResourcesBackend *backend, const QString &term) const;
+
+Q_SIGNALS:
+    void indexed(AbstractResourcesBackend *backend);
+
+private:
+    struct Entry {
+        QPointer<AbstractResource> resource;
+        // The case-folded searchTexts(), one per line
+        QString text;
+    };
+
+    struct BackendIndex {
+        QVector<Entry> entries;
+        // Entries whose resource is gone, to be reused
+        QVector<qsizetype> freePositions;
+        QHash<AbstractResource *, qsizetype> positions;
+        // Where each word in the entries' texts appears
+        QHash<QString, QVector<qsizetype>> words;
+
+        QPointer<ResultsStream> listing;
+        // What the current listing found so far, the rest is gone once it's done
+        QSet<AbstractResource *> listed;
+        bool complete = false;
+        // Whether the contents changed while listing
+        bool stale = false;
+    };
+
+    void list(AbstractResourcesBackend *backend, BackendIndex &index);
+    void listingFinished(AbstractResourcesBackend *backend);
+    static void setEntry(AbstractResourcesBackend *backend, BackendIndex &index, AbstractResource *resource);
+    static void removeEntry(BackendIndex &index, AbstractResource *resource);
+    static void addWords(BackendIndex &index, qsizetype position);
+    static void removeWords(BackendIndex &index, qsizetype position);
+
+    QHash<AbstractResourcesBackend *, BackendIndex> m_backends;
+};
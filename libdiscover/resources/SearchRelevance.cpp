@@ -0,0 +1,113 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "SearchRelevance.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+#include <numeric>
+
+// The bit-parallel algorithm keeps one bit per query character in a machine word
+static constexpr qsizetype s_maxBitParallelLength = 64;
+
+SearchRelevance::SearchRelevance(const QString &query)
+    : m_query(query.toCaseFolded())
+{
+    if (m_query.size() > s_maxBitParallelLength) {
+        return;
+    }
+
+    for (qsizetype i = 0; i < m_query.size(); ++i) {
+        const char16_t c = m_query[i].unicode();
+        const quint64 bit = quint64(1) << i;
+        if (c < m_latin1Peq.size()) {
+            m_latin1Peq[c] |= bit;
+        } else {
+            m_otherPeq[c] |= bit;
+        }
+    }
+}
+
+quint64 SearchRelevance::peq(QChar c) const
+{
+    const char16_t u = c.unicode();
+    return u < m_latin1Peq.size() ? m_latin1Peq[u] : m_otherPeq.value(u);
+}
+
+int SearchRelevance::distance(QStringView foldedWord) const
+{
+    const qsizetype m = m_query.size();
+    if (m == 0) {
+        return foldedWord.size();
+    }
+    if (m > s_maxBitParallelLength) {
+        return longDistance(foldedWord);
+    }
+
+    // Myers' algorithm in Hyyrö's formulation: the vertical deltas of a column
+    // of the dynamic programming matrix are kept as bit vectors, where Pv
+    // (resp. Mv) has the bit set for the rows that increase (resp. decrease)
+    // by one from the previous row. Each character in the word moves one column.
+    const quint64 last = quint64(1) << (m - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = m;
+    for (QChar c : foldedWord) {
+        const quint64 eq = peq(c);
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & last) {
+            ++score;
+        } else if (mh & last) {
+            --score;
+        }
+        // The first row is the distance to an empty query, which grows by one on each column
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int SearchRelevance::longDistance(QStringView foldedWord) const
+{
+    const qsizetype m = m_query.size();
+    QVarLengthArray<int, 128> column(m + 1);
+    std::iota(column.begin(), column.end(), 0);
+    for (qsizetype i = 0; i < foldedWord.size(); ++i) {
+        int diagonal = column[0];
+        column[0] = i + 1;
+        for (qsizetype j = 0; j < m; ++j) {
+            const int above = column[j + 1];
+            column[j + 1] = std::min({column[j] + 1, above + 1, diagonal + (foldedWord[i] == m_query[j] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return column[m];
+}
+
+qreal SearchRelevance::nameScore(QStringView foldedName) const
+{
+    qreal reverseDistance = 0;
+    for (QStringView word : foldedName.split(QLatin1Char(' '))) {
+        const qreal maxLength = std::max(word.length(), m_query.length());
+        if (maxLength == 0) {
+            continue;
+        }
+        reverseDistance = std::max(reverseDistance, (maxLength - std::min(reverseDistance, qreal(distance(word)))) / maxLength * 10.0);
+    }
+
+    qreal exactMatch = 0.0;
+    if (foldedName == m_query) {
+        exactMatch = 10.0;
+    } else if (foldedName.contains(m_query)) {
+        exactMatch = 5.0;
+    }
+    return reverseDistance + exactMatch;
+}
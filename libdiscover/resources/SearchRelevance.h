@@ -0,0 +1,52 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <array>
+
+#include "discovercommon_export.h"
+
+/**
+ * \class SearchRelevance  SearchRelevance.h "SearchRelevance.h"
+ *
+ * \brief Fuzzy matching of resource names against a search query
+ *
+ * The query is case-folded and preprocessed once, so that scoring each name
+ * only costs a bit-parallel edit distance (Myers/Hyyrö) per word in the name.
+ * Names are expected to be case-folded already, see AbstractResource::foldedName().
+ */
+class DISCOVERCOMMON_EXPORT SearchRelevance
+{
+public:
+    explicit SearchRelevance(const QString &query = {});
+
+    QString query() const
+    {
+        return m_query;
+    }
+
+    /**
+     * @returns how close @p foldedName is to the query, between 0 and 20.
+     * Up to 10 come from the closest word in the name and 10 more from the
+     * name matching the query exactly, 5 if it just contains it.
+     */
+    qreal nameScore(QStringView foldedName) const;
+
+    /// @returns the Levenshtein distance between @p foldedWord and the query
+    int distance(QStringView foldedWord) const;
+
+private:
+    quint64 peq(QChar c) const;
+    int longDistance(QStringView foldedWord) const;
+
+    QString m_query;
+    // For every character in the query, the positions where it appears
+    std::array<quint64, 256> m_latin1Peq = {};
+    QHash<char16_t, quint64> m_otherPeq;
+};
@@ -10,15 +10,11 @@ StoredResultsStream::StoredResultsStream(const QSet<ResultsStream *> &streams)
     : AggregatedResultsStream(streams)
 {
     connect(this, &ResultsStream::resourcesFound, this, [this](const QVector<StreamResult> &resources) {
-        for (auto r : resources)
-            connect(r.resource, &QObject::destroyed, this, [this, r]() {
-                for (auto it = m_results.begin(); it != m_results.end(); ++it) {
-                    if (r.resource == it->resource)
-                        it = m_results.erase(it);
-                    else
-                        ++it;
-                }
+        for (const auto &result : resources) {
+            connect(result.resource, &QObject::destroyed, this, [this, resource = result.resource] {
+                resourceRemoved(resource);
             });
+        }
         m_results += resources;
     });
 
@@ -27,6 +23,14 @@ StoredResultsStream::StoredResultsStream(const QSet<ResultsStream *> &streams)
     });
 }
 
+void StoredResultsStream::resourceRemoved(AbstractResource *resource)
+{
+    AggregatedResultsStream::resourceRemoved(resource);
+    m_results.removeIf([resource](const StreamResult &result) {
+        return result.resource == resource;
+    });
+}
+
 QVector<StreamResult> StoredResultsStream::resources() const
 {
     return m_results;
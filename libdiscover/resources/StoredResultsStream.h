@@ -19,6 +19,9 @@ public:
 Q_SIGNALS:
     void finishedResources(const QVector<StreamResult> &resources);
 
+protected:
+    void resourceRemoved(AbstractResource *resource) override;
+
 private:
     QVector<StreamResult> m_results;
 };
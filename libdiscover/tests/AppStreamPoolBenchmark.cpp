@@ -0,0 +1,171 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include <appstream/AppStreamConcurrentPool.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+// Compares how many queries per second a pool can answer depending on its locking mode,
+// and checks that they answer the same either way
+class AppStreamPoolBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        QVERIFY(QDir(m_dir.path()).mkpath(u"catalog/xml"_s));
+
+        QFile catalog(m_dir.filePath(u"catalog/xml/benchmark.xml"_s));
+        QVERIFY(catalog.open(QIODevice::WriteOnly));
+        catalog.write("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<components version=\"1.0\" origin=\"benchmark\">\n");
+        const QStringList categories = {u"Utility"_s, u"Game"_s, u"Office"_s, u"Development"_s, u"Graphics"_s};
+        for (int i = 0; i < s_components; ++i) {
+            const QString component = u"<component type=\"desktop-application\"><id>org.kde.benchmark%1</id><name>Benchmark %1</name>"
+                                      "<summary>Synthetic application number %1</summary><pkgname>benchmark%1</pkgname>"
+                                      "<categories><category>%2</category></categories><keywords><keyword>word%3</keyword></keywords>"
+                                      "</component>\n"_s.arg(i)
+                                          .arg(categories[i % categories.size()])
+                                          .arg(i % 97);
+            catalog.write(component.toUtf8());
+        }
+        catalog.write("</components>\n");
+        catalog.close();
+
+        m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
+
+        auto pool = new AppStream::Pool;
+        pool->setLoadStdDataLocations(false);
+        pool->addExtraDataLocation(m_dir.filePath(u"catalog"_s), AppStream::Metadata::FormatStyleCatalog);
+        pool->overrideCacheLocations(m_dir.filePath(u"cache"_s), m_dir.filePath(u"cache"_s));
+        QVERIFY2(pool->load(), qPrintable(pool->lastError()));
+        m_pool.reset(pool, &m_threadPool);
+    }
+
+    void benchmarkQueries_data()
+    {
+        QTest::addColumn<AppStream::ConcurrentPool::LockingMode>("mode");
+
+        QTest::newRow("serialized") << AppStream::ConcurrentPool::LockingMode::Serialized;
+        QTest::newRow("concurrent reads") << AppStream::ConcurrentPool::LockingMode::ConcurrentReads;
+    }
+
+    void benchmarkQueries()
+    {
+        QFETCH(AppStream::ConcurrentPool::LockingMode, mode);
+        m_pool.setLockingMode(mode);
+
+        // What the home page and a search being typed issue at the same time
+        QBENCHMARK {
+            QList<QFuture<AppStream::ComponentBox>> futures;
+            for (int i = 0; i < 8; ++i) {
+                futures += m_pool.search(u"benchmark %1"_s.arg(i));
+                futures += m_pool.search(u"word%1"_s.arg(i));
+                futures += m_pool.componentsByCategories({u"Game"_s});
+                futures += m_pool.componentsByKind(AppStream::Component::KindDesktopApp);
+            }
+            for (const auto &future : std::as_const(futures)) {
+                QVERIFY(!future.result().isEmpty());
+            }
+        }
+    }
+
+    void testConcurrentReads()
+    {
+        // Reading from several threads at once finds the same as one query at a time
+        const auto query = [this] {
+            QList<QFuture<AppStream::ComponentBox>> futures;
+            for (int i = 0; i < 16; ++i) {
+                futures += m_pool.search(u"benchmark %1"_s.arg(i));
+                futures += m_pool.componentsByCategories({u"Game"_s});
+                futures += m_pool.componentsById(u"org.kde.benchmark%1"_s.arg(i));
+            }
+            QList<QStringList> ret;
+            for (const auto &future : std::as_const(futures)) {
+                QStringList ids;
+                const auto components = future.result();
+                for (const auto &component : components) {
+                    ids += component.id();
+                }
+                ids.sort();
+                ret += ids;
+            }
+            return ret;
+        };
+
+        m_pool.setLockingMode(AppStream::ConcurrentPool::LockingMode::Serialized);
+        const auto serialized = query();
+        m_pool.setLockingMode(AppStream::ConcurrentPool::LockingMode::ConcurrentReads);
+        QCOMPARE(query(), serialized);
+    }
+
+    void testSharedSearch()
+    {
+        m_pool.setLockingMode(AppStream::ConcurrentPool::LockingMode::Serialized);
+
+        // Keep every thread busy so that the searches below stay queued
+        QList<QFuture<AppStream::ComponentBox>> busy;
+        for (int i = 0; i < m_threadPool.maxThreadCount() * 2; ++i) {
+            busy += m_pool.components();
+        }
+
+        // Each keystroke has a stream of its own, the same term is only searched once
+        auto first = std::make_unique<QObject>();
+        auto second = std::make_unique<QObject>();
+        auto third = std::make_unique<QObject>();
+        auto shared = m_pool.search(u"benchmark"_s, first.get());
+        auto again = m_pool.search(u"benchmark"_s, second.get());
+        auto other = m_pool.search(u"benchmark 1"_s, third.get());
+
+        // It's only cancelled once nobody waits for it
+        first.reset();
+        QVERIFY(!shared.isCanceled());
+        second.reset();
+        QVERIFY(shared.isCanceled());
+        QVERIFY(again.isCanceled());
+        QVERIFY(!other.isCanceled());
+        QVERIFY(!other.result().isEmpty());
+
+        for (const auto &future : std::as_const(busy)) {
+            future.waitForFinished();
+        }
+    }
+
+    void testResetKeepsRunningQueries()
+    {
+        m_pool.setLockingMode(AppStream::ConcurrentPool::LockingMode::Serialized);
+        auto running = m_pool.components();
+
+        // The queries issued on the previous pool finish there
+        auto pool = new AppStream::Pool;
+        pool->setLoadStdDataLocations(false);
+        pool->addExtraDataLocation(m_dir.filePath(u"catalog"_s), AppStream::Metadata::FormatStyleCatalog);
+        pool->overrideCacheLocations(m_dir.filePath(u"cache"_s), m_dir.filePath(u"cache"_s));
+        QVERIFY2(pool->load(), qPrintable(pool->lastError()));
+        m_pool.reset(pool, &m_threadPool);
+        QCOMPARE(m_pool.get(), pool);
+        QVERIFY(running.result().size() == s_components);
+        QVERIFY(m_pool.components().result().size() == s_components);
+    }
+
+private:
+    static constexpr int s_components = 20000;
+    QTemporaryDir m_dir;
+    QThreadPool m_threadPool;
+    AppStream::ConcurrentPool m_pool;
+};
+
+QTEST_GUILESS_MAIN(AppStreamPoolBenchmark)
+
+#include "AppStreamPoolBenchmark.moc"
@@ -0,0 +1,172 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include <appstream/AppStreamConcurrentPool.h>
+
+#include <AppStreamQt/bundle.h>
+
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+// Compares having a pool per remote, like the Flatpak backend does by default,
+// with having all the remotes in one pool (DISCOVER_FLATPAK_UNIFIED_POOL)
+class AppStreamRemotesBenchmark : public QObject
+{
+    Q_OBJECT
+private:
+    static QString remoteName(int remote)
+    {
+        return u"remote%1"_s.arg(remote);
+    }
+
+    // What the memory use of the process is, in kB
+    static qint64 residentSetSize()
+    {
+        QFile status(u"/proc/self/status"_s);
+        if (!status.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        for (const QByteArray &line : status.readAll().split('\n')) {
+            if (line.startsWith("VmRSS:")) {
+                return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+            }
+        }
+        return -1;
+    }
+
+    AppStream::Pool *createPool(const QString &cacheName)
+    {
+        auto pool = new AppStream::Pool;
+        pool->setLoadStdDataLocations(false);
+        pool->overrideCacheLocations(m_dir.filePath(u"cache/"_s + cacheName), m_dir.filePath(u"cache/"_s + cacheName));
+        return pool;
+    }
+
+    void addRemote(AppStream::Pool *pool, int remote)
+    {
+        pool->addExtraDataLocation(m_dir.filePath(remoteName(remote)), AppStream::Metadata::FormatStyleCatalog);
+    }
+
+    // Mimics searching every source, as FlatpakBackend::searchSources does
+    static QList<AppStream::Component> search(const QList<AppStream::ConcurrentPool *> &pools, const QString &term)
+    {
+        QList<QFuture<AppStream::ComponentBox>> futures;
+        for (auto pool : pools) {
+            futures += pool->search(term);
+        }
+        QList<AppStream::Component> ret;
+        for (const auto &future : std::as_const(futures)) {
+            ret += future.result().toList();
+        }
+        return ret;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
+
+        // Remotes overlap like flathub and flathub-beta do: they share half of their applications
+        for (int remote = 0; remote < s_maxRemotes; ++remote) {
+            QVERIFY(QDir(m_dir.path()).mkpath(remoteName(remote) + u"/xml"_s));
+            QFile catalog(m_dir.filePath(remoteName(remote) + u"/xml/appstream.xml"_s));
+            QVERIFY(catalog.open(QIODevice::WriteOnly));
+            catalog.write(u"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<components version=\"0.8\" origin=\"%1\">\n"_s.arg(remoteName(remote)).toUtf8());
+            const int first = remote * s_components / 2;
+            for (int i = first; i < first + s_components; ++i) {
+                const QString component = u"<component type=\"desktop-application\"><id>org.kde.benchmark%1</id><name>Benchmark %1</name>"
+                                          "<summary>Synthetic application number %1</summary>"
+                                          "<bundle type=\"flatpak\">app/org.kde.benchmark%1/x86_64/%2</bundle>"
+                                          "<keywords><keyword>word%3</keyword></keywords></component>\n"_s.arg(i)
+                                              .arg(remoteName(remote))
+                                              .arg(i % 97);
+                catalog.write(component.toUtf8());
+            }
+            catalog.write("</components>\n");
+        }
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<int>("remotes");
+        QTest::addColumn<bool>("unified");
+
+        for (int remotes : {1, 3, 6}) {
+            QTest::addRow("%d remotes, pool per remote", remotes) << remotes << false;
+            QTest::addRow("%d remotes, unified pool", remotes) << remotes << true;
+        }
+    }
+
+    void benchmarkSearch()
+    {
+        QFETCH(int, remotes);
+        QFETCH(bool, unified);
+        const QString cacheName = QString::fromLatin1(QTest::currentDataTag()).replace(' '_L1, '-'_L1);
+
+        const qint64 rssBefore = residentSetSize();
+        std::vector<std::unique_ptr<AppStream::ConcurrentPool>> pools;
+        if (unified) {
+            auto pool = createPool(cacheName);
+            for (int remote = 0; remote < remotes; ++remote) {
+                addRemote(pool, remote);
+            }
+            QVERIFY2(pool->load(), qPrintable(pool->lastError()));
+            pools.push_back(std::make_unique<AppStream::ConcurrentPool>());
+            pools.back()->reset(pool, &m_threadPool);
+        } else {
+            for (int remote = 0; remote < remotes; ++remote) {
+                auto pool = createPool(cacheName + QString::number(remote));
+                addRemote(pool, remote);
+                QVERIFY2(pool->load(), qPrintable(pool->lastError()));
+                pools.push_back(std::make_unique<AppStream::ConcurrentPool>());
+                pools.back()->reset(pool, &m_threadPool);
+            }
+        }
+        const qint64 rssAfter = residentSetSize();
+
+        QList<AppStream::ConcurrentPool *> queried;
+        for (const auto &pool : pools) {
+            queried << pool.get();
+        }
+
+        QList<AppStream::Component> found;
+        QBENCHMARK {
+            found = search(queried, u"benchmark"_s);
+            for (int i = 0; i < 8; ++i) {
+                QVERIFY(!search(queried, u"word%1"_s.arg(i)).isEmpty());
+            }
+        }
+        qInfo() << "RSS grew by" << rssAfter - rssBefore << "kB loading" << remotes << "remotes";
+
+        // Either way, every remote's components are there, and they can be told apart by origin
+        QCOMPARE(found.size(), remotes * s_components);
+        QSet<QString> origins;
+        for (const auto &component : std::as_const(found)) {
+            origins.insert(component.origin());
+            QVERIFY(component.bundle(AppStream::Bundle::KindFlatpak).id().endsWith(component.origin()));
+        }
+        QCOMPARE(origins.size(), remotes);
+    }
+
+private:
+    static constexpr int s_maxRemotes = 6;
+    static constexpr int s_components = 5000;
+    QTemporaryDir m_dir;
+    QThreadPool m_threadPool;
+};
+
+QTEST_GUILESS_MAIN(AppStreamRemotesBenchmark)
+
+#include "AppStreamRemotesBenchmark.moc"
@@ -0,0 +1,49 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <DiscoverBackendsFactory.h>
+#include <resources/ResourcesModel.h>
+
+#include <QSignalSpy>
+#include <QStandardPaths>
+
+/**
+ * The dummy backend the benchmarks run against, with as many resources as
+ * DISCOVER_DUMMY_START_ELEMENTS asks for.
+ */
+class DummyBackendFixture
+{
+public:
+    explicit DummyBackendFixture(QObject *parent)
+    {
+        DiscoverBackendsFactory::setRequestedBackends({QStringLiteral("dummy-backend")});
+
+        QStandardPaths::setTestModeEnabled(true);
+        m_model = new ResourcesModel(QStringLiteral("dummy-backend"), parent);
+        m_backend = m_model->backends().value(0);
+    }
+
+    /// Waits for the backend to offer its resources, to be called from initTestCase()
+    bool waitForContents() const
+    {
+        if (!m_backend) {
+            return false;
+        }
+        QSignalSpy spy(m_backend, &AbstractResourcesBackend::contentsChanged);
+        return spy.wait();
+    }
+
+    AbstractResourcesBackend *backend() const
+    {
+        return m_backend;
+    }
+
+private:
+    ResourcesModel *m_model;
+    AbstractResourcesBackend *m_backend;
+};
@@ -0,0 +1,142 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include <appstream/OdrsRatings.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+class OdrsRatingsTest : public QObject
+{
+    Q_OBJECT
+private:
+    static QByteArray sampleDocument()
+    {
+        return R"({
+            "org.kde.Krita": {"star0": 1, "star1": 2, "star2": 0, "star3": 4, "star4": 10, "star5": 30, "total": 47},
+            "org.gnome.Evince.desktop": {"total": 3, "star5": 3, "extra": {"nested": [1, 2, {"a": null}]}},
+            "org.kde.kate": {"star3": 2, "star4": 1},
+            "not-an-app": [true, false],
+            "org.kde.empty": {}
+        })";
+    }
+
+private Q_SLOTS:
+    void testParse()
+    {
+        bool ok = false;
+        const auto ratings = OdrsRatings::fromJson(sampleDocument(), &ok);
+        QVERIFY(ok);
+        QCOMPARE(ratings.size(), qsizetype(4));
+
+        const Rating krita = ratings.rating(QStringLiteral("org.kde.krita"));
+        QCOMPARE(krita.packageName(), QStringLiteral("org.kde.krita"));
+        QCOMPARE(krita.ratingCount(), quint64(47));
+        QCOMPARE(krita.starCounts(), std::vector<int>({1, 2, 0, 4, 10, 30}));
+
+        // Lookups are case-insensitive
+        QCOMPARE(ratings.indexOf(QStringLiteral("org.kde.Krita")), ratings.indexOf(QStringLiteral("ORG.KDE.KRITA")));
+        QCOMPARE(ratings.rating(QStringLiteral("org.gnome.evince.desktop")).ratingCount(), quint64(3));
+        QVERIFY(ratings.contains(QStringLiteral("org.kde.kate")));
+        QVERIFY(ratings.contains(QStringLiteral("org.kde.empty")));
+        QVERIFY(!ratings.contains(QStringLiteral("not-an-app")));
+        QVERIFY(!ratings.contains(QString()));
+    }
+
+    void testSameAsJsonDocument()
+    {
+        const auto document = sampleDocument();
+        const auto ratings = OdrsRatings::fromJson(document);
+        const auto object = QJsonDocument::fromJson(document).object();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            if (!it->isObject()) {
+                continue;
+            }
+            const Rating rating = ratings.rating(it.key());
+            const auto app = it->toObject();
+            for (int i = 0; i < 6; ++i) {
+                QCOMPARE(rating.starCounts()[i], app.value(QStringLiteral("star%1").arg(i)).toInt());
+            }
+        }
+    }
+
+    void testBrokenDocument()
+    {
+        bool ok = true;
+        const auto ratings = OdrsRatings::fromJson(R"({"org.kde.krita": {"star5": 3}, "org.kde.kate": {"star)", &ok);
+        QVERIFY(!ok);
+        QCOMPARE(ratings.size(), qsizetype(1));
+        QVERIFY(ratings.contains(QStringLiteral("org.kde.krita")));
+    }
+
+    void testTop()
+    {
+        QByteArray document = "{";
+        for (int i = 0; i < 100; ++i) {
+            document += QStringLiteral(R"("app%1": {"star5": %2},)").arg(i, 3, 10, QLatin1Char('0')).arg(i % 50).toUtf8();
+        }
+        document.chop(1);
+        document += '}';
+
+        const auto top = OdrsRatings::fromJson(document).top(5);
+        QCOMPARE(top.size(), qsizetype(5));
+        // Most ratings first, ties go by AppStream id since that is how the table is sorted
+        QCOMPARE(top[0].packageName(), QStringLiteral("app049"));
+        QCOMPARE(top[1].packageName(), QStringLiteral("app099"));
+        QCOMPARE(top[2].packageName(), QStringLiteral("app048"));
+        QCOMPARE(top[3].packageName(), QStringLiteral("app098"));
+        QCOMPARE(top[4].packageName(), QStringLiteral("app047"));
+    }
+
+    void testCache()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath(QStringLiteral("ratings"));
+        const QString cachePath = path + QLatin1String(".bin");
+        {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(sampleDocument());
+        }
+
+        const auto parsed = OdrsRatings::load(path, cachePath);
+        QVERIFY(QFile::exists(cachePath));
+
+        // Once cached, the JSON file isn't read anymore: break it without changing its size or time
+        {
+            QFile file(path);
+            const auto modified = QFileInfo(file).lastModified();
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            file.write("x");
+            file.flush();
+            QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        }
+        const auto cached = OdrsRatings::load(path, cachePath);
+        QCOMPARE(cached.size(), parsed.size());
+        for (qsizetype i = 0; i < parsed.size(); ++i) {
+            QCOMPARE(cached.ratingAt(i).packageName(), parsed.ratingAt(i).packageName());
+            QCOMPARE(cached.ratingAt(i).starCounts(), parsed.ratingAt(i).starCounts());
+        }
+
+        // A newer document replaces the cache
+        {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(R"({"org.kde.kate": {"star1": 1}})");
+        }
+        const auto updated = OdrsRatings::load(path, cachePath);
+        QCOMPARE(updated.size(), qsizetype(1));
+        QCOMPARE(updated.rating(QStringLiteral("org.kde.kate")).ratingCount(), quint64(1));
+    }
+};
+
+QTEST_MAIN(OdrsRatingsTest)
+
+#include "OdrsRatingsTest.moc"
@@ -0,0 +1,95 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "DummyBackendFixture.h"
+
+#include <resources/ResourcesProxyModel.h>
+
+#include <QSignalSpy>
+#include <QTest>
+
+// Run with DISCOVER_DUMMY_START_ELEMENTS to pick how many resources the dummy backend offers
+class ResourcesProxyModelBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    ResourcesProxyModelBenchmark()
+        : m_fixture(this)
+        , m_backend(m_fixture.backend())
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_fixture.waitForContents());
+    }
+
+    void benchmarkInsertion_data()
+    {
+        QTest::addColumn<int>("batchSize");
+        QTest::addColumn<int>("sortRole");
+
+        QTest::newRow("name, one batch") << 0 << int(ResourcesProxyModel::NameRole);
+        QTest::newRow("name, batches of 100") << 100 << int(ResourcesProxyModel::NameRole);
+        QTest::newRow("name, batches of 5000") << 5000 << int(ResourcesProxyModel::NameRole);
+        QTest::newRow("size, batches of 100") << 100 << int(ResourcesProxyModel::SizeRole);
+        QTest::newRow("size, batches of 5000") << 5000 << int(ResourcesProxyModel::SizeRole);
+    }
+
+    void benchmarkInsertion()
+    {
+        QFETCH(int, batchSize);
+        QFETCH(int, sortRole);
+        m_backend->setProperty("searchBatchSize", batchSize);
+
+        ResourcesProxyModel pm;
+        pm.setBackendFilter(m_backend);
+        pm.setSortRole(ResourcesProxyModel::Roles(sortRole));
+        QSignalSpy spy(&pm, &ResourcesProxyModel::busyChanged);
+
+        QBENCHMARK_ONCE {
+            pm.componentComplete();
+            QVERIFY(pm.isBusy());
+            QVERIFY(spy.wait(600000));
+            QVERIFY(!pm.isBusy());
+        }
+
+        QCOMPARE(pm.rowCount(), m_backend->property("startElements").toInt() * 2);
+        for (int i = 1, count = pm.rowCount(); i < count; ++i) {
+            QVERIFY(!pm.orderedLessThan(pm.resourceAt(i), pm.resourceAt(i - 1)));
+        }
+    }
+
+    void benchmarkSortByRating()
+    {
+        m_backend->setProperty("searchBatchSize", 0);
+
+        ResourcesProxyModel pm;
+        pm.setBackendFilter(m_backend);
+        QSignalSpy spy(&pm, &ResourcesProxyModel::busyChanged);
+        pm.componentComplete();
+        QVERIFY(spy.wait(600000));
+
+        // Every resort reads the rating of every resource
+        QBENCHMARK {
+            pm.setSortRole(ResourcesProxyModel::SortableRatingRole);
+            pm.setSortRole(ResourcesProxyModel::RatingCountRole);
+        }
+
+        for (int i = 1, count = pm.rowCount(); i < count; ++i) {
+            QVERIFY(!pm.orderedLessThan(pm.resourceAt(i), pm.resourceAt(i - 1)));
+        }
+    }
+
+private:
+    DummyBackendFixture m_fixture;
+    AbstractResourcesBackend *const m_backend;
+};
+
+QTEST_MAIN(ResourcesProxyModelBenchmark)
+
+#include "ResourcesProxyModelBenchmark.moc"
@@ -0,0 +1,168 @@
+/*
+ *   SPDX-FileCopyrightText: 2026 KDE Contributors
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "DummyBackendFixture.h"
+
+#include <resources/SearchRelevance.h>
+#include <utils.h>
+
+#include <QSignalSpy>
+#include <QTest>
+
+// What ResourcesProxyModel used before SearchRelevance, kept to compare against
+static int referenceLevenshteinDistance(QStringView source, QStringView target)
+{
+    if (source.compare(target, Qt::CaseInsensitive) == 0) {
+        return 0;
+    }
+
+    const int sourceCount = source.size();
+    const int targetCount = target.size();
+
+    if (source.isEmpty()) {
+        return targetCount;
+    }
+
+    if (target.isEmpty()) {
+        return sourceCount;
+    }
+
+    QVector<int> column;
+    column.fill(0, targetCount + 1);
+    QVector<int> previousColumn;
+    previousColumn.reserve(targetCount + 1);
+    for (int i = 0; i < targetCount + 1; i++) {
+        previousColumn.append(i);
+    }
+
+    for (int i = 0; i < sourceCount; i++) {
+        column[0] = i + 1;
+        for (int j = 0; j < targetCount; j++) {
+            column[j + 1] =
+                std::min({1 + column.at(j), 1 + previousColumn.at(1 + j), previousColumn.at(j) + ((source.at(i).toUpper() == target.at(j).toUpper()) ? 0 : 1)});
+        }
+        column.swap(previousColumn);
+    }
+
+    return previousColumn.at(targetCount);
+}
+
+static qreal referenceNameScore(const QString &name, const QString &search)
+{
+    qreal reverseDistance = 0;
+    const auto words = QStringView(name).split(QLatin1Char(' '));
+    for (QStringView word : words) {
+        const qreal maxLength = std::max(word.length(), search.length());
+        reverseDistance = std::max(reverseDistance, (maxLength - std::min(reverseDistance, qreal(referenceLevenshteinDistance(word, search)))) / maxLength * 10.0);
+    }
+
+    qreal exactMatch = 0.0;
+    if (name.toUpper() == search.toUpper()) {
+        exactMatch = 10.0;
+    } else if (name.contains(search, Qt::CaseInsensitive)) {
+        exactMatch = 5.0;
+    }
+    return reverseDistance + exactMatch;
+}
+
+// Run with DISCOVER_DUMMY_START_ELEMENTS to pick how many names to score
+class SearchRelevanceBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    SearchRelevanceBenchmark()
+        : m_fixture(this)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_fixture.waitForContents());
+
+        auto stream = m_fixture.backend()->search({});
+        connect(stream, &ResultsStream::resourcesFound, this, [this](const QVector<StreamResult> &results) {
+            for (const auto &result : results) {
+                m_names += result.resource->name();
+            }
+        });
+        QSignalSpy destroyed(stream, &QObject::destroyed);
+        QVERIFY(destroyed.wait());
+        QVERIFY(!m_names.isEmpty());
+
+        m_foldedNames = kTransform<QStringList>(m_names, [](const QString &name) {
+            return name.toCaseFolded();
+        });
+    }
+
+    void testSameScores_data()
+    {
+        queries();
+    }
+
+    void testSameScores()
+    {
+        QFETCH(QString, query);
+        const SearchRelevance relevance(query);
+        for (int i = 0; i < m_names.size(); ++i) {
+            QCOMPARE(relevance.nameScore(m_foldedNames[i]), referenceNameScore(m_names[i], query));
+        }
+    }
+
+    void benchmarkReference_data()
+    {
+        queries();
+    }
+
+    void benchmarkReference()
+    {
+        QFETCH(QString, query);
+        qreal total = 0;
+        QBENCHMARK {
+            for (const QString &name : std::as_const(m_names)) {
+                total += referenceNameScore(name, query);
+            }
+        }
+        QVERIFY(total >= 0);
+    }
+
+    void benchmarkBitParallel_data()
+    {
+        queries();
+    }
+
+    void benchmarkBitParallel()
+    {
+        QFETCH(QString, query);
+        qreal total = 0;
+        QBENCHMARK {
+            const SearchRelevance relevance(query);
+            for (const QString &name : std::as_const(m_foldedNames)) {
+                total += relevance.nameScore(name);
+            }
+        }
+        QVERIFY(total >= 0);
+    }
+
+private:
+    static void queries()
+    {
+        QTest::addColumn<QString>("query");
+
+        QTest::newRow("exact word") << QStringLiteral("Dummy");
+        QTest::newRow("prefix") << QStringLiteral("add");
+        QTest::newRow("typo") << QStringLiteral("Dumy 12");
+        QTest::newRow("longer than 64 characters") << QStringLiteral("a query that is longer than what fits in the bit-parallel distance machine word");
+    }
+
+    DummyBackendFixture m_fixture;
+    QStringList m_names;
+    QStringList m_foldedNames;
+};
+
+QTEST_MAIN(SearchRelevanceBenchmark)
+
+#include "SearchRelevanceBenchmark.moc"